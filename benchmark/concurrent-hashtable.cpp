@@ -0,0 +1,121 @@
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ccl/test/benchmark.hpp>
+#include <ccl/hashtable.hpp>
+#include <ccl/concurrent/sharded-hashtable.hpp>
+
+using namespace ccl;
+using namespace ccl::concurrent;
+
+using sharded_map = sharded_hashtable<uint64_t, uint64_t>;
+
+/**
+ * A single hashtable behind a global lock, as a baseline.
+ */
+class locked_map {
+    mutable std::mutex lock;
+    hashtable<uint64_t, uint64_t> table;
+
+    public:
+        void reserve(const hashtable<uint64_t, uint64_t>::size_type new_capacity) {
+            table.reserve(new_capacity);
+        }
+
+        void insert(const uint64_t key, const uint64_t value) {
+            std::lock_guard guard{lock};
+
+            table.insert(key, value);
+        }
+
+        bool contains(const uint64_t key) const {
+            std::lock_guard guard{lock};
+
+            return table.contains(key);
+        }
+};
+
+static constexpr std::size_t key_count = 1u << 16;
+static constexpr std::size_t ops_per_thread = 1u << 16;
+
+// One operation in `insert_ratio` is an insertion, the rest are lookups.
+static constexpr std::size_t insert_ratio = 10;
+
+/**
+ * Run a mixed lookup/insert workload over a pre-populated map.
+ */
+template<typename Map>
+static void mixed_workload(benchmark_state &state, const unsigned thread_count) {
+    Map map;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<uint64_t>> thread_keys(thread_count);
+    std::size_t found = 0;
+    std::mutex found_lock;
+
+    map.reserve(key_count * 4);
+
+    for(uint64_t key = 0; key < key_count; ++key) {
+        map.insert(key, key);
+    }
+
+    for(unsigned t = 0; t < thread_count; ++t) {
+        std::mt19937_64 rng{t + 1};
+
+        thread_keys[t].resize(ops_per_thread);
+
+        for(auto &key : thread_keys[t]) {
+            key = rng() % (key_count * 2);
+        }
+    }
+
+    threads.reserve(thread_count);
+
+    state.measure([&] () {
+        for(unsigned t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&map, &found, &found_lock, &keys = thread_keys[t]] () {
+                std::size_t thread_found = 0;
+
+                for(std::size_t i = 0; i < ops_per_thread; ++i) {
+                    if(i % insert_ratio == 0) {
+                        map.insert(keys[i], i);
+                    } else {
+                        thread_found += map.contains(keys[i]);
+                    }
+                }
+
+                std::lock_guard guard{found_lock};
+                found += thread_found;
+            });
+        }
+
+        for(auto &thread : threads) {
+            thread.join();
+        }
+    });
+
+    const double total_ops = static_cast<double>(ops_per_thread) * thread_count;
+
+    do_not_optimize(found);
+    state.set_items_processed(total_ops);
+    state.add_counter("threads", thread_count);
+}
+
+int main(int argc, char **argv) {
+    benchmark_suite suite;
+
+    for(const unsigned thread_count : { 1u, 2u, 4u, 8u, 16u, 32u, 64u }) {
+        const std::string suffix = " (" + std::to_string(thread_count) + " threads)";
+
+        suite.add_benchmark("mixed 90% find, global lock" + suffix, [thread_count] (benchmark_state &state) {
+            mixed_workload<locked_map>(state, thread_count);
+        });
+
+        suite.add_benchmark("mixed 90% find, sharded" + suffix, [thread_count] (benchmark_state &state) {
+            mixed_workload<sharded_map>(state, thread_count);
+        });
+    }
+
+    return suite.main(argc, argv);
+}
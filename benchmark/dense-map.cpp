@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <ccl/test/benchmark.hpp>
+#include <ccl/dense-map.hpp>
+
+using namespace ccl;
+
+using map_type = dense_map<uint64_t, uint64_t>;
+
+static constexpr std::size_t key_count = 1u << 20;
+static constexpr std::size_t erase_key_count = 1u << 16;
+
+static std::vector<uint64_t> make_keys(const std::size_t n, const uint64_t seed) {
+    std::mt19937_64 rng{seed};
+    std::vector<uint64_t> keys(n);
+
+    for(auto &k : keys) {
+        k = rng();
+    }
+
+    return keys;
+}
+
+static void fill(map_type &map, const std::vector<uint64_t> &keys) {
+    for(const auto k : keys) {
+        map.insert(k, k);
+    }
+}
+
+int main(int argc, char **argv) {
+    benchmark_suite suite;
+    const auto keys = make_keys(key_count, 1);
+
+    suite.add_benchmark("iterate <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        map_type map;
+        uint64_t sum = 0;
+
+        fill(map, keys);
+
+        state.measure([&] () {
+            for(const auto item : map) {
+                sum += *item.first ^ *item.second;
+            }
+        });
+
+        do_not_optimize(sum);
+        state.set_items_processed(keys.size());
+    });
+
+    suite.add_benchmark("for_each <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        map_type map;
+        uint64_t sum = 0;
+
+        fill(map, keys);
+
+        state.measure([&] () {
+            map.for_each([&sum] (const uint64_t &key, const uint64_t &value) {
+                sum += key ^ value;
+            });
+        });
+
+        do_not_optimize(sum);
+        state.set_items_processed(keys.size());
+    });
+
+    suite.add_benchmark("iterate values <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        map_type map;
+        uint64_t sum = 0;
+
+        fill(map, keys);
+
+        state.measure([&] () {
+            for(auto it = map.begin_values(); it != map.end_values(); ++it) {
+                sum += *it;
+            }
+        });
+
+        do_not_optimize(sum);
+        state.set_items_processed(keys.size());
+    });
+
+    suite.add_benchmark("erase <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        std::vector<uint64_t> erased{keys.begin(), keys.begin() + erase_key_count};
+
+        std::shuffle(erased.begin(), erased.end(), std::mt19937_64{2});
+
+        state.measure([&] () {
+            map_type map;
+
+            for(const auto k : erased) {
+                map.insert(k, k);
+            }
+
+            for(const auto k : erased) {
+                map.erase(k);
+            }
+
+            do_not_optimize(map);
+        });
+
+        state.set_items_processed(erased.size());
+    });
+
+    return suite.main(argc, argv);
+}
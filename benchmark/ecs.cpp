@@ -0,0 +1,117 @@
+#include <vector>
+#include <ccl/test/benchmark.hpp>
+#include <ccl/ecs/registry.hpp>
+
+using namespace ccl;
+using namespace ccl::ecs;
+
+struct position { float x, y, z; };
+struct velocity { float x, y, z; };
+struct health { int value; };
+
+static constexpr std::size_t entity_count = 1u << 20;
+static constexpr std::size_t churn_entity_count = 1u << 16;
+
+/**
+ * Fill a registry, splitting the entities between two archetypes.
+ */
+static std::vector<entity_t> fill(registry<> &r) {
+    std::vector<entity_t> entities;
+
+    entities.reserve(entity_count);
+
+    for(std::size_t i = 0; i < entity_count; ++i) {
+        const entity_t e = r.create(position{0, 0, 0}, velocity{1, 2, 3});
+
+        if(i % 2) {
+            r.add<health>(e, 100);
+        }
+
+        entities.push_back(e);
+    }
+
+    return entities;
+}
+
+int main(int argc, char **argv) {
+    benchmark_suite suite;
+
+    suite.add_benchmark("get <position, velocity>", [] (benchmark_state &state) {
+        registry<> r;
+        const auto entities = fill(r);
+
+        state.measure([&] () {
+            for(const entity_t e : entities) {
+                position &p = r.get<position>(e);
+                const velocity &v = r.get<velocity>(e);
+
+                p.x += v.x;
+                p.y += v.y;
+                p.z += v.z;
+            }
+        });
+
+        do_not_optimize(r.get<position>(entities[0]));
+        state.set_items_processed(entity_count);
+    });
+
+    suite.add_benchmark("view for_each <position, velocity>", [] (benchmark_state &state) {
+        registry<> r;
+        const auto entities = fill(r);
+        const auto v = r.view<position, const velocity>();
+
+        state.measure([&] () {
+            v.for_each([] (position &p, const velocity &vel) {
+                p.x += vel.x;
+                p.y += vel.y;
+                p.z += vel.z;
+            });
+        });
+
+        do_not_optimize(r.get<position>(entities[0]));
+        state.set_items_processed(entity_count);
+    });
+
+    suite.add_benchmark("view for_each_chunk <position, velocity>", [] (benchmark_state &state) {
+        registry<> r;
+        const auto entities = fill(r);
+        const auto v = r.view<position, const velocity>();
+
+        state.measure([&] () {
+            v.for_each_chunk([] (const count_t count, const entity_t*, position * const p, const velocity * const vel) {
+                for(count_t i = 0; i < count; ++i) {
+                    p[i].x += vel[i].x;
+                    p[i].y += vel[i].y;
+                    p[i].z += vel[i].z;
+                }
+            });
+        });
+
+        do_not_optimize(r.get<position>(entities[0]));
+        state.set_items_processed(entity_count);
+    });
+
+    suite.add_benchmark("add/remove <health>", [] (benchmark_state &state) {
+        registry<> r;
+        std::vector<entity_t> entities;
+
+        for(std::size_t i = 0; i < churn_entity_count; ++i) {
+            entities.push_back(r.create(position{0, 0, 0}));
+        }
+
+        state.measure([&] () {
+            for(const entity_t e : entities) {
+                r.add<health>(e, 1);
+            }
+
+            for(const entity_t e : entities) {
+                r.remove<health>(e);
+            }
+        });
+
+        do_not_optimize(r);
+        state.set_items_processed(churn_entity_count * 2);
+    });
+
+    return suite.main(argc, argv);
+}
@@ -0,0 +1,131 @@
+#include <random>
+#include <span>
+#include <vector>
+#include <ccl/test/benchmark.hpp>
+#include <ccl/hashtable.hpp>
+#include <ccl/frozen-hashtable.hpp>
+
+using namespace ccl;
+
+using table_type = hashtable<uint64_t, uint64_t>;
+using frozen_type = frozen_hashtable<uint64_t, uint64_t>;
+
+static constexpr std::size_t key_count = 1u << 20;
+
+static std::vector<uint64_t> make_keys(const std::size_t n, const uint64_t seed) {
+    std::mt19937_64 rng{seed};
+    std::vector<uint64_t> keys(n);
+
+    for(auto &k : keys) {
+        k = rng();
+    }
+
+    return keys;
+}
+
+static void fill(table_type &table, const std::vector<uint64_t> &keys) {
+    for(const auto k : keys) {
+        table.insert(k, k);
+    }
+}
+
+/**
+ * Image of a table, in storage aligned as a memory mapping would be.
+ */
+static std::vector<uint64_t> make_image(const table_type &table) {
+    std::vector<uint64_t> words(frozen_type::image_size(table) / sizeof(uint64_t) + 1);
+
+    frozen_type::freeze(table, std::as_writable_bytes(std::span{words}));
+
+    return words;
+}
+
+int main(int argc, char **argv) {
+    benchmark_suite suite;
+    const auto keys = make_keys(key_count, 1);
+
+    suite.add_benchmark("load by insert <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        state.measure([&] () {
+            table_type table;
+
+            fill(table, keys);
+            do_not_optimize(table);
+        });
+
+        state.set_items_processed(keys.size());
+    });
+
+    suite.add_benchmark("load frozen <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        table_type table;
+
+        fill(table, keys);
+
+        const auto image = make_image(table);
+
+        state.measure([&] () {
+            frozen_type frozen{std::as_bytes(std::span{image})};
+
+            do_not_optimize(frozen);
+        });
+
+        state.set_items_processed(keys.size());
+        state.add_counter("bytes/item", static_cast<double>(frozen_type::image_size(table)) / keys.size());
+    });
+
+    suite.add_benchmark("find hit <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        table_type table;
+        std::size_t found = 0;
+
+        fill(table, keys);
+
+        state.measure([&] () {
+            for(const auto k : keys) {
+                found += table.contains(k);
+            }
+        });
+
+        do_not_optimize(found);
+        state.set_items_processed(keys.size());
+    });
+
+    suite.add_benchmark("find hit frozen <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        table_type table;
+        std::size_t found = 0;
+
+        fill(table, keys);
+
+        const auto image = make_image(table);
+        const frozen_type frozen{std::as_bytes(std::span{image})};
+
+        state.measure([&] () {
+            for(const auto k : keys) {
+                found += frozen.contains(k);
+            }
+        });
+
+        do_not_optimize(found);
+        state.set_items_processed(keys.size());
+    });
+
+    suite.add_benchmark("find miss frozen <uint64_t, uint64_t>", [&keys] (benchmark_state &state) {
+        table_type table;
+        const auto misses = make_keys(key_count, 2);
+        std::size_t found = 0;
+
+        fill(table, keys);
+
+        const auto image = make_image(table);
+        const frozen_type frozen{std::as_bytes(std::span{image})};
+
+        state.measure([&] () {
+            for(const auto k : misses) {
+                found += frozen.contains(k);
+            }
+        });
+
+        do_not_optimize(found);
+        state.set_items_processed(misses.size());
+    });
+
+    return suite.main(argc, argv);
+}
@@ -0,0 +1,719 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef __linux__
+    #include <fstream>
+    #include <unistd.h>
+#endif // __linux__
+#include <ccl/test/benchmark.hpp>
+#include <ccl/hashtable.hpp>
+#include <ccl/string/ansi-string.hpp>
+
+using namespace ccl;
+
+/**
+ * Hash function mixing all the key bits, so that random
+ * keys spread evenly across the table.
+ */
+struct mixing_hash {
+    constexpr hash_t operator()(const uint64_t key) const noexcept {
+        uint64_t x = key + 0x9E3779B97F4A7C15ULL;
+
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+        return x ^ (x >> 31);
+    }
+};
+
+/**
+ * Policy storing the key hashes beside the keys.
+ */
+struct stored_hash_policy : default_hashtable_policy {
+    static constexpr bool store_hashes = true;
+};
+
+/**
+ * Policy growing the table incrementally.
+ */
+struct incremental_policy : default_hashtable_policy {
+    static constexpr bool incremental_rehash = true;
+};
+
+/**
+ * Policy storing each key beside its value.
+ */
+struct interleaved_policy : default_hashtable_policy {
+    static constexpr bool interleave_items = true;
+};
+
+/**
+ * Policy clearing the table by starting a new generation.
+ */
+struct generational_policy : default_hashtable_policy {
+    static constexpr bool generational_clear = true;
+};
+
+/**
+ * Policy shrinking the table once erasing leaves it mostly empty.
+ */
+struct shrinking_policy : default_hashtable_policy {
+    static constexpr float shrink_load_factor = 0.125f;
+};
+
+using string_type = ansi_string<>;
+
+static constexpr hashtable<uint64_t, uint64_t>::size_type table_capacity = 1u << 18;
+static constexpr double load_factors[] = { 0.5, 0.75, 0.85 };
+
+static std::vector<uint64_t> make_keys(const std::size_t n, const uint64_t seed) {
+    std::mt19937_64 rng{seed};
+    std::vector<uint64_t> keys(n);
+
+    for(auto &k : keys) {
+        k = rng();
+    }
+
+    return keys;
+}
+
+template<typename Table, typename Key>
+static void fill(Table &table, const std::vector<Key> &keys) {
+    for(const auto &k : keys) {
+        table.insert(k, 1);
+    }
+}
+
+static std::vector<uint64_t> make_sequential_keys(const std::size_t n, const uint64_t first) {
+    std::vector<uint64_t> keys(n);
+
+    for(std::size_t i = 0; i < n; ++i) {
+        keys[i] = first + i;
+    }
+
+    return keys;
+}
+
+static std::vector<string_type> make_string_keys(const std::size_t n, const uint64_t seed) {
+    std::vector<string_type> keys;
+
+    keys.reserve(n);
+
+    for(const auto k : make_keys(n, seed)) {
+        const std::string s = std::to_string(k);
+
+        keys.emplace_back(s.data(), static_cast<string_type::size_type>(s.size()));
+    }
+
+    return keys;
+}
+
+/**
+ * Storage cost of a table, in bytes per slot.
+ */
+template<typename Table>
+static constexpr double slot_size() {
+    return static_cast<double>(
+        sizeof(typename Table::key_type)
+        + sizeof(typename Table::value_type)
+        + sizeof(internal::control_byte)
+        + (Table::store_hashes ? sizeof(hash_t) : 0)
+    );
+}
+
+/**
+ * Time doubling the capacity of a table holding string keys.
+ */
+template<typename Table>
+static void rehash_strings(benchmark_state &state, const std::size_t n) {
+    const auto keys = make_string_keys(n, 1);
+    Table table;
+
+    table.reserve(table_capacity);
+    fill(table, keys);
+
+    state.measure([&] () {
+        table.reserve(table.capacity() << 1);
+    });
+
+    state.set_items_processed(keys.size());
+    state.add_counter("bytes/slot", slot_size<Table>());
+    state.add_counter("bytes/item", slot_size<Table>() * table.capacity() / n);
+}
+
+/**
+ * Time moving all the items of a table holding string keys to another
+ * one, either copying them one at a time or merging the tables.
+ */
+template<typename Table>
+static void move_strings(benchmark_state &state, const std::size_t n, const bool merge) {
+    const auto keys = make_string_keys(n, 1);
+    Table source;
+    Table target;
+
+    fill(source, keys);
+
+    state.measure([&] () {
+        if(merge) {
+            target.merge(source);
+        } else {
+            for(const auto &k : keys) {
+                const auto it = source.find(k);
+
+                target.insert(*it->first, *it->second);
+                source.erase(it);
+            }
+        }
+    });
+
+    state.set_items_processed(n);
+}
+
+/**
+ * Time every insertion into an empty table, reporting the latency
+ * distribution.
+ */
+template<typename Table>
+static void insert_latency(benchmark_state &state, const std::size_t n) {
+    using clock = std::chrono::steady_clock;
+
+    const auto keys = make_keys(n, 1);
+    std::vector<double> latencies(n);
+    Table table;
+
+    state.measure([&] () {
+        for(std::size_t i = 0; i < n; ++i) {
+            const auto start = clock::now();
+
+            table.insert(keys[i], 1);
+
+            latencies[i] = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+        }
+    });
+
+    std::sort(latencies.begin(), latencies.end());
+
+    state.set_items_processed(n);
+    state.add_counter("p99_ns", latencies[n * 99 / 100]);
+    state.add_counter("p99.99_ns", latencies[n * 9999 / 10000]);
+    state.add_counter("max_ns", latencies.back());
+}
+
+/**
+ * Time chained lookups in a table much larger than the cache. Each value
+ * holds the index of the next key to find, so that every lookup waits
+ * for the previous one and the time per item is the lookup latency.
+ */
+template<typename Table>
+static void find_latency(benchmark_state &state, const std::size_t n) {
+    const auto keys = make_keys(n, 1);
+    std::vector<uint32_t> order(n);
+    Table table;
+    uint32_t next = 0;
+
+    for(std::size_t i = 0; i < n; ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    std::shuffle(order.begin(), order.end(), std::mt19937_64{3});
+    table.reserve(static_cast<typename Table::size_type>(n * 2));
+
+    // Chain all the keys in a single cycle, following the shuffled order.
+    for(std::size_t i = 0; i < n; ++i) {
+        table.insert(keys[order[i]], order[(i + 1) % n]);
+    }
+
+    state.measure([&] () {
+        for(std::size_t i = 0; i < n; ++i) {
+            next = *table.find(keys[next])->second;
+        }
+    });
+
+    do_not_optimize(next);
+    state.set_items_processed(n);
+}
+
+/**
+ * Time filling a table without reserving its capacity, reporting the
+ * memory held per item once filled.
+ */
+template<typename Table>
+static void memory_per_item(benchmark_state &state, const std::vector<uint64_t> &keys) {
+    Table table;
+
+    state.measure([&] () {
+        fill(table, keys);
+    });
+
+    state.set_items_processed(keys.size());
+    state.add_counter("bytes/item", slot_size<Table>() * (table.capacity() + Table::stash_size) / keys.size());
+    state.add_counter("chunk_size", table.get_chunk_size());
+
+#ifdef CCL_FEATURE_HASH_STATS
+    const hash_stats stats = table.get_stats();
+
+    state.add_counter("rehashes", stats.rehash_count);
+    state.add_counter("failed_chunks", stats.failed_chunk_count);
+    state.add_counter("mean_probe", stats.mean_probe_length());
+    state.add_counter("max_probe", stats.max_probe_length);
+#endif // CCL_FEATURE_HASH_STATS
+}
+
+/**
+ * Time iterating over a table holding few items relative to its
+ * capacity, reporting the time per slot.
+ */
+template<typename Table>
+static void iterate_sparse(benchmark_state &state, const typename Table::size_type capacity, const std::size_t n) {
+    constexpr std::size_t pass_count = 100;
+
+    Table table;
+    uint64_t sum = 0;
+
+    table.reserve(capacity);
+    fill(table, make_keys(n, 1));
+
+    state.measure([&] () {
+        for(std::size_t pass = 0; pass < pass_count; ++pass) {
+            for(const auto item : table) {
+                sum += *item.first;
+            }
+        }
+    });
+
+    do_not_optimize(sum);
+    state.set_items_processed(pass_count * table.capacity());
+}
+
+/**
+ * Time clearing a table and refilling it with a few items, as done with
+ * scratch tables, reporting the time per round.
+ */
+template<typename Table>
+static void clear_refill(benchmark_state &state, const typename Table::size_type capacity) {
+    constexpr std::size_t round_count = 1000;
+
+    const auto keys = make_keys(64, 1);
+    Table table;
+
+    table.reserve(capacity);
+
+    state.measure([&] () {
+        for(std::size_t round = 0; round < round_count; ++round) {
+            table.clear();
+            fill(table, keys);
+        }
+    });
+
+    do_not_optimize(table);
+    state.set_items_processed(round_count);
+}
+
+/**
+ * Resident memory of the process, in bytes, or 0 where unknown.
+ */
+static std::size_t resident_bytes() {
+#ifdef __linux__
+    std::ifstream statm{"/proc/self/statm"};
+    std::size_t total_pages = 0, resident_pages = 0;
+
+    statm >> total_pages >> resident_pages;
+
+    return resident_pages * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else // __linux__
+    return 0;
+#endif // __linux__
+}
+
+/**
+ * Time erasing most of the items of a table and shrinking it, reporting
+ * the table and process memory before and after.
+ *
+ * @param n The number of items to fill the table with.
+ * @param kept_count The number of items left after erasing.
+ */
+template<typename Table>
+static void shrink_after_erase(benchmark_state &state, const std::size_t n, const std::size_t kept_count) {
+    constexpr double mib = 1024 * 1024;
+
+    const auto keys = make_keys(n, 1);
+    Table table;
+
+    fill(table, keys);
+
+    const double table_before = slot_size<Table>() * table.capacity();
+    const double resident_before = static_cast<double>(resident_bytes());
+
+    state.measure([&] () {
+        for(std::size_t i = kept_count; i < n; ++i) {
+            table.erase(keys[i]);
+        }
+
+        table.shrink_to_fit();
+    });
+
+    state.set_items_processed(n - kept_count);
+    state.add_counter("table_mib_before", table_before / mib);
+    state.add_counter("table_mib_after", slot_size<Table>() * table.capacity() / mib);
+    state.add_counter("rss_mib_before", resident_before / mib);
+    state.add_counter("rss_mib_after", static_cast<double>(resident_bytes()) / mib);
+}
+
+/**
+ * Time building a table from a sized range of pairs, either at once or
+ * by inserting the pairs one by one.
+ */
+template<typename Table>
+static void build(benchmark_state &state, const std::size_t n, const bool bulk) {
+    const auto keys = make_keys(n, 1);
+    std::vector<pair<uint64_t, uint64_t>> items;
+
+    items.reserve(n);
+
+    for(const auto k : keys) {
+        items.emplace_back(k, k);
+    }
+
+    state.measure([&] () {
+        if(bulk) {
+            Table table{items};
+
+            do_not_optimize(table);
+        } else {
+            Table table;
+
+            for(const auto &item : items) {
+                table.insert(item.first, item.second);
+            }
+
+            do_not_optimize(table);
+        }
+    });
+
+    state.set_items_processed(n);
+}
+
+static std::vector<uint64_t> make_strided_keys(const std::size_t n, const unsigned stride_bits) {
+    std::vector<uint64_t> keys(n);
+
+    for(std::size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<uint64_t>(i) << stride_bits;
+    }
+
+    return keys;
+}
+
+static std::string load_name(const char * const prefix, const double load) {
+    return std::string{prefix} + " (" + std::to_string(static_cast<int>(load * 100)) + "% load)";
+}
+
+static std::string capacity_name(const char * const prefix, const std::size_t capacity) {
+    return std::string{prefix} + " (" + std::to_string(capacity) + " slots)";
+}
+
+int main(int argc, char **argv) {
+    benchmark_suite suite;
+
+    for(const double load : load_factors) {
+        const std::size_t n = static_cast<std::size_t>(table_capacity * load);
+
+        suite.add_benchmark(load_name("find hit <uint64_t, uint64_t>", load), [n] (benchmark_state &state) {
+            using table_type = hashtable<uint64_t, uint64_t, mixing_hash>;
+
+            const auto keys = make_keys(n, 1);
+            table_type table;
+            uint64_t sum = 0;
+
+            table.reserve(table_capacity);
+            fill(table, keys);
+
+            state.measure([&] () {
+                for(const auto k : keys) {
+                    sum += *table.find(k)->second;
+                }
+            });
+
+            do_not_optimize(sum);
+            state.set_items_processed(keys.size());
+            state.add_counter("load", static_cast<double>(n) / table.capacity());
+        });
+
+        suite.add_benchmark(load_name("find miss <uint64_t, uint64_t>", load), [n] (benchmark_state &state) {
+            using table_type = hashtable<uint64_t, uint64_t, mixing_hash>;
+
+            const auto keys = make_keys(n, 1);
+            const auto missing = make_keys(n, 2);
+            table_type table;
+            std::size_t found = 0;
+
+            table.reserve(table_capacity);
+            fill(table, keys);
+
+            state.measure([&] () {
+                for(const auto k : missing) {
+                    found += table.contains(k);
+                }
+            });
+
+            do_not_optimize(found);
+            state.set_items_processed(missing.size());
+            state.add_counter("load", static_cast<double>(n) / table.capacity());
+        });
+
+        // Sequential keys with the identity hash never overflow a chunk,
+        // so the table stays at exactly the requested load.
+        suite.add_benchmark(load_name("find hit sequential <uint64_t, uint64_t>", load), [n] (benchmark_state &state) {
+            using table_type = hashtable<uint64_t, uint64_t>;
+
+            const auto keys = make_sequential_keys(n, 0);
+            table_type table;
+            uint64_t sum = 0;
+
+            table.reserve(table_capacity);
+            fill(table, keys);
+
+            state.measure([&] () {
+                for(const auto k : keys) {
+                    sum += *table.find(k)->second;
+                }
+            });
+
+            do_not_optimize(sum);
+            state.set_items_processed(keys.size());
+            state.add_counter("load", static_cast<double>(n) / table.capacity());
+        });
+
+        suite.add_benchmark(load_name("find miss sequential <uint64_t, uint64_t>", load), [n] (benchmark_state &state) {
+            using table_type = hashtable<uint64_t, uint64_t>;
+
+            const auto keys = make_sequential_keys(n, 0);
+            const auto missing = make_sequential_keys(n, table_capacity);
+            table_type table;
+            std::size_t found = 0;
+
+            table.reserve(table_capacity);
+            fill(table, keys);
+
+            state.measure([&] () {
+                for(const auto k : missing) {
+                    found += table.contains(k);
+                }
+            });
+
+            do_not_optimize(found);
+            state.set_items_processed(missing.size());
+            state.add_counter("load", static_cast<double>(n) / table.capacity());
+        });
+
+        suite.add_benchmark(load_name("insert <uint64_t, uint64_t>", load), [n] (benchmark_state &state) {
+            using table_type = hashtable<uint64_t, uint64_t, mixing_hash>;
+
+            const auto keys = make_keys(n, 1);
+            table_type table;
+
+            table.reserve(table_capacity);
+
+            state.measure([&] () {
+                fill(table, keys);
+            });
+
+            state.set_items_processed(keys.size());
+            state.add_counter("load", static_cast<double>(n) / table.capacity());
+        });
+
+        suite.add_benchmark(load_name("find hit <ansi_string, uint64_t>", load), [n] (benchmark_state &state) {
+            using table_type = hashtable<string_type, uint64_t>;
+
+            const auto keys = make_string_keys(n, 1);
+            table_type table;
+            uint64_t sum = 0;
+
+            table.reserve(table_capacity);
+            fill(table, keys);
+
+            state.measure([&] () {
+                for(const auto &k : keys) {
+                    sum += *table.find(k)->second;
+                }
+            });
+
+            do_not_optimize(sum);
+            state.set_items_processed(keys.size());
+            state.add_counter("load", static_cast<double>(n) / table.capacity());
+        });
+
+        suite.add_benchmark(load_name("find hit stored hashes <ansi_string, uint64_t>", load), [n] (benchmark_state &state) {
+            using table_type = hashtable<string_type, uint64_t, hash<string_type>, allocator, stored_hash_policy>;
+
+            const auto keys = make_string_keys(n, 1);
+            table_type table;
+            uint64_t sum = 0;
+
+            table.reserve(table_capacity);
+            fill(table, keys);
+
+            state.measure([&] () {
+                for(const auto &k : keys) {
+                    sum += *table.find(k)->second;
+                }
+            });
+
+            do_not_optimize(sum);
+            state.set_items_processed(keys.size());
+            state.add_counter("load", static_cast<double>(n) / table.capacity());
+        });
+
+        suite.add_benchmark(load_name("rehash <ansi_string, uint64_t>", load), [n] (benchmark_state &state) {
+            rehash_strings<hashtable<string_type, uint64_t>>(state, n);
+        });
+
+        suite.add_benchmark(load_name("rehash stored hashes <ansi_string, uint64_t>", load), [n] (benchmark_state &state) {
+            rehash_strings<hashtable<string_type, uint64_t, hash<string_type>, allocator, stored_hash_policy>>(state, n);
+        });
+    }
+
+    // Tables much larger than the cache, so that most lookups miss it.
+    for(const bool batched : { false, true }) {
+        constexpr std::size_t large_capacity = 1u << 22;
+        constexpr std::size_t n = large_capacity / 4;
+
+        suite.add_benchmark(batched ? "find hit large batched <uint64_t, uint64_t>" : "find hit large <uint64_t, uint64_t>", [batched] (benchmark_state &state) {
+            using table_type = hashtable<uint64_t, uint64_t, mixing_hash>;
+
+            auto keys = make_keys(n, 1);
+            std::vector<table_type::iterator> found(n);
+            table_type table;
+            uint64_t sum = 0;
+
+            table.reserve(large_capacity);
+            fill(table, keys);
+            std::shuffle(keys.begin(), keys.end(), std::mt19937_64{3});
+
+            state.measure([&] () {
+                if(batched) {
+                    table.find_batch(keys, found.begin());
+                } else {
+                    for(std::size_t i = 0; i < n; ++i) {
+                        found[i] = table.find(keys[i]);
+                    }
+                }
+
+                for(const auto &it : found) {
+                    sum += *it->second;
+                }
+            });
+
+            do_not_optimize(sum);
+            state.set_items_processed(n);
+        });
+
+        suite.add_benchmark(batched ? "find miss large batched <uint64_t, uint64_t>" : "find miss large <uint64_t, uint64_t>", [batched] (benchmark_state &state) {
+            using table_type = hashtable<uint64_t, uint64_t, mixing_hash>;
+
+            const auto keys = make_keys(n, 1);
+            const auto missing = make_keys(n, 2);
+            std::unique_ptr<bool[]> present{new bool[n]};
+            table_type table;
+            std::size_t found = 0;
+
+            table.reserve(large_capacity);
+            fill(table, keys);
+
+            state.measure([&] () {
+                if(batched) {
+                    table.contains_batch(missing, present.get());
+                } else {
+                    for(std::size_t i = 0; i < n; ++i) {
+                        present[i] = table.contains(missing[i]);
+                    }
+                }
+
+                for(std::size_t i = 0; i < n; ++i) {
+                    found += present[i];
+                }
+            });
+
+            do_not_optimize(found);
+            state.set_items_processed(n);
+        });
+    }
+
+    static constexpr std::size_t latency_item_count = 1u << 21;
+
+    suite.add_benchmark("find latency <uint64_t, uint32_t>", [] (benchmark_state &state) {
+        find_latency<hashtable<uint64_t, uint32_t, mixing_hash>>(state, latency_item_count);
+    });
+
+    suite.add_benchmark("find latency interleaved <uint64_t, uint32_t>", [] (benchmark_state &state) {
+        find_latency<hashtable<uint64_t, uint32_t, mixing_hash, allocator, interleaved_policy>>(state, latency_item_count);
+    });
+
+    static constexpr std::size_t memory_item_count = 1u << 20;
+
+    suite.add_benchmark("memory random <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        memory_per_item<hashtable<uint64_t, uint64_t, mixing_hash>>(state, make_keys(memory_item_count, 1));
+    });
+
+    suite.add_benchmark("memory sequential identity hash <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        memory_per_item<hashtable<uint64_t, uint64_t>>(state, make_sequential_keys(memory_item_count, 0));
+    });
+
+    suite.add_benchmark("memory strided identity hash <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        memory_per_item<hashtable<uint64_t, uint64_t>>(state, make_strided_keys(memory_item_count, 20));
+    });
+
+    suite.add_benchmark("move find/insert/erase <ansi_string, uint64_t>", [] (benchmark_state &state) {
+        move_strings<hashtable<string_type, uint64_t>>(state, 1u << 17, false);
+    });
+
+    suite.add_benchmark("move merge <ansi_string, uint64_t>", [] (benchmark_state &state) {
+        move_strings<hashtable<string_type, uint64_t>>(state, 1u << 17, true);
+    });
+
+    suite.add_benchmark("move merge stored hashes <ansi_string, uint64_t>", [] (benchmark_state &state) {
+        move_strings<hashtable<string_type, uint64_t, hash<string_type>, allocator, stored_hash_policy>>(state, 1u << 17, true);
+    });
+
+    suite.add_benchmark("iterate sparse <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        iterate_sparse<hashtable<uint64_t, uint64_t, mixing_hash>>(state, 1u << 20, 1u << 10);
+    });
+
+    suite.add_benchmark("insert latency <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        insert_latency<hashtable<uint64_t, uint64_t, mixing_hash>>(state, 1u << 17);
+    });
+
+    suite.add_benchmark("insert latency incremental <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        insert_latency<hashtable<uint64_t, uint64_t, mixing_hash, allocator, incremental_policy>>(state, 1u << 17);
+    });
+
+    for(const hashtable<uint64_t, uint64_t>::size_type capacity : { 1u << 10, 1u << 14, 1u << 18, 1u << 22 }) {
+        suite.add_benchmark(capacity_name("clear refill <uint64_t, uint64_t>", capacity), [capacity] (benchmark_state &state) {
+            clear_refill<hashtable<uint64_t, uint64_t, mixing_hash>>(state, capacity);
+        });
+
+        suite.add_benchmark(capacity_name("clear refill generational <uint64_t, uint64_t>", capacity), [capacity] (benchmark_state &state) {
+            clear_refill<hashtable<uint64_t, uint64_t, mixing_hash, allocator, generational_policy>>(state, capacity);
+        });
+    }
+
+    suite.add_benchmark("build by insert <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        build<hashtable<uint64_t, uint64_t, mixing_hash>>(state, 1u << 22, false);
+    });
+
+    suite.add_benchmark("build from range <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        build<hashtable<uint64_t, uint64_t, mixing_hash>>(state, 1u << 22, true);
+    });
+
+    suite.add_benchmark("erase shrink_to_fit <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        shrink_after_erase<hashtable<uint64_t, uint64_t, mixing_hash>>(state, 1u << 22, 1u << 12);
+    });
+
+    suite.add_benchmark("erase shrinking <uint64_t, uint64_t>", [] (benchmark_state &state) {
+        shrink_after_erase<hashtable<uint64_t, uint64_t, mixing_hash, allocator, shrinking_policy>>(state, 1u << 22, 1u << 12);
+    });
+
+    return suite.main(argc, argv);
+}
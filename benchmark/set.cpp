@@ -0,0 +1,320 @@
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef __linux__
+    #include <fstream>
+    #include <unistd.h>
+#endif // __linux__
+#include <ccl/test/benchmark.hpp>
+#include <ccl/set.hpp>
+
+using namespace ccl;
+
+/**
+ * Hash function mixing all the key bits, so that random
+ * keys spread evenly across the set.
+ */
+struct mixing_hash {
+    constexpr hash_t operator()(const uint64_t key) const noexcept {
+        uint64_t x = key + 0x9E3779B97F4A7C15ULL;
+
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+        return x ^ (x >> 31);
+    }
+};
+
+/**
+ * Policy clearing the set by starting a new generation.
+ */
+struct generational_policy : default_set_policy {
+    static constexpr bool generational_clear = true;
+};
+
+/**
+ * Policy shrinking the set once erasing leaves it mostly empty.
+ */
+struct shrinking_policy : default_set_policy {
+    static constexpr float shrink_load_factor = 0.125f;
+};
+
+using set_type = set<uint64_t, mixing_hash>;
+
+// Sets much larger than the cache, so that most lookups miss it.
+static constexpr set_type::size_type set_capacity = 1u << 22;
+static constexpr std::size_t item_count = set_capacity / 4;
+
+static std::vector<uint64_t> make_keys(const std::size_t n, const uint64_t seed) {
+    std::mt19937_64 rng{seed};
+    std::vector<uint64_t> keys(n);
+
+    for(auto &k : keys) {
+        k = rng();
+    }
+
+    return keys;
+}
+
+static void contains(benchmark_state &state, const bool batched, const bool hit) {
+    const auto keys = make_keys(item_count, 1);
+    const auto lookups = hit ? keys : make_keys(item_count, 2);
+    std::unique_ptr<bool[]> present{new bool[item_count]};
+    set_type x;
+    std::size_t found = 0;
+
+    x.reserve(set_capacity);
+    x.insert_batch(keys);
+
+    state.measure([&] () {
+        if(batched) {
+            x.contains_batch(lookups, present.get());
+        } else {
+            for(std::size_t i = 0; i < item_count; ++i) {
+                present[i] = x.contains(lookups[i]);
+            }
+        }
+
+        for(std::size_t i = 0; i < item_count; ++i) {
+            found += present[i];
+        }
+    });
+
+    do_not_optimize(found);
+    state.set_items_processed(item_count);
+}
+
+/**
+ * Time iterating over a set holding few items relative to its
+ * capacity, reporting the time per slot.
+ */
+static void iterate_sparse(benchmark_state &state) {
+    constexpr std::size_t pass_count = 100;
+
+    set_type x;
+    uint64_t sum = 0;
+
+    x.reserve(set_capacity);
+    x.insert_batch(make_keys(set_capacity / 1024, 1));
+
+    state.measure([&] () {
+        for(std::size_t pass = 0; pass < pass_count; ++pass) {
+            for(const auto key : x) {
+                sum += key;
+            }
+        }
+    });
+
+    do_not_optimize(sum);
+    state.set_items_processed(pass_count * x.capacity());
+}
+
+/**
+ * Time clearing a set and refilling it with a few keys, as done with
+ * scratch sets, reporting the time per round.
+ */
+template<typename Set>
+static void clear_refill(benchmark_state &state, const typename Set::size_type capacity) {
+    constexpr std::size_t round_count = 1000;
+
+    const auto keys = make_keys(64, 1);
+    Set x;
+
+    x.reserve(capacity);
+
+    state.measure([&] () {
+        for(std::size_t round = 0; round < round_count; ++round) {
+            x.clear();
+            x.insert_batch(keys);
+        }
+    });
+
+    do_not_optimize(x);
+    state.set_items_processed(round_count);
+}
+
+/**
+ * Time building a set from a sized range of keys, either at once or by
+ * inserting the keys one by one.
+ */
+static void build(benchmark_state &state, const bool bulk) {
+    const auto keys = make_keys(item_count, 1);
+
+    state.measure([&] () {
+        if(bulk) {
+            set_type x{keys};
+
+            do_not_optimize(x);
+        } else {
+            set_type x;
+
+            for(const auto k : keys) {
+                x.insert(k);
+            }
+
+            do_not_optimize(x);
+        }
+    });
+
+    state.set_items_processed(item_count);
+}
+
+/**
+ * Time a set operation between a set and a four times smaller one,
+ * sharing half of its keys.
+ *
+ * @param operation A function invoked as `operation(a, b)`, returning
+ *  the resulting set.
+ */
+template<typename Operation>
+static void set_algebra(benchmark_state &state, Operation&& operation) {
+    const auto keys = make_keys(item_count, 1);
+    auto other_keys = make_keys(item_count / 8, 2);
+
+    other_keys.insert(other_keys.end(), keys.begin(), keys.begin() + item_count / 8);
+
+    const set_type a{keys};
+    const set_type b{other_keys};
+
+    state.measure([&] () {
+        set_type result = operation(a, b);
+
+        do_not_optimize(result);
+    });
+
+    state.set_items_processed(a.size() + b.size());
+}
+
+/**
+ * Resident memory of the process, in bytes, or 0 where unknown.
+ */
+static std::size_t resident_bytes() {
+#ifdef __linux__
+    std::ifstream statm{"/proc/self/statm"};
+    std::size_t total_pages = 0, resident_pages = 0;
+
+    statm >> total_pages >> resident_pages;
+
+    return resident_pages * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else // __linux__
+    return 0;
+#endif // __linux__
+}
+
+/**
+ * Time erasing most of the keys of a set and shrinking it, reporting
+ * the set capacity and process memory before and after.
+ */
+template<typename Set>
+static void shrink_after_erase(benchmark_state &state) {
+    constexpr double mib = 1024 * 1024;
+    constexpr std::size_t kept_count = 1u << 12;
+
+    const auto keys = make_keys(item_count, 1);
+    Set x;
+
+    x.insert_batch(keys);
+
+    const auto capacity_before = x.capacity();
+    const double resident_before = static_cast<double>(resident_bytes());
+
+    state.measure([&] () {
+        for(std::size_t i = kept_count; i < item_count; ++i) {
+            x.erase(keys[i]);
+        }
+
+        x.shrink_to_fit();
+    });
+
+    state.set_items_processed(item_count - kept_count);
+    state.add_counter("capacity_before", capacity_before);
+    state.add_counter("capacity_after", x.capacity());
+    state.add_counter("rss_mib_before", resident_before / mib);
+    state.add_counter("rss_mib_after", static_cast<double>(resident_bytes()) / mib);
+}
+
+int main(int argc, char **argv) {
+    benchmark_suite suite;
+
+    suite.add_benchmark("contains hit <uint64_t>", [] (benchmark_state &state) { contains(state, false, true); });
+    suite.add_benchmark("contains hit batched <uint64_t>", [] (benchmark_state &state) { contains(state, true, true); });
+    suite.add_benchmark("contains miss <uint64_t>", [] (benchmark_state &state) { contains(state, false, false); });
+    suite.add_benchmark("contains miss batched <uint64_t>", [] (benchmark_state &state) { contains(state, true, false); });
+    suite.add_benchmark("iterate sparse <uint64_t>", iterate_sparse);
+
+    for(const set_type::size_type capacity : { 1u << 10, 1u << 14, 1u << 18, 1u << 22 }) {
+        const std::string suffix = " (" + std::to_string(capacity) + " slots)";
+
+        suite.add_benchmark("clear refill <uint64_t>" + suffix, [capacity] (benchmark_state &state) {
+            clear_refill<set_type>(state, capacity);
+        });
+
+        suite.add_benchmark("clear refill generational <uint64_t>" + suffix, [capacity] (benchmark_state &state) {
+            clear_refill<set<uint64_t, mixing_hash, allocator, generational_policy>>(state, capacity);
+        });
+    }
+
+    suite.add_benchmark("build by insert <uint64_t>", [] (benchmark_state &state) { build(state, false); });
+    suite.add_benchmark("build from range <uint64_t>", [] (benchmark_state &state) { build(state, true); });
+    suite.add_benchmark("erase shrink_to_fit <uint64_t>", shrink_after_erase<set_type>);
+    suite.add_benchmark("erase shrinking <uint64_t>", shrink_after_erase<set<uint64_t, mixing_hash, allocator, shrinking_policy>>);
+
+    suite.add_benchmark("union naive <uint64_t>", [] (benchmark_state &state) {
+        set_algebra(state, [] (const set_type &a, const set_type &b) {
+            set_type result;
+
+            for(const auto k : a) {
+                result.insert(k);
+            }
+
+            for(const auto k : b) {
+                result.insert(k);
+            }
+
+            return result;
+        });
+    });
+
+    suite.add_benchmark("set_union <uint64_t>", [] (benchmark_state &state) {
+        set_algebra(state, [] (const set_type &a, const set_type &b) { return set_union(a, b); });
+    });
+
+    suite.add_benchmark("intersection naive <uint64_t>", [] (benchmark_state &state) {
+        set_algebra(state, [] (const set_type &a, const set_type &b) {
+            set_type result;
+
+            for(const auto k : b) {
+                if(a.contains(k)) {
+                    result.insert(k);
+                }
+            }
+
+            return result;
+        });
+    });
+
+    suite.add_benchmark("set_intersection <uint64_t>", [] (benchmark_state &state) {
+        set_algebra(state, [] (const set_type &a, const set_type &b) { return set_intersection(a, b); });
+    });
+
+    suite.add_benchmark("difference naive <uint64_t>", [] (benchmark_state &state) {
+        set_algebra(state, [] (const set_type &a, const set_type &b) {
+            set_type result;
+
+            for(const auto k : a) {
+                if(!b.contains(k)) {
+                    result.insert(k);
+                }
+            }
+
+            return result;
+        });
+    });
+
+    suite.add_benchmark("set_difference <uint64_t>", [] (benchmark_state &state) {
+        set_algebra(state, [] (const set_type &a, const set_type &b) { return set_difference(a, b); });
+    });
+
+    return suite.main(argc, argv);
+}
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include <ccl/test/benchmark.hpp>
+#include <ccl/sparse-set.hpp>
+#include <ccl/paged-sparse-set.hpp>
+
+using namespace ccl;
+
+using hashed_set_type = sparse_set<uint32_t>;
+using paged_set_type = paged_sparse_set<uint32_t>;
+
+static constexpr uint32_t id_count = 1u << 18;
+
+/**
+ * IDs `0` to `id_count`, shuffled.
+ */
+static std::vector<uint32_t> make_ids(const uint64_t seed) {
+    std::mt19937_64 rng{seed};
+    std::vector<uint32_t> ids(id_count);
+
+    for(uint32_t i = 0; i < id_count; ++i) {
+        ids[i] = i;
+    }
+
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    return ids;
+}
+
+template<typename Set>
+static void fill(Set &set, const std::vector<uint32_t> &ids) {
+    for(const auto id : ids) {
+        set.insert(id);
+    }
+}
+
+template<typename Set>
+static void add_benchmarks(benchmark_suite &suite, const std::string &name, const std::vector<uint32_t> &ids) {
+    suite.add_benchmark("insert " + name, [&ids] (benchmark_state &state) {
+        state.measure([&] () {
+            Set set;
+
+            fill(set, ids);
+            do_not_optimize(set);
+        });
+
+        state.set_items_processed(ids.size());
+    });
+
+    suite.add_benchmark("insert and remove_all " + name, [&ids] (benchmark_state &state) {
+        const auto removed = make_ids(2);
+
+        state.measure([&] () {
+            Set set;
+
+            set.reserve(id_count);
+            fill(set, ids);
+            set.remove_all(removed);
+            do_not_optimize(set);
+        });
+
+        state.set_items_processed(ids.size());
+    });
+
+    suite.add_benchmark("churn " + name, [&ids] (benchmark_state &state) {
+        Set set;
+
+        fill(set, ids);
+
+        state.measure([&] () {
+            // Remove and insert back every ID, in order
+            for(const auto id : ids) {
+                set.remove(id);
+                set.insert(id);
+            }
+        });
+
+        do_not_optimize(set);
+        state.set_items_processed(ids.size());
+    });
+
+    suite.add_benchmark("contains " + name, [&ids] (benchmark_state &state) {
+        Set set;
+        std::size_t found = 0;
+
+        for(std::size_t i = 0; i < ids.size(); i += 2) {
+            set.insert(ids[i]);
+        }
+
+        state.measure([&] () {
+            for(const auto id : ids) {
+                found += set.contains(id);
+            }
+        });
+
+        do_not_optimize(found);
+        state.set_items_processed(ids.size());
+    });
+
+    suite.add_benchmark("iterate " + name, [&ids] (benchmark_state &state) {
+        Set set;
+        uint64_t sum = 0;
+
+        fill(set, ids);
+
+        state.measure([&] () {
+            for(const auto id : set) {
+                sum += id;
+            }
+        });
+
+        do_not_optimize(sum);
+        state.set_items_processed(ids.size());
+    });
+}
+
+/**
+ * Add the benchmarks of the intersection of two sets sharing half of their
+ * IDs, either with `set_intersection()` or by looking up each ID of one set
+ * in the other.
+ *
+ * @param sorted Whether the IDs are inserted in ascending order.
+ */
+static void add_intersection_benchmarks(benchmark_suite &suite, const std::string &name, const std::vector<uint32_t> &ids, const bool sorted) {
+    std::vector<uint32_t> a_ids{ids.begin(), ids.begin() + id_count / 4 * 3};
+    std::vector<uint32_t> b_ids{ids.begin() + id_count / 4, ids.end()};
+
+    if(sorted) {
+        std::sort(a_ids.begin(), a_ids.end());
+        std::sort(b_ids.begin(), b_ids.end());
+    }
+
+    suite.add_benchmark("intersection naive " + name, [a_ids, b_ids] (benchmark_state &state) {
+        const hashed_set_type a{a_ids};
+        const hashed_set_type b{b_ids};
+
+        state.measure([&] () {
+            hashed_set_type result;
+
+            for(const auto id : b) {
+                if(a.contains(id)) {
+                    result.insert(id);
+                }
+            }
+
+            do_not_optimize(result);
+        });
+
+        state.set_items_processed(a.size() + b.size());
+    });
+
+    suite.add_benchmark("set_intersection " + name, [a_ids, b_ids] (benchmark_state &state) {
+        const hashed_set_type a{a_ids};
+        const hashed_set_type b{b_ids};
+
+        state.measure([&] () {
+            hashed_set_type result = set_intersection(a, b);
+
+            do_not_optimize(result);
+        });
+
+        state.set_items_processed(a.size() + b.size());
+    });
+}
+
+int main(int argc, char **argv) {
+    benchmark_suite suite;
+    const auto ids = make_ids(1);
+
+    add_benchmarks<hashed_set_type>(suite, "<uint32_t>", ids);
+    add_benchmarks<paged_set_type>(suite, "paged <uint32_t>", ids);
+    add_intersection_benchmarks(suite, "<uint32_t>", ids, false);
+    add_intersection_benchmarks(suite, "sorted <uint32_t>", ids, true);
+
+    return suite.main(argc, argv);
+}
@@ -0,0 +1,39 @@
+include_guard()
+
+#
+# SYNOPSIS
+#
+# add_ccl_benchmark(benchmark_name benchmark_source)
+#
+# Add a benchmark executable. Benchmarks are not registered as tests and
+# are meant to be run manually, preferably from an optimised build.
+#
+function(add_ccl_benchmark benchmark_name benchmark_file_path)
+    add_executable(${benchmark_name} ${benchmark_file_path})
+    target_link_libraries(${benchmark_name} ccl)
+    target_compile_definitions(${benchmark_name} PRIVATE CCL_ALLOCATOR_IMPL)
+
+    set_target_properties(
+        ${benchmark_name}
+        PROPERTIES
+            RUNTIME_OUTPUT_DIRECTORY benchmark
+    )
+
+    target_compile_options(
+        ${benchmark_name}
+        PRIVATE
+            -Wall -Wextra -pedantic -Werror
+    )
+endfunction()
+
+add_ccl_benchmark(benchmark_hashtable benchmark/hashtable.cpp)
+add_ccl_benchmark(benchmark_set benchmark/set.cpp)
+add_ccl_benchmark(benchmark_dense_map benchmark/dense-map.cpp)
+add_ccl_benchmark(benchmark_concurrent_hashtable benchmark/concurrent-hashtable.cpp)
+add_ccl_benchmark(benchmark_frozen_hashtable benchmark/frozen-hashtable.cpp)
+add_ccl_benchmark(benchmark_sparse_set benchmark/sparse-set.cpp)
+add_ccl_benchmark(benchmark_ecs benchmark/ecs.cpp)
+
+find_package(Threads REQUIRED)
+
+target_link_libraries(benchmark_concurrent_hashtable Threads::Threads)
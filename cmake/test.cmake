@@ -188,6 +188,21 @@ add_ccl_test(
     COVERAGE include/ccl/set.hpp
 )
 
+add_ccl_test(
+    TEST test_frozen_hashtable test/frozen-hashtable.cpp
+    COVERAGE include/ccl/frozen-hashtable.hpp
+)
+
+add_ccl_test(
+    TEST test_static_map test/static-map.cpp
+    COVERAGE include/ccl/static-map.hpp
+)
+
+add_ccl_test(
+    TEST test_hash_stats test/hash-stats.cpp
+    COVERAGE include/ccl/hash-stats.hpp
+)
+
 add_ccl_test(
     TEST test_local_allocator test/memory/local-allocator.cpp
     COVERAGE include/ccl/memory/local-allocator.hpp
@@ -203,6 +218,26 @@ add_ccl_test(
     COVERAGE include/ccl/sparse-set.hpp
 )
 
+add_ccl_test(
+    TEST test_paged_sparse_set test/paged-sparse-set.cpp
+    COVERAGE include/ccl/paged-sparse-set.hpp
+)
+
+add_ccl_test(
+    TEST test_ecs_archetype test/ecs/archetype.cpp
+    COVERAGE include/ccl/ecs/archetype.hpp
+)
+
+add_ccl_test(
+    TEST test_ecs_view test/ecs/view.cpp
+    COVERAGE include/ccl/ecs/view.hpp
+)
+
+add_ccl_test(
+    TEST test_ecs_registry test/ecs/registry.cpp
+    COVERAGE include/ccl/ecs/registry.hpp
+)
+
 add_ccl_test(
     TEST test_hash test/hash.cpp
     COVERAGE include/ccl/hash.hpp
@@ -270,6 +305,16 @@ add_ccl_test(
     COVERAGE include/ccl/internal/optional-allocator.hpp
 )
 
+add_ccl_test(
+    TEST test_internal_control_group test/internal/control-group.cpp
+    COVERAGE include/ccl/internal/control-group.hpp
+)
+
+add_ccl_test(
+    TEST test_internal_sorted_merge test/internal/sorted-merge.cpp
+    COVERAGE include/ccl/internal/sorted-merge.hpp
+)
+
 add_ccl_test(
     TEST test_pointer_shared test/pointer/shared.cpp
     COVERAGE include/ccl/pointer/shared.hpp
@@ -311,11 +356,21 @@ add_ccl_test(
     COVERAGE include/ccl/concurrent/channel.hpp
 )
 
+add_ccl_test(
+    TEST test_concurrent_sharded_hashtable test/concurrent/sharded-hashtable.cpp
+    COVERAGE include/ccl/concurrent/sharded-hashtable.hpp
+)
+
 add_ccl_test(
     TEST test_algorithm_search test/algorithm/search.cpp
     COVERAGE include/algorithm/search.hpp
 )
 
+find_package(Threads REQUIRED)
+
+target_link_libraries(test_hash_stats Threads::Threads)
+target_link_libraries(test_concurrent_sharded_hashtable Threads::Threads)
+
 add_custom_command(
     OUTPUT ${CCL_COVERAGE_DATA_FILE}
     COMMAND llvm-profdata merge ${CCL_COVERAGE_RAW_DATA_FILES} -o ${CCL_COVERAGE_DATA_FILE}
@@ -20,6 +20,7 @@ class LibcclConan(ConanFile):
     exports_sources = (
         "include/*",
         "test/*",
+        "benchmark/*",
         "cmake/*",
         "CMakeLists.txt",
         "version.cmake",
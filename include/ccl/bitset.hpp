@@ -6,12 +6,97 @@
 #ifndef CCL_BITSET_HPP
 #define CCL_BITSET_HPP
 
+#include <bit>
 #include <ccl/api.hpp>
 #include <ccl/debug.hpp>
 #include <ccl/vector.hpp>
 #include <ccl/memory/allocator.hpp>
 
 namespace ccl {
+    namespace internal {
+        /**
+         * Find the first set bit at or after a given index, in a sequence
+         * of 64-bit clusters. Whole clusters are scanned at once.
+         *
+         * @tparam Clusters A pointer to the clusters, or any type yielding
+         *  them by index.
+         *
+         * @param clusters The clusters.
+         * @param size_bits The number of bits in the sequence.
+         * @param index The index of the first bit to test.
+         *
+         * @return The index of the bit, or `~0` if no bit is found.
+         */
+        template<typename Clusters>
+        constexpr std::size_t find_set_bit(
+            const Clusters clusters,
+            const std::size_t size_bits,
+            const std::size_t index
+        ) noexcept {
+            constexpr std::size_t not_found = ~static_cast<std::size_t>(0);
+
+            if(index >= size_bits) {
+                return not_found;
+            }
+
+            const std::size_t last_cluster_index = (size_bits - 1) >> 6;
+            std::size_t cluster_index = index >> 6;
+            uint64_t cluster = clusters[cluster_index] & (~static_cast<uint64_t>(0) << (index & 63));
+
+            while(!cluster) {
+                if(cluster_index == last_cluster_index) {
+                    return not_found;
+                }
+
+                cluster = clusters[++cluster_index];
+            }
+
+            const std::size_t result = (cluster_index << 6) + std::countr_zero(cluster);
+
+            return result < size_bits ? result : not_found;
+        }
+
+        /**
+         * Find the last set bit before a given index, in a sequence of
+         * 64-bit clusters. Whole clusters are scanned at once.
+         *
+         * @tparam Clusters A pointer to the clusters, or any type yielding
+         *  them by index.
+         *
+         * @param clusters The clusters.
+         * @param size_bits The number of bits in the sequence.
+         * @param index The index following the last bit to test.
+         *
+         * @return The index of the bit, or `~0` if no bit is found.
+         */
+        template<typename Clusters>
+        constexpr std::size_t find_prev_set_bit(
+            const Clusters clusters,
+            const std::size_t size_bits,
+            const std::size_t index
+        ) noexcept {
+            constexpr std::size_t not_found = ~static_cast<std::size_t>(0);
+
+            if(index == 0 || size_bits == 0) {
+                return not_found;
+            }
+
+            const std::size_t last = (index < size_bits ? index : size_bits) - 1;
+            std::size_t cluster_index = last >> 6;
+            uint64_t cluster = clusters[cluster_index] & (~static_cast<uint64_t>(0) >> (63 - (last & 63)));
+
+            while(!cluster) {
+                if(cluster_index == 0) {
+                    return not_found;
+                }
+
+                cluster = clusters[--cluster_index];
+            }
+
+            return (cluster_index << 6) + 63 - std::countl_zero(cluster);
+        }
+    }
+
     /**
      * A variable sequence of bits.
      */
@@ -64,6 +149,11 @@ namespace ccl {
             static constexpr std::size_t bits_per_cluster = sizeof(cluster_type) * 8;
             static constexpr std::size_t cluster_size_bitcount = bitcount(bits_per_cluster) - 1;
 
+            /**
+             * Bit index returned when no bit is found.
+             */
+            static constexpr size_type npos = ~static_cast<size_type>(0);
+
             explicit constexpr bitset(
                 const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
                 allocator_type * const allocator = nullptr
@@ -143,10 +233,7 @@ namespace ccl {
              * @param The new suggested capacity, in bits.
              */
             constexpr void reserve(const size_type new_capacity) {
-                #pragma clang diagnostic push
-                #pragma clang diagnostic ignored "-Wshift-count-overflow"
-                clusters.reserve(new_capacity >> cluster_size_bitcount);
-                #pragma clang diagnostic pop
+                clusters.reserve(cluster_count(new_capacity));
             }
 
             /**
@@ -156,10 +243,7 @@ namespace ccl {
              * @param new_size The new size of the collection, in bits.
              */
             constexpr void resize(const size_type new_size) {
-                #pragma clang diagnostic push
-                #pragma clang diagnostic ignored "-Wshift-count-overflow"
-                clusters.resize(new_size >> cluster_size_bitcount);
-                #pragma clang diagnostic pop
+                clusters.resize(cluster_count(new_size));
 
                 _size_bits = new_size;
             }
@@ -310,6 +394,40 @@ namespace ccl {
                 target_cluster = choose(cluster_w_enabled, cluster_w_disabled, value);
             }
 
+            /**
+             * Find the first set bit.
+             *
+             * @return The index of the bit, or `npos` if no bit is set.
+             */
+            constexpr size_type find_first_set() const noexcept {
+                return internal::find_set_bit(clusters.data(), _size_bits, 0);
+            }
+
+            /**
+             * Find the first set bit following a given one. Whole clusters
+             * are scanned at once.
+             *
+             * @param index The index of the bit to start after.
+             *
+             * @return The index of the bit, or `npos` if no following bit is set.
+             */
+            constexpr size_type find_next_set(const size_type index) const noexcept {
+                return index < _size_bits ? internal::find_set_bit(clusters.data(), _size_bits, index + 1) : npos;
+            }
+
+            /**
+             * Find the last set bit preceding a given one. Whole clusters
+             * are scanned at once.
+             *
+             * @param index The index of the bit to start before. May be
+             *  `size_bits()`, to find the last set bit.
+             *
+             * @return The index of the bit, or `npos` if no preceding bit is set.
+             */
+            constexpr size_type find_prev_set(const size_type index) const noexcept {
+                return internal::find_prev_set_bit(clusters.data(), _size_bits, index);
+            }
+
             /**
              * Get the underlying data structure where the bit clusters
              * are stored.
@@ -361,6 +479,13 @@ namespace ccl {
                     };
                 }
 
+                /**
+                 * Number of clusters holding a number of bits.
+                 */
+                static constexpr size_type cluster_count(const size_type bit_count) noexcept {
+                    return (bit_count + bits_per_cluster - 1) >> cluster_size_bitcount;
+                }
+
                 constexpr allocator_type* get_allocator() const noexcept { return clusters.get_allocator(); }
                 constexpr allocation_flags get_allocation_flags() const noexcept { return clusters.get_allocation_flags(); }
     };
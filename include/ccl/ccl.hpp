@@ -15,11 +15,14 @@
 #include <ccl/definitions.hpp>
 #include <ccl/exceptions.hpp>
 #include <ccl/features.hpp>
+#include <ccl/frozen-hashtable.hpp>
 #include <ccl/hash.hpp>
+#include <ccl/hash-stats.hpp>
 #include <ccl/hashtable.hpp>
 #include <ccl/macros.hpp>
 #include <ccl/maybe.hpp>
 #include <ccl/set.hpp>
+#include <ccl/static-map.hpp>
 #include <ccl/test/test.hpp>
 #include <ccl/util.hpp>
 #include <ccl/vector.hpp>
@@ -30,12 +33,15 @@
 #include <ccl/paged-vector.hpp>
 #include <ccl/deque.hpp>
 #include <ccl/sparse-set.hpp>
+#include <ccl/paged-sparse-set.hpp>
 #include <ccl/type-traits.hpp>
 #include <ccl/either.hpp>
 
 #include <ccl/memory/memory.hpp>
 #include <ccl/pointer/pointer.hpp>
 
+#include <ccl/ecs/ecs.hpp>
+
 #include <ccl/i18n/language.hpp>
 
 #ifdef CCL_FEATURE_STL_COMPAT
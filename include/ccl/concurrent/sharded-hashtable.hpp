@@ -0,0 +1,294 @@
+/**
+ * @file
+ *
+ * Hash table safe for concurrent use by multiple threads.
+ */
+#ifndef CCL_CONCURRENT_SHARDED_HASHTABLE_HPP
+#define CCL_CONCURRENT_SHARDED_HASHTABLE_HPP
+
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <ccl/api.hpp>
+#include <ccl/concepts.hpp>
+#include <ccl/definitions.hpp>
+#include <ccl/hash.hpp>
+#include <ccl/hashtable.hpp>
+#include <ccl/util.hpp>
+#include <ccl/memory/allocator.hpp>
+
+namespace ccl::concurrent {
+    /**
+     * A hash table split into independently locked shards.
+     *
+     * Each key belongs to exactly one shard, selected by the most significant
+     * bits of its mixed hash. Every shard is a regular hashtable guarded by a
+     * reader/writer lock: lookups on a shard run in parallel, while insertions
+     * and removals only block the operations on the same shard.
+     *
+     * Values are returned by copy, as references would outlive the lock
+     * guarding them. Use `visit()` to access a value in place.
+     *
+     * @tparam K The key type.
+     * @tparam V The value type.
+     * @tparam HashFunction The hash function type.
+     * @tparam Allocator The allocator type.
+     */
+    template<
+        typename K,
+        typename V,
+        typed_hash_function<K> HashFunction = hash<K>,
+        typename Allocator = allocator
+    > class sharded_hashtable {
+        public:
+            using key_type = K;
+            using value_type = V;
+            using hash_function_type = HashFunction;
+            using allocator_type = Allocator;
+            using size_type = count_t;
+            using table_type = hashtable<K, V, HashFunction, Allocator>;
+            using const_key_reference = const K&;
+            using const_value_reference = const V&;
+
+            static constexpr size_type shard_count = CCL_SHARDED_HASHTABLE_SHARD_COUNT;
+
+            static_assert(is_power_2(shard_count), "Shard count must be a power of 2.");
+
+        private:
+            static constexpr size_type shard_bits = bitcount(shard_count) - 1;
+
+            /**
+             * A single shard. Aligned to avoid false sharing between the
+             * locks of neighbouring shards.
+             */
+            struct alignas(CCL_CACHE_LINE_SIZE) shard {
+                mutable std::shared_mutex lock;
+                table_type table;
+            };
+
+            shard shards[shard_count];
+
+        public:
+            /**
+             * Initialise an empty table.
+             *
+             * @param alloc_flags The allocation flags used by all the shards.
+             * @param allocator The allocator used by all the shards. Must be thread safe.
+             */
+            explicit sharded_hashtable(
+                const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
+                allocator_type * const allocator = nullptr
+            ) {
+                for(shard &s : shards) {
+                    s.table = table_type{alloc_flags, allocator};
+                }
+            }
+
+            sharded_hashtable(const sharded_hashtable &other) = delete;
+            sharded_hashtable(sharded_hashtable &&other) = delete;
+
+            sharded_hashtable& operator =(const sharded_hashtable &other) = delete;
+            sharded_hashtable& operator =(sharded_hashtable &&other) = delete;
+
+            /**
+             * Reserve capacity for a number of keys, spread evenly across
+             * the shards.
+             *
+             * @param new_capacity The new minimum total capacity.
+             */
+            void reserve(const size_type new_capacity) {
+                const size_type shard_capacity = new_capacity / shard_count + (new_capacity % shard_count > 0);
+
+                for(shard &s : shards) {
+                    std::unique_lock lock{s.lock};
+
+                    s.table.reserve(shard_capacity);
+                }
+            }
+
+            /**
+             * Insert a key-value pair, unless the key is already present.
+             *
+             * @param key The key.
+             * @param value The value.
+             */
+            void insert(const_key_reference key, const_value_reference value) {
+                const hash_t key_hash = hash(key);
+                shard &s = shards[shard_index_hashed(key_hash)];
+                std::unique_lock lock{s.lock};
+
+                s.table.emplace_hashed(key, key_hash, value);
+            }
+
+            /**
+             * Construct the value of a key in place, unless the key is already present.
+             *
+             * @param key The key.
+             * @param args The value constructor arguments.
+             */
+            template<typename ...Args>
+            void emplace(const_key_reference key, Args&& ...args) {
+                const hash_t key_hash = hash(key);
+                shard &s = shards[shard_index_hashed(key_hash)];
+                std::unique_lock lock{s.lock};
+
+                s.table.emplace_hashed(key, key_hash, std::forward<Args>(args)...);
+            }
+
+            /**
+             * Remove a key, if present.
+             *
+             * @param key The key.
+             */
+            void erase(const_key_reference key) {
+                const hash_t key_hash = hash(key);
+                shard &s = shards[shard_index_hashed(key_hash)];
+                std::unique_lock lock{s.lock};
+
+                s.table.erase_hashed(key, key_hash);
+            }
+
+            /**
+             * Remove all the keys. Shards are cleared one at a time, so
+             * concurrent insertions may survive the operation.
+             */
+            void clear() {
+                for(shard &s : shards) {
+                    std::unique_lock lock{s.lock};
+
+                    s.table.clear();
+                }
+            }
+
+            CCLNODISCARD bool contains(const_key_reference key) const {
+                const hash_t key_hash = hash(key);
+                const shard &s = shards[shard_index_hashed(key_hash)];
+                std::shared_lock lock{s.lock};
+
+                return s.table.contains_hashed(key, key_hash);
+            }
+
+            /**
+             * Look up a key.
+             *
+             * @param key The key.
+             *
+             * @return A copy of the value of the key, if present.
+             */
+            CCLNODISCARD std::optional<V> find(const_key_reference key) const {
+                const hash_t key_hash = hash(key);
+                const shard &s = shards[shard_index_hashed(key_hash)];
+                std::shared_lock lock{s.lock};
+                const auto it = s.table.find_hashed(key, key_hash);
+
+                if(it == s.table.end()) {
+                    return std::nullopt;
+                }
+
+                return std::optional<V>{*it->second};
+            }
+
+            /**
+             * Access the value of a key in place, while the key's shard is
+             * locked for writing.
+             *
+             * @param key The key.
+             * @param visitor A function invoked as `visitor(V&)`. Must not access this table.
+             *
+             * @return True if the key was found and `visitor` invoked, false otherwise.
+             */
+            template<typename Visitor>
+            bool visit(const_key_reference key, Visitor&& visitor) {
+                const hash_t key_hash = hash(key);
+                shard &s = shards[shard_index_hashed(key_hash)];
+                std::unique_lock lock{s.lock};
+                const auto it = s.table.find_hashed(key, key_hash);
+
+                if(it == s.table.end()) {
+                    return false;
+                }
+
+                visitor(*it->second);
+
+                return true;
+            }
+
+            /**
+             * Access the value of a key in place, while the key's shard is
+             * locked for reading.
+             *
+             * @param key The key.
+             * @param visitor A function invoked as `visitor(const V&)`. Must not modify this table.
+             *
+             * @return True if the key was found and `visitor` invoked, false otherwise.
+             */
+            template<typename Visitor>
+            bool visit(const_key_reference key, Visitor&& visitor) const {
+                const hash_t key_hash = hash(key);
+                const shard &s = shards[shard_index_hashed(key_hash)];
+                std::shared_lock lock{s.lock};
+                const auto it = s.table.find_hashed(key, key_hash);
+
+                if(it == s.table.end()) {
+                    return false;
+                }
+
+                visitor(*it->second);
+
+                return true;
+            }
+
+            /**
+             * Visit all the key-value pairs, one shard at a time. Each shard
+             * is locked for reading while its pairs are visited.
+             *
+             * @param visitor A function invoked as `visitor(const K&, const V&)`. Must not modify this table.
+             */
+            template<typename Visitor>
+            void for_each(Visitor&& visitor) const {
+                for(const shard &s : shards) {
+                    std::shared_lock lock{s.lock};
+
+                    for(const auto item : s.table) {
+                        visitor(*item.first, *item.second);
+                    }
+                }
+            }
+
+            /**
+             * Get the shard index of a key.
+             *
+             * The hash is mixed with a different multiplier than the one
+             * used by the shard tables, so that keys within a shard still
+             * spread over the slots and control bytes of its table.
+             *
+             * @param key The key.
+             *
+             * @return The index of the shard holding `key`.
+             */
+            CCLNODISCARD static constexpr size_type shard_index(const_key_reference key) noexcept {
+                return shard_index_hashed(hash(key));
+            }
+
+        private:
+            static constexpr hash_t hash(const_key_reference key) noexcept {
+                return HashFunction{}(key);
+            }
+
+            /**
+             * Get the shard index of a key hash. The hash is then passed on to
+             * the shard table, so that keys are hashed once per operation.
+             */
+            static constexpr size_type shard_index_hashed(const hash_t key_hash) noexcept {
+                if constexpr(shard_count == 1) {
+                    return 0;
+                } else {
+                    constexpr uint64_t multiplier = 0xC2B2AE3D27D4EB4FULL;
+
+                    return static_cast<size_type>((static_cast<uint64_t>(key_hash) * multiplier) >> (64 - shard_bits));
+                }
+            }
+    };
+}
+
+#endif // CCL_CONCURRENT_SHARDED_HASHTABLE_HPP
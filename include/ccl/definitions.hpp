@@ -20,6 +20,14 @@
     #define CCL_HASHTABLE_MINIMUM_CHUNK_SIZE 8
 #endif // CCL_HASHTABLE_MINIMUM_CHUNK_SIZE
 
+#ifndef CCL_HASHTABLE_STASH_SIZE
+    #define CCL_HASHTABLE_STASH_SIZE 16
+#endif // CCL_HASHTABLE_STASH_SIZE
+
+#ifndef CCL_HASHTABLE_MAX_LOAD_FACTOR
+    #define CCL_HASHTABLE_MAX_LOAD_FACTOR 0.875f
+#endif // CCL_HASHTABLE_MAX_LOAD_FACTOR
+
 #ifndef CCL_SET_MINIMUM_CAPACITY
     #define CCL_SET_MINIMUM_CAPACITY 256
 #endif // CCL_SET_MINIMUM_CAPACITY
@@ -28,6 +36,18 @@
     #define CCL_SET_KEY_CHUNK_SIZE 16
 #endif // CCL_SET_KEY_CHUNK_SIZE
 
+#ifndef CCL_HASH_BATCH_SIZE
+    #define CCL_HASH_BATCH_SIZE 16
+#endif // CCL_HASH_BATCH_SIZE
+
+#ifndef CCL_CACHE_LINE_SIZE
+    #define CCL_CACHE_LINE_SIZE 64
+#endif // CCL_CACHE_LINE_SIZE
+
+#ifndef CCL_SHARDED_HASHTABLE_SHARD_COUNT
+    #define CCL_SHARDED_HASHTABLE_SHARD_COUNT 64
+#endif // CCL_SHARDED_HASHTABLE_SHARD_COUNT
+
 #ifndef CCL_ALLOCATOR_DEFAULT_ALIGNMENT
     #define CCL_ALLOCATOR_DEFAULT_ALIGNMENT __STDCPP_DEFAULT_NEW_ALIGNMENT__
 #endif // CCL_ALLOCATOR_DEFAULT_ALIGNMENT
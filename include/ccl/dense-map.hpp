@@ -6,6 +6,9 @@
 #ifndef CCL_DENSE_MAP_HPP
 #define CCL_DENSE_MAP_HPP
 
+#include <concepts>
+#include <memory>
+#include <ranges>
 #include <utility>
 #include <ccl/api.hpp>
 #include <ccl/type-traits.hpp>
@@ -18,18 +21,65 @@
 #include <ccl/pair.hpp>
 #include <ccl/either.hpp>
 
+namespace ccl::internal {
+    /**
+     * Key of a dense map index: a pointer to a key in the dense key array,
+     * so that keys are stored once. Paged arrays do not move their items
+     * when growing; the pointer is only updated when erasing moves the key.
+     *
+     * @tparam K The dense map key type.
+     */
+    template<typename K>
+    struct dense_map_index_key {
+        mutable const K *key; // Not part of the hashed value: updated in place when the key moves
+
+        explicit constexpr dense_map_index_key(const K * const key) noexcept : key{key} {}
+
+        friend constexpr bool operator ==(const dense_map_index_key &a, const dense_map_index_key &b) {
+            return *a.key == *b.key;
+        }
+
+        template<typename Q>
+        requires (!std::same_as<Q, dense_map_index_key>)
+        friend constexpr bool operator ==(const dense_map_index_key &a, const Q &b) {
+            return *a.key == b;
+        }
+    };
+
+    /**
+     * Hash function of a dense map index, hashing the keys pointed to.
+     * Transparent, so that the index is looked up with plain keys.
+     *
+     * @tparam K The dense map key type.
+     * @tparam Hash The dense map hash function.
+     */
+    template<typename K, typename Hash>
+    struct dense_map_index_hash {
+        using is_transparent = void;
+
+        constexpr hash_t operator()(const dense_map_index_key<K> &x) const {
+            return Hash{}(*x.key);
+        }
+
+        template<typename Q>
+        requires (!std::same_as<Q, dense_map_index_key<K>>) && typed_hash_function<Hash, Q>
+        constexpr hash_t operator()(const Q &x) const {
+            return Hash{}(x);
+        }
+    };
+}
+
 namespace ccl {
-template<typename Map>
+    /**
+     * Iterator over the items of a dense map, in dense order.
+     */
+    template<typename Map>
     struct dense_map_iterator {
         using iterator_category = std::bidirectional_iterator_tag;
         using iterator_concept = iterator_category;
         using difference_type = std::ptrdiff_t;
 
-        using map_key_type = either_or_t<
-            const typename Map::key_type,
-            typename Map::key_type,
-            std::is_const_v<Map>
-        >;
+        using map_key_type = const typename Map::key_type;
 
         using map_value_type = either_or_t<
             const typename Map::value_type,
@@ -43,129 +93,119 @@ template<typename Map>
         using reference = value_type&;
         using size_type = typename Map::size_type;
 
-        using index_map_iterator = hashtable_iterator<
-            either_or_t<
-                const typename map_type::index_map_type,
-                typename map_type::index_map_type,
-                std::is_const_v<Map>
-            >
-        >;
-
         constexpr dense_map_iterator() = default;
 
-        constexpr dense_map_iterator(map_type& dense_map, index_map_iterator position) noexcept
+        constexpr dense_map_iterator(map_type& dense_map, const size_type position) noexcept
             : map{&dense_map},
-            index_iterator{position}
+            index{position}
         {}
 
         constexpr dense_map_iterator(const dense_map_iterator &other) noexcept
             : map{other.map},
-            index_iterator{*other.index_iterator.hashtable, other.index_iterator.index}
-        {}
-
-        constexpr dense_map_iterator(dense_map_iterator &&other) noexcept
-            : map{std::move(other.map)},
-            index_iterator{std::move(other.index_iterator)}
+            index{other.index}
         {}
 
         constexpr dense_map_iterator& operator =(const dense_map_iterator &other) noexcept {
-            map = other. dense_map;
-            index_iterator = other.index_iterator;
+            map = other.map;
+            index = other.index;
 
             return *this;
         }
 
-        constexpr value_type operator*() noexcept {
-            const auto& key_index_pair = (*index_iterator);
-            const uint32_t index = *key_index_pair.second;
-
-            return value_type{ key_index_pair.first, &map->data[index] };
-        }
-
         constexpr value_type operator*() const noexcept {
-            const auto& key_index_pair = (*index_iterator);
-            const uint32_t index = *key_index_pair.second;
-
-            return value_type{ key_index_pair.first, &map->data[index] };
+            return value_type{ &map->keys[index], &map->data[index] };
         }
 
         constexpr value_type* operator->() const noexcept {
-            const auto& key_index_pair = (*index_iterator);
-            const uint32_t index = *key_index_pair.second;
+            current = value_type{ &map->keys[index], &map->data[index] };
 
-            pair = value_type{ key_index_pair.first, &map->data[index] };
-
-            return &pair;
+            return &current;
         }
 
         constexpr auto& operator --() noexcept {
-            --index_iterator;
+            --index;
 
             return *this;
         }
 
         constexpr auto operator --(int) noexcept {
-            return dense_map_iterator{*map, index_iterator--};
+            return dense_map_iterator{*map, index--};
         }
 
         constexpr auto& operator ++() noexcept {
-            ++index_iterator;
+            ++index;
 
             return *this;
         }
 
         constexpr auto operator ++(int) noexcept {
-            return dense_map_iterator{*map, index_iterator++};
+            return dense_map_iterator{*map, index++};
         }
 
-        map_type *map;
-        mutable index_map_iterator index_iterator;
-        mutable value_type pair;
+        map_type *map = nullptr;
+        size_type index = 0;
+        mutable value_type current;
     };
 
     template<typename Map>
     constexpr bool operator ==(const dense_map_iterator<Map> a, const dense_map_iterator<Map> b) {
-        return a.map == b.map && a.index_iterator == b.index_iterator;
+        return a.map == b.map && a.index == b.index;
     }
 
     template<typename Map>
     constexpr bool operator !=(const dense_map_iterator<Map> a, const dense_map_iterator<Map> b) {
-        return a.map != b.map || a.index_iterator != b.index_iterator;
+        return a.map != b.map || a.index != b.index;
     }
 
     template<typename Map>
     constexpr bool operator >(const dense_map_iterator<Map> a, const dense_map_iterator<Map> b) {
         CCL_THROW_IF(a.map != b.map, std::runtime_error{"Comparing iterators from different dense maps."});
 
-        return a.index_iterator > b.index_iterator;
+        return a.index > b.index;
     }
 
     template<typename Map>
     constexpr bool operator <(const dense_map_iterator<Map> a, const dense_map_iterator<Map> b) {
         CCL_THROW_IF(a.map != b.map, std::runtime_error{"Comparing iterators from different dense maps."});
 
-        return a.index_iterator < b.index_iterator;
+        return a.index < b.index;
     }
 
     template<typename Map>
     constexpr bool operator >=(const dense_map_iterator<Map> a, const dense_map_iterator<Map> b) {
         CCL_THROW_IF(a.map != b.map, std::runtime_error{"Comparing iterators from different dense maps."});
 
-        return a.index_iterator >= b.index_iterator;
+        return a.index >= b.index;
     }
 
     template<typename Map>
     constexpr bool operator <=(const dense_map_iterator<Map> a, const dense_map_iterator<Map> b) {
         CCL_THROW_IF(a.map != b.map, std::runtime_error{"Comparing iterators from different dense maps."});
 
-        return a.index_iterator <= b.index_iterator;
+        return a.index <= b.index;
     }
 
+    /**
+     * A map storing its keys and values contiguously, indexed by a hashtable.
+     *
+     * Keys and values are stored in two parallel dense arrays, in which
+     * iterating is linear. The index maps each key to its position in the
+     * dense arrays, referring to the dense key rather than holding a copy
+     * of it. Erasing an item moves the last one in its place: the dense
+     * arrays are not kept in insertion order.
+     *
+     * @tparam K Key type.
+     * @tparam V Value type.
+     * @tparam Hash The function used to compute the key hashes.
+     * @tparam Allocator The allocator type.
+     * @tparam Policy The policy of the index hashtable.
+     */
     template<
         typename K,
         typename V,
         typed_hash_function<K> Hash = hash<K>,
-        typed_allocator<K> Allocator = allocator
+        typed_allocator<K> Allocator = allocator,
+        typename Policy = default_hashtable_policy
     > class dense_map {
         friend struct dense_map_iterator<dense_map>;
         friend struct dense_map_iterator<const dense_map>;
@@ -179,15 +219,26 @@ template<typename Map>
             using allocator_type = Allocator;
             using hash_function_type = Hash;
             using hash_type = hash_t;
+            using policy_type = Policy;
             using size_type = uint32_t;
             using data_vector_type = paged_vector<V, V*, allocator_type>;
-            using index_map_type = hashtable<K, size_type, hash_function_type, allocator_type>;
+            using key_vector_type = paged_vector<K, K*, allocator_type>;
+            using index_key_type = internal::dense_map_index_key<K>;
+            using index_map_type = hashtable<
+                index_key_type,
+                size_type,
+                internal::dense_map_index_hash<K, hash_function_type>,
+                allocator_type,
+                policy_type
+            >;
             using value_iterator = typename data_vector_type::iterator;
             using const_value_iterator = typename data_vector_type::const_iterator;
+            using const_key_iterator = typename key_vector_type::const_iterator;
             using iterator = dense_map_iterator<dense_map>;
             using const_iterator = dense_map_iterator<const dense_map>;
 
         private:
+            key_vector_type keys;
             data_vector_type data;
             index_map_type index_map;
 
@@ -206,10 +257,127 @@ template<typename Map>
                 return wrap_index(hash(x), capacity);
             }
 
-            void reset_indices_after_removal(const size_type removed_index) {
-                for(auto pair : index_map) {
-                    size_type &current_index = *pair.second;
-                    current_index -= current_index > removed_index;
+            /**
+             * Dense entries of a new index entry, being appended. Unless
+             * committed, both the entries and the index entry are dropped on
+             * destruction, so that a throwing key or value constructor leaves
+             * the map unchanged.
+             */
+            class pending_item {
+                dense_map &map;
+                typename index_map_type::iterator index_it;
+                size_type index;
+                bool is_committed = false;
+
+                public:
+                    constexpr pending_item(dense_map &map, const typename index_map_type::iterator index_it) noexcept
+                        : map{map}, index_it{index_it}, index{map.size()}
+                    {}
+
+                    pending_item(const pending_item&) = delete;
+                    pending_item& operator =(const pending_item&) = delete;
+
+                    constexpr ~pending_item() {
+                        if(!is_committed) {
+                            map.keys.erase(map.keys.begin() + index, map.keys.end());
+                            map.data.erase(map.data.begin() + index, map.data.end());
+                            map.index_map.erase(index_it);
+                        }
+                    }
+
+                    /**
+                     * Point the index entry to its dense key, once appended.
+                     */
+                    constexpr void commit() noexcept {
+                        index_it->first->key = &map.keys[index];
+                        is_committed = true;
+                    }
+            };
+
+            /**
+             * Insert a key in the index, pointing to the key argument until
+             * the dense entries are appended, so that the key is neither
+             * hashed twice nor copied.
+             */
+            template<typename KeyArg, typename ...Args>
+            constexpr pair<iterator, bool> try_emplace_key(KeyArg&& key, Args&& ...args) {
+                const auto result = index_map.try_emplace(index_key_type{std::addressof(key)}, size());
+
+                if(result.second) {
+                    pending_item item{*this, result.first};
+
+                    keys.emplace_back(std::forward<KeyArg>(key));
+                    data.emplace_back(std::forward<Args>(args)...);
+                    item.commit();
+                }
+
+                return { iterator{*this, *result.first->second}, result.second };
+            }
+
+            template<typename KeyArg, typename ValueArg>
+            constexpr void insert_or_assign_key(KeyArg&& key, ValueArg&& value) {
+                const auto result = index_map.try_emplace(index_key_type{std::addressof(key)}, size());
+
+                if(result.second) {
+                    pending_item item{*this, result.first};
+
+                    keys.emplace_back(std::forward<KeyArg>(key));
+                    data.emplace_back(std::forward<ValueArg>(value));
+                    item.commit();
+                } else {
+                    data[*result.first->second] = std::forward<ValueArg>(value);
+                }
+            }
+
+            /**
+             * Erase the item of an index entry. The last item takes its
+             * place in the dense arrays, and only its index is updated.
+             */
+            constexpr void erase_indexed(const typename index_map_type::iterator index_it) {
+                const size_type index = *index_it->second;
+                const size_type last_index = size() - 1;
+
+                index_map.erase(index_it);
+
+                if(index != last_index) {
+                    // Found before the key moves, as the index entry points to it.
+                    const auto last_it = index_map.find(keys[last_index]);
+
+                    keys[index] = std::move(keys[last_index]);
+                    data[index] = std::move(data[last_index]);
+                    last_it->first->key = &keys[index];
+                    *last_it->second = index;
+                }
+
+                keys.erase(keys.end() - 1);
+                data.erase(data.end() - 1);
+            }
+
+            /**
+             * Visit all the items of a map, one page of the dense arrays at a time.
+             */
+            template<typename Map, typename Visitor>
+            static constexpr void for_each_item(Map &map, Visitor &visitor) {
+                constexpr size_type page_size = data_vector_type::page_size;
+
+                const auto key_pages = map.keys.pages();
+                const auto value_pages = map.data.pages();
+                size_type remaining = map.size();
+
+                for(size_type page = 0; remaining; ++page) {
+                    const size_type count = min(remaining, page_size);
+                    const K * const page_keys = key_pages[page];
+                    const auto page_values = value_pages[page];
+
+                    for(size_type i = 0; i < count; ++i) {
+                        if constexpr(std::is_const_v<Map>) {
+                            visitor(page_keys[i], std::as_const(page_values[i]));
+                        } else {
+                            visitor(page_keys[i], page_values[i]);
+                        }
+                    }
+
+                    remaining -= count;
                 }
             }
 
@@ -218,43 +386,109 @@ template<typename Map>
                 const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
                 allocator_type * const allocator = nullptr
             )
-                : data{alloc_flags, allocator},
+                : keys{alloc_flags, allocator},
+                data{alloc_flags, allocator},
                 index_map{alloc_flags, allocator}
             {}
 
             constexpr dense_map(const dense_map &other)
-                : data{other.data},
-                index_map{other.index_map}
-            {}
+                : keys{other.keys},
+                data{other.data},
+                index_map{other.index_map.get_allocation_flags(), other.index_map.get_allocator()}
+            {
+                rebuild_index();
+            }
 
             constexpr dense_map(dense_map &&other)
-                : data{std::move(other.data)},
+                : keys{std::move(other.keys)},
+                data{std::move(other.data)},
                 index_map{std::move(other.index_map)}
             {}
 
-            constexpr void insert(const_key_reference key, const_value_reference value) {
-                auto it = index_map.find(key);
-
-                if(it == index_map.end()) {
-                    const size_type item_index = static_cast<size_type>(data.size());
+            /**
+             * Initialise a map from a range of key-value pairs. Sized ranges
+             * are stored without growing the map while inserting. Later pairs
+             * override the values of earlier ones with the same key.
+             *
+             * @param input The pairs to insert.
+             */
+            template<std::ranges::input_range InputRange>
+            requires (!std::same_as<std::remove_cvref_t<InputRange>, dense_map>)
+            constexpr dense_map(
+                InputRange&& input,
+                const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
+                allocator_type * const allocator = nullptr
+            ) : dense_map{alloc_flags, allocator} {
+                if constexpr(std::ranges::sized_range<InputRange>) {
+                    reserve(static_cast<size_type>(std::ranges::size(input)));
+                }
 
-                    data.push_back(value);
-                    index_map.insert(key, item_index);
-                } else {
-                    data[*it->second] = value;
+                for(auto&& item : input) {
+                    insert(item.first, item.second);
                 }
             }
 
+            /**
+             * Grow the map ahead of holding a number of items, so that
+             * inserting them does not grow the dense arrays or rehash
+             * the index.
+             *
+             * @param item_count The number of items.
+             */
+            constexpr void reserve(const size_type item_count) {
+                keys.reserve(item_count);
+                data.reserve(item_count);
+                index_map.reserve_items(item_count);
+            }
+
+            /**
+             * Insert an item, or assign the value of its key if already present.
+             *
+             * @param key The key. Moved into the map if it is an rvalue.
+             * @param value The value. Forwarded to either the value constructor
+             *  or its assignment operator.
+             */
+            template<typename ValueArg = V> requires std::constructible_from<V, ValueArg> && std::assignable_from<V&, ValueArg>
+            constexpr void insert(const_key_reference key, ValueArg&& value) {
+                insert_or_assign_key(key, std::forward<ValueArg>(value));
+            }
+
+            template<typename ValueArg = V> requires std::constructible_from<V, ValueArg> && std::assignable_from<V&, ValueArg>
+            constexpr void insert(key_type&& key, ValueArg&& value) {
+                insert_or_assign_key(std::move(key), std::forward<ValueArg>(value));
+            }
+
+            /**
+             * Insert a key, constructing its value in place, unless the key is
+             * already present. Neither the key nor the arguments are consumed
+             * if the key is present.
+             *
+             * @param key The key.
+             * @param args The value constructor arguments.
+             *
+             * @return An iterator to the item and whether it was inserted.
+             */
+            template<typename ...Args>
+            constexpr pair<iterator, bool> try_emplace(const_key_reference key, Args&& ...args) {
+                return try_emplace_key(key, std::forward<Args>(args)...);
+            }
+
+            template<typename ...Args>
+            constexpr pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args) {
+                return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+            }
+
+            /**
+             * Erase an item. The last item takes its place, so that erasing
+             * while iterating must not advance the iterator.
+             *
+             * @param where The item to erase.
+             */
             constexpr void erase(const iterator where) {
                 CCL_THROW_IF(where < begin() || where > end(), std::out_of_range{"Iterator out of range."});
 
                 if(where != end()) {
-                    const auto& key = *where->first;
-                    const size_type index = static_cast<size_type>(*where.index_iterator->second);
-
-                    data.erase(data.begin() + index);
-                    index_map.erase(key);
-                    reset_indices_after_removal(index);
+                    erase_indexed(index_map.find(keys[where.index]));
                 }
             }
 
@@ -262,11 +496,7 @@ template<typename Map>
                 const auto it = index_map.find(key);
 
                 if(it != index_map.end()) {
-                    const size_type index = static_cast<size_type>(*it->second);
-
-                    data.erase(data.begin() + index);
-                    index_map.erase(key);
-                    reset_indices_after_removal(index);
+                    erase_indexed(it);
                 }
             }
 
@@ -274,6 +504,11 @@ template<typename Map>
                 return index_map.contains(item);
             }
 
+            template<transparent_key<K, Hash> Q>
+            constexpr bool contains(const Q& item) const {
+                return index_map.contains(item);
+            }
+
             constexpr decltype(auto) begin_values() { return data.begin(); }
             constexpr decltype(auto) begin_values() const { return data.begin(); }
             constexpr decltype(auto) end_values() { return data.end(); }
@@ -282,13 +517,40 @@ template<typename Map>
             constexpr decltype(auto) cbegin_values() const { return data.cbegin(); }
             constexpr decltype(auto) cend_values() const { return data.cend(); }
 
-            constexpr decltype(auto) begin() { return iterator{*this, index_map.begin()}; }
-            constexpr decltype(auto) begin() const { return const_iterator{*this, index_map.begin()}; }
-            constexpr decltype(auto) end() { return iterator{*this, index_map.end()}; }
-            constexpr decltype(auto) end() const { return const_iterator{*this, index_map.end()}; }
+            constexpr const_key_iterator begin_keys() const { return keys.begin(); }
+            constexpr const_key_iterator end_keys() const { return keys.end(); }
+
+            /**
+             * Iterators over the items, in dense order.
+             */
+            constexpr decltype(auto) begin() { return iterator{*this, 0}; }
+            constexpr decltype(auto) begin() const { return const_iterator{*this, 0}; }
+            constexpr decltype(auto) end() { return iterator{*this, size()}; }
+            constexpr decltype(auto) end() const { return const_iterator{*this, size()}; }
+
+            constexpr decltype(auto) cbegin() const { return const_iterator{*this, 0}; }
+            constexpr decltype(auto) cend() const { return const_iterator{*this, size()}; }
+
+            /**
+             * Visit all the items, in dense order. Keys and values are read
+             * sequentially, without going through the index.
+             *
+             * @param visitor A function invoked as `visitor(const K&, V&)`.
+             */
+            template<typename Visitor>
+            constexpr void for_each(Visitor&& visitor) {
+                for_each_item(*this, visitor);
+            }
 
-            constexpr decltype(auto) cbegin() const { return const_iterator{*this, index_map.begin()}; }
-            constexpr decltype(auto) cend() const { return const_iterator{*this, index_map.end()}; }
+            /**
+             * Visit all the items, in dense order.
+             *
+             * @param visitor A function invoked as `visitor(const K&, const V&)`.
+             */
+            template<typename Visitor>
+            constexpr void for_each(Visitor&& visitor) const {
+                for_each_item(*this, visitor);
+            }
 
             constexpr size_type size() const noexcept {
                 return static_cast<size_type>(data.size());
@@ -298,7 +560,7 @@ template<typename Map>
                 auto index_it = index_map.find(key);
 
                 if(index_it != index_map.end()) {
-                    return iterator{*this, index_it};
+                    return iterator{*this, *index_it->second};
                 }
 
                 return end();
@@ -308,7 +570,37 @@ template<typename Map>
                 const auto index_it = index_map.find(key);
 
                 if(index_it != index_map.end()) {
-                    return const_iterator{*this, index_it};
+                    return const_iterator{*this, *index_it->second};
+                }
+
+                return end();
+            }
+
+            /**
+             * Find a key, looking it up through a compatible type. Requires
+             * a transparent hash function. No temporary key is constructed.
+             *
+             * @param key The key to look up.
+             *
+             * @return An iterator to the key or `end()` if not present.
+             */
+            template<transparent_key<K, Hash> Q>
+            constexpr iterator find(const Q& key) {
+                auto index_it = index_map.find(key);
+
+                if(index_it != index_map.end()) {
+                    return iterator{*this, *index_it->second};
+                }
+
+                return end();
+            }
+
+            template<transparent_key<K, Hash> Q>
+            constexpr const_iterator find(const Q& key) const {
+                const auto index_it = index_map.find(key);
+
+                if(index_it != index_map.end()) {
+                    return const_iterator{*this, *index_it->second};
                 }
 
                 return end();
@@ -316,16 +608,16 @@ template<typename Map>
 
             template<typename ...Args>
             constexpr value_reference emplace(const_key_reference key, Args&& ...args) {
-                auto it = index_map.find(key);
-
-                CCL_THROW_IF(it != index_map.end(), std::invalid_argument{"Key already present."});
+                CCL_THROW_IF(index_map.contains(key), std::invalid_argument{"Key already present."});
 
-                const size_type item_index = static_cast<size_type>(data.size());
+                return *try_emplace_key(key, std::forward<Args>(args)...).first->second;
+            }
 
-                auto& ref = data.emplace_back(std::forward<Args>(args)...);
-                index_map.insert(key, item_index);
+            template<typename ...Args>
+            constexpr value_reference emplace(key_type&& key, Args&& ...args) {
+                CCL_THROW_IF(index_map.contains(key), std::invalid_argument{"Key already present."});
 
-                return ref;
+                return *try_emplace_key(std::move(key), std::forward<Args>(args)...).first->second;
             }
 
             /**
@@ -365,18 +657,11 @@ template<typename Map>
             }
 
             constexpr value_reference operator[](const_key_reference key) {
-                auto it = index_map.find(key);
-
-                if(it != index_map.end()) {
-                    const size_type item_index = *it->second;
-
-                    return data[item_index];
-                }
-
-                return emplace(key);
+                return *try_emplace_key(key).first->second;
             }
 
             constexpr dense_map& operator=(dense_map&& other) {
+                keys = std::move(other.keys);
                 data = std::move(other.data);
                 index_map = std::move(other.index_map);
 
@@ -384,8 +669,11 @@ template<typename Map>
             }
 
             constexpr dense_map& operator=(const dense_map& other) {
-                data = other.data;
-                index_map = other.index_map;
+                if(this != &other) {
+                    keys = other.keys;
+                    data = other.data;
+                    rebuild_index();
+                }
 
                 return *this;
             }
@@ -394,12 +682,28 @@ template<typename Map>
              * Remove all items from the map.
              */
             void clear() {
+                keys.clear();
                 data.clear();
                 index_map.clear();
             }
 
             constexpr allocator_type* get_allocator() const noexcept { return data.get_allocator(); }
             constexpr allocation_flags get_allocation_flags() const noexcept { return data.get_allocation_flags(); }
+
+        private:
+            /**
+             * Index the dense keys again, as after copying them.
+             */
+            constexpr void rebuild_index() {
+                const size_type item_count = size();
+
+                index_map.clear();
+                index_map.reserve_items(item_count);
+
+                for(size_type i = 0; i < item_count; ++i) {
+                    index_map.insert(index_key_type{&keys[i]}, i);
+                }
+            }
     };
 }
 
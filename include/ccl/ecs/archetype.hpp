@@ -0,0 +1,327 @@
+/**
+ * @file
+ *
+ * ECS archetype.
+ */
+#ifndef CCL_ECS_ARCHETYPE_HPP
+#define CCL_ECS_ARCHETYPE_HPP
+
+#include <algorithm>
+#include <limits>
+#include <ccl/api.hpp>
+#include <ccl/debug.hpp>
+#include <ccl/exceptions.hpp>
+#include <ccl/features.hpp>
+#include <ccl/vector.hpp>
+#include <ccl/paged-vector.hpp>
+#include <ccl/memory/allocator.hpp>
+#include <ccl/internal/optional-allocator.hpp>
+#include <ccl/ecs/component.hpp>
+
+namespace ccl::ecs {
+    /**
+     * Table of all the entities with the same set of components.
+     *
+     * Each component is stored in its own column, and each entity in a row
+     * of all the columns. Columns are paged vectors, all with the same
+     * length, so that the components of an entity are found at the same
+     * index of every column, and pages of different columns hold the same
+     * entities. Erasing a row moves the last row in its place.
+     *
+     * @tparam Allocator The allocator type.
+     */
+    template<typed_allocator<entity_t> Allocator = allocator>
+    class archetype : ccl::internal::with_optional_allocator<Allocator> {
+        public:
+            using size_type = count_t;
+            using allocator_type = Allocator;
+            using entity_vector_type = paged_vector<entity_t, entity_t*, allocator_type>;
+
+            template<component T>
+            using column_type = column<T, allocator_type>;
+
+            static constexpr size_type invalid_index = std::numeric_limits<size_type>::max();
+
+        private:
+            using alloc = ccl::internal::with_optional_allocator<Allocator>;
+            using column_vector_type = vector<column_base*, allocator_type>;
+
+            column_vector_type columns; // Sorted by component ID
+            entity_vector_type _entities;
+            component_id_t _signature = 0;
+            allocation_flags alloc_flags;
+
+        public:
+            explicit archetype(
+                const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
+                allocator_type * const allocator = nullptr
+            ) : alloc{allocator},
+                columns{alloc_flags, allocator},
+                _entities{alloc_flags, allocator},
+                alloc_flags{alloc_flags}
+            {}
+
+            archetype(const archetype&) = delete;
+            archetype& operator =(const archetype&) = delete;
+
+            ~archetype() {
+                for(column_base * const c : columns) {
+                    c->release();
+                }
+            }
+
+            /**
+             * Compute the signature of a set of components, independent of
+             * their order.
+             *
+             * @param ids The component IDs.
+             */
+            static constexpr component_id_t make_signature(const std::initializer_list<component_id_t> ids) noexcept {
+                component_id_t signature = 0;
+
+                for(const component_id_t id : ids) {
+                    signature ^= id;
+                }
+
+                return signature;
+            }
+
+            /**
+             * Add the column of a component. The archetype must be empty.
+             *
+             * @tparam T The component type. Must not be part of the archetype.
+             */
+            template<component T>
+            void add_column() {
+                insert_column(column_type<T>::create(alloc_flags, alloc::get_allocator()));
+            }
+
+            /**
+             * Add empty columns for all the components of another archetype.
+             * The archetype must be empty.
+             *
+             * @param source The archetype to copy the components of.
+             * @param excluded_id A component of `source` not to add, or 0.
+             */
+            void add_columns_of(const archetype &source, const component_id_t excluded_id = 0) {
+                for(const column_base * const c : source.columns) {
+                    if(c->get_component_id() != excluded_id) {
+                        insert_column(c->make_empty());
+                    }
+                }
+            }
+
+            /**
+             * Find the column of a component.
+             *
+             * @param id The component ID.
+             *
+             * @return The index of the column or `invalid_index` if the
+             *  component is not part of the archetype.
+             */
+            constexpr size_type find_column(const component_id_t id) const noexcept {
+                const auto it = std::lower_bound(
+                    columns.begin(),
+                    columns.end(),
+                    id,
+                    [] (const column_base * const c, const component_id_t x) {
+                        return c->get_component_id() < x;
+                    }
+                );
+
+                return it != columns.end() && (*it)->get_component_id() == id
+                    ? static_cast<size_type>(it - columns.begin())
+                    : invalid_index;
+            }
+
+            constexpr bool has_component(const component_id_t id) const noexcept {
+                return find_column(id) != invalid_index;
+            }
+
+            template<component T>
+            constexpr bool has_component() const noexcept {
+                return has_component(component_id<T>);
+            }
+
+            /**
+             * Check whether the archetype holds all the components of
+             * another one, and exactly one more.
+             *
+             * @param other The other archetype.
+             * @param id The extra component.
+             */
+            constexpr bool extends(const archetype &other, const component_id_t id) const noexcept {
+                if(component_count() != other.component_count() + 1 || !has_component(id)) {
+                    return false;
+                }
+
+                for(const column_base * const c : other.columns) {
+                    if(!has_component(c->get_component_id())) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * Get the components of a type.
+             *
+             * If `CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS` is defined, an
+             * exception is thrown if the component is not part of the archetype.
+             *
+             * @tparam T The component type.
+             *
+             * @return The column data, one component per row.
+             */
+            template<component T>
+            constexpr typename column_type<T>::data_vector_type& get_components() {
+                return get_column<T>().data();
+            }
+
+            template<component T>
+            constexpr const typename column_type<T>::data_vector_type& get_components() const {
+                return const_cast<archetype*>(this)->template get_column<T>().data();
+            }
+
+            /**
+             * Append an entity. The caller must append one component to
+             * each of the columns.
+             *
+             * @param entity The entity.
+             *
+             * @return The row of the entity.
+             */
+            constexpr size_type push_entity(const entity_t entity) {
+                const size_type row = _entities.size();
+
+                _entities.push_back(entity);
+
+                return row;
+            }
+
+            /**
+             * Append a component to the column of its type.
+             *
+             * @tparam T The component type.
+             * @param args The component constructor arguments.
+             */
+            template<component T, typename ...Args>
+            constexpr T& emplace_component(Args&& ...args) {
+                return get_components<T>().emplace_back(std::forward<Args>(args)...);
+            }
+
+            /**
+             * Erase a row, moving the last row in its place.
+             *
+             * @param row The row.
+             *
+             * @return The entity moved in the row, or `invalid_entity` if the
+             *  erased row was the last one.
+             */
+            constexpr entity_t erase_row(const size_type row) {
+                const size_type last_row = _entities.size() - 1;
+                entity_t moved_entity = invalid_entity;
+
+                for(column_base * const c : columns) {
+                    c->erase_row(row);
+                }
+
+                if(row != last_row) {
+                    moved_entity = _entities[last_row];
+                    _entities[row] = moved_entity;
+                }
+
+                _entities.erase(_entities.end() - 1);
+
+                return moved_entity;
+            }
+
+            /**
+             * Move a row to another archetype, and erase it. Only the components
+             * part of the other archetype are moved. The caller must append
+             * the components missing from this archetype.
+             *
+             * @param row The row.
+             * @param destination The destination archetype.
+             *
+             * @return The entity moved in the row, as returned by `erase_row()`.
+             */
+            constexpr entity_t move_row(const size_type row, archetype &destination) {
+                destination.push_entity(_entities[row]);
+
+                for(column_base * const c : columns) {
+                    const size_type destination_index = destination.find_column(c->get_component_id());
+
+                    if(destination_index != invalid_index) {
+                        c->move_row_to(row, *destination.columns[destination_index]);
+                    }
+                }
+
+                return erase_row(row);
+            }
+
+            /**
+             * Drop the rows past a row count, along with the components
+             * appended past it. Columns may have different lengths, as when
+             * appending a row was interrupted by an exception.
+             *
+             * @param row_count The number of rows to keep.
+             */
+            constexpr void truncate(const size_type row_count) {
+                for(column_base * const c : columns) {
+                    while(c->size() > row_count) {
+                        c->erase_row(c->size() - 1);
+                    }
+                }
+
+                if(_entities.size() > row_count) {
+                    _entities.erase(_entities.begin() + row_count, _entities.end());
+                }
+            }
+
+            constexpr const entity_vector_type& entities() const noexcept { return _entities; }
+            constexpr size_type size() const noexcept { return _entities.size(); }
+            constexpr bool is_empty() const noexcept { return _entities.size() == 0; }
+            constexpr size_type component_count() const noexcept { return columns.size(); }
+            constexpr component_id_t signature() const noexcept { return _signature; }
+
+            constexpr allocator_type* get_allocator() const noexcept { return alloc::get_allocator(); }
+            constexpr allocation_flags get_allocation_flags() const noexcept { return alloc_flags; }
+
+        private:
+            template<component T>
+            constexpr column_type<T>& get_column() {
+                const size_type index = find_column(component_id<T>);
+
+#ifdef CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS
+                CCL_THROW_IF(index == invalid_index, std::invalid_argument{"Component not part of the archetype."});
+#else // CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS
+                CCL_ASSERT(index != invalid_index);
+#endif // CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS
+
+                return static_cast<column_type<T>&>(*columns[index]);
+            }
+
+            void insert_column(column_base * const new_column) {
+                const component_id_t id = new_column->get_component_id();
+
+                CCL_ASSERT(is_empty());
+                CCL_ASSERT(!has_component(id));
+
+                const auto position = std::lower_bound(
+                    columns.begin(),
+                    columns.end(),
+                    id,
+                    [] (const column_base * const c, const component_id_t x) {
+                        return c->get_component_id() < x;
+                    }
+                );
+
+                columns.insert(position, new_column);
+                _signature ^= id;
+            }
+    };
+}
+
+#endif // CCL_ECS_ARCHETYPE_HPP
@@ -0,0 +1,180 @@
+/**
+ * @file
+ *
+ * ECS components and their storage.
+ */
+#ifndef CCL_ECS_COMPONENT_HPP
+#define CCL_ECS_COMPONENT_HPP
+
+#include <concepts>
+#include <limits>
+#include <memory>
+#include <new>
+#include <source_location>
+#include <string_view>
+#include <type_traits>
+#include <ccl/api.hpp>
+#include <ccl/debug.hpp>
+#include <ccl/hash.hpp>
+#include <ccl/paged-vector.hpp>
+#include <ccl/memory/allocator.hpp>
+
+namespace ccl::ecs {
+    /**
+     * Entity identifier. Identifiers are never reused by a registry.
+     */
+    using entity_t = uint64_t;
+
+    /**
+     * Component type identifier.
+     */
+    using component_id_t = hash_t;
+
+    static constexpr entity_t invalid_entity = std::numeric_limits<entity_t>::max();
+
+    /**
+     * A type that can be stored as a component.
+     */
+    template<typename T>
+    concept component = std::same_as<T, std::remove_cvref_t<T>> && std::movable<T>;
+
+    namespace internal {
+        /**
+         * Name of the function instantiated for a type, unique to the type.
+         */
+        template<typename T>
+        constexpr std::string_view type_signature() noexcept {
+            return std::source_location::current().function_name();
+        }
+    }
+
+    /**
+     * Identifier of a component type, computed at compile time from the
+     * name of the type. Stable across translation units and binaries built
+     * with the same compiler.
+     */
+    template<component T>
+    inline constexpr component_id_t component_id = string_hash<>{}(internal::type_signature<T>());
+
+    /**
+     * Type-erased column of an archetype, storing one component of each
+     * of its entities.
+     */
+    class column_base {
+        public:
+            using size_type = count_t;
+
+        private:
+            component_id_t id;
+
+        public:
+            explicit constexpr column_base(const component_id_t id) noexcept : id{id} {}
+            column_base(const column_base&) = delete;
+            virtual ~column_base() = default;
+
+            column_base& operator =(const column_base&) = delete;
+
+            constexpr component_id_t get_component_id() const noexcept { return id; }
+
+            virtual size_type size() const noexcept = 0;
+
+            /**
+             * Move the component of a row to the end of another column of the
+             * same component. The moved-from component is left in this column.
+             *
+             * @param row The row to move.
+             * @param destination The destination column.
+             */
+            virtual void move_row_to(size_type row, column_base &destination) = 0;
+
+            /**
+             * Erase a row, moving the last row in its place.
+             *
+             * @param row The row to erase.
+             */
+            virtual void erase_row(size_type row) = 0;
+
+            /**
+             * Create an empty column of the same component, with the same allocator.
+             * The column must be released with `release()`.
+             */
+            virtual column_base* make_empty() const = 0;
+
+            /**
+             * Destroy a column created with `make_empty()` or `column::create()`,
+             * and deallocate it.
+             */
+            virtual void release() noexcept = 0;
+    };
+
+    /**
+     * Column of a component type.
+     *
+     * @tparam T The component type.
+     * @tparam Allocator The allocator type.
+     */
+    template<component T, typed_allocator<T> Allocator = allocator>
+    class column final : public column_base {
+        public:
+            using value_type = T;
+            using allocator_type = Allocator;
+            using data_vector_type = paged_vector<T, T*, allocator_type>;
+
+        private:
+            data_vector_type _data;
+
+            column(const allocation_flags alloc_flags, allocator_type * const allocator)
+                : column_base{component_id<T>},
+                _data{alloc_flags, allocator}
+            {}
+
+        public:
+            /**
+             * Allocate and construct an empty column.
+             *
+             * @param alloc_flags The allocation flags of the column and its data.
+             * @param allocator The allocator of the column and its data. Must not be null.
+             */
+            static column* create(const allocation_flags alloc_flags, allocator_type * const allocator) {
+                CCL_ASSERT(allocator);
+
+                column * const new_column = allocator->template allocate<column>(1, alloc_flags);
+
+                return ::new(static_cast<void*>(new_column)) column{alloc_flags, allocator};
+            }
+
+            size_type size() const noexcept override { return _data.size(); }
+
+            void move_row_to(const size_type row, column_base &destination) override {
+                CCL_ASSERT(destination.get_component_id() == get_component_id());
+
+                static_cast<column&>(destination)._data.emplace_back(std::move(_data[row]));
+            }
+
+            void erase_row(const size_type row) override {
+                const size_type last_row = _data.size() - 1;
+
+                if(row != last_row) {
+                    _data[row] = std::move(_data[last_row]);
+                }
+
+                _data.erase(_data.end() - 1);
+            }
+
+            column_base* make_empty() const override {
+                return create(_data.get_allocation_flags(), _data.get_allocator());
+            }
+
+            void release() noexcept override {
+                allocator_type * const allocator = _data.get_allocator();
+
+                std::destroy_at(this);
+                allocator->deallocate(this);
+            }
+
+            constexpr data_vector_type& data() noexcept { return _data; }
+            constexpr const data_vector_type& data() const noexcept { return _data; }
+    };
+}
+
+#endif // CCL_ECS_COMPONENT_HPP
@@ -0,0 +1,14 @@
+/**
+ * @file
+ *
+ * Entity component system.
+ */
+#ifndef CCL_ECS_HPP
+#define CCL_ECS_HPP
+
+#include <ccl/ecs/component.hpp>
+#include <ccl/ecs/archetype.hpp>
+#include <ccl/ecs/view.hpp>
+#include <ccl/ecs/registry.hpp>
+
+#endif // CCL_ECS_HPP
@@ -0,0 +1,471 @@
+/**
+ * @file
+ *
+ * ECS registry.
+ */
+#ifndef CCL_ECS_REGISTRY_HPP
+#define CCL_ECS_REGISTRY_HPP
+
+#include <array>
+#include <memory>
+#include <new>
+#include <utility>
+#include <ccl/api.hpp>
+#include <ccl/debug.hpp>
+#include <ccl/exceptions.hpp>
+#include <ccl/vector.hpp>
+#include <ccl/hashtable.hpp>
+#include <ccl/dense-map.hpp>
+#include <ccl/memory/allocator.hpp>
+#include <ccl/internal/optional-allocator.hpp>
+#include <ccl/ecs/component.hpp>
+#include <ccl/ecs/archetype.hpp>
+#include <ccl/ecs/view.hpp>
+
+namespace ccl::ecs {
+    /**
+     * Archetype-based entity registry.
+     *
+     * Entities with the same set of components share an archetype, which
+     * stores their components column-wise. Adding a component to, or
+     * removing one from, an entity moves it to another archetype. Archetypes
+     * are never destroyed, so that moving entities back and forth between
+     * two of them does not allocate.
+     *
+     * @tparam Allocator The allocator type.
+     */
+    template<typed_allocator<entity_t> Allocator = allocator>
+    class registry : ccl::internal::with_optional_allocator<Allocator> {
+        public:
+            using allocator_type = Allocator;
+            using archetype_type = archetype<allocator_type>;
+            using size_type = typename archetype_type::size_type;
+
+            template<typename ...C>
+            using view_type = view<archetype_type, C...>;
+
+        private:
+            using alloc = ccl::internal::with_optional_allocator<Allocator>;
+
+            struct entity_location {
+                archetype_type *archetype;
+                size_type row;
+            };
+
+            /**
+             * Key of an archetype in the archetype map. Archetypes are hashed
+             * by signature but compared by component set, so that component
+             * sets with the same signature get distinct archetypes.
+             */
+            struct archetype_key {
+                archetype_type *archetype;
+
+                friend constexpr bool operator ==(const archetype_key &a, const archetype_key &b) noexcept {
+                    return a.archetype == b.archetype;
+                }
+            };
+
+            /**
+             * Lookup key of the archetype of a set of components.
+             */
+            template<std::size_t N>
+            struct component_set_key {
+                std::array<component_id_t, N> ids;
+
+                friend constexpr bool operator ==(const archetype_key &a, const component_set_key &b) noexcept {
+                    if(a.archetype->component_count() != N) {
+                        return false;
+                    }
+
+                    for(const component_id_t id : b.ids) {
+                        if(!a.archetype->has_component(id)) {
+                            return false;
+                        }
+                    }
+
+                    return true;
+                }
+            };
+
+            /**
+             * Lookup key of the archetype with one component more or less
+             * than another.
+             */
+            struct adjacent_key {
+                const archetype_type *source;
+                component_id_t id;
+                bool is_adding;
+
+                friend constexpr bool operator ==(const archetype_key &a, const adjacent_key &b) noexcept {
+                    return b.is_adding ? a.archetype->extends(*b.source, b.id) : b.source->extends(*a.archetype, b.id);
+                }
+            };
+
+            struct archetype_hash {
+                using is_transparent = void;
+
+                constexpr hash_t operator()(const archetype_key &key) const noexcept {
+                    return key.archetype->signature();
+                }
+
+                template<std::size_t N>
+                constexpr hash_t operator()(const component_set_key<N> &key) const noexcept {
+                    component_id_t signature = 0;
+
+                    for(const component_id_t id : key.ids) {
+                        signature ^= id;
+                    }
+
+                    return signature;
+                }
+
+                constexpr hash_t operator()(const adjacent_key &key) const noexcept {
+                    return key.source->signature() ^ key.id;
+                }
+            };
+
+            /**
+             * Row being appended to an archetype. Unless committed, the row
+             * and any of its components are dropped on destruction, so that
+             * a throwing component constructor leaves the archetype unchanged.
+             */
+            class pending_row {
+                archetype_type &owner;
+                size_type row;
+                bool is_committed = false;
+
+                public:
+                    explicit constexpr pending_row(archetype_type &owner) noexcept
+                        : owner{owner}, row{owner.size()}
+                    {}
+
+                    pending_row(const pending_row&) = delete;
+                    pending_row& operator =(const pending_row&) = delete;
+
+                    constexpr ~pending_row() {
+                        if(!is_committed) {
+                            owner.truncate(row);
+                        }
+                    }
+
+                    constexpr size_type index() const noexcept { return row; }
+                    constexpr void commit() noexcept { is_committed = true; }
+            };
+
+            using archetype_vector_type = vector<archetype_type*, allocator_type>;
+            using archetype_map_type = hashtable<archetype_key, archetype_type*, archetype_hash, allocator_type>;
+            using entity_map_type = dense_map<entity_t, entity_location, hash<entity_t>, allocator_type>;
+
+            archetype_vector_type _archetypes; // The first archetype has no components
+            archetype_map_type archetype_map; // Archetypes by component set
+            entity_map_type entities;
+            entity_t next_entity = 0;
+            allocation_flags alloc_flags;
+
+        public:
+            explicit registry(
+                const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
+                allocator_type * const allocator = nullptr
+            ) : alloc{allocator},
+                _archetypes{alloc_flags, allocator},
+                archetype_map{alloc_flags, allocator},
+                entities{alloc_flags, allocator},
+                alloc_flags{alloc_flags}
+            {
+                add_archetype(create_archetype());
+            }
+
+            registry(const registry&) = delete;
+
+            registry(registry &&other)
+                : alloc{std::move(other)},
+                _archetypes{std::move(other._archetypes)},
+                archetype_map{std::move(other.archetype_map)},
+                entities{std::move(other.entities)},
+                next_entity{other.next_entity},
+                alloc_flags{other.alloc_flags}
+            {}
+
+            ~registry() {
+                destroy_archetypes();
+            }
+
+            registry& operator =(const registry&) = delete;
+
+            registry& operator =(registry &&other) {
+                if(this != &other) {
+                    destroy_archetypes();
+                    alloc::operator=(std::move(other));
+
+                    _archetypes = std::move(other._archetypes);
+                    archetype_map = std::move(other.archetype_map);
+                    entities = std::move(other.entities);
+                    next_entity = other.next_entity;
+                    alloc_flags = other.alloc_flags;
+                }
+
+                return *this;
+            }
+
+            /**
+             * Create an entity with a set of components.
+             *
+             * @tparam C The component types. Must be distinct.
+             * @param components The components of the entity.
+             *
+             * @return The new entity.
+             */
+            template<typename ...C>
+            requires (component<std::remove_cvref_t<C>> && ...)
+            entity_t create(C&& ...components) {
+                archetype_type &a = get_archetype<std::remove_cvref_t<C>...>();
+                const entity_t entity = next_entity;
+                pending_row row{a};
+
+                (a.template emplace_component<std::remove_cvref_t<C>>(std::forward<C>(components)), ...);
+                a.push_entity(entity);
+                entities.insert(entity, entity_location{&a, row.index()});
+                row.commit();
+                next_entity++;
+
+                return entity;
+            }
+
+            /**
+             * Destroy an entity and all of its components.
+             *
+             * @param entity The entity. Must be alive.
+             */
+            void destroy(const entity_t entity) {
+                entity_location &location = locate(entity);
+
+                fix_moved_entity(location.archetype->erase_row(location.row), location.row);
+                entities.erase(entity);
+            }
+
+            CCLNODISCARD bool is_alive(const entity_t entity) const {
+                return entities.contains(entity);
+            }
+
+            /**
+             * Add a component to an entity, or assign it if already present.
+             *
+             * @tparam C The component type.
+             * @param entity The entity. Must be alive.
+             * @param args The component constructor arguments.
+             *
+             * @return The component.
+             */
+            template<component C, typename ...Args>
+            C& add(const entity_t entity, Args&& ...args) {
+                entity_location &location = locate(entity);
+                archetype_type &source = *location.archetype;
+
+                if(source.template has_component<C>()) {
+                    C &value = source.template get_components<C>()[location.row];
+
+                    value = C(std::forward<Args>(args)...);
+
+                    return value;
+                }
+
+                archetype_type &destination = get_adjacent_archetype(source, component_id<C>, true, [] (archetype_type &a) {
+                    a.template add_column<C>();
+                });
+
+                // Constructed before moving the row, which moves the components
+                // the arguments may refer to. Nothing has moved yet if it throws.
+                pending_row row{destination};
+                C &value = destination.template emplace_component<C>(std::forward<Args>(args)...);
+
+                move_entity(location, destination);
+                row.commit();
+
+                return value;
+            }
+
+            /**
+             * Remove a component from an entity, if present.
+             *
+             * @tparam C The component type.
+             * @param entity The entity. Must be alive.
+             *
+             * @return True if the component was present, false otherwise.
+             */
+            template<component C>
+            bool remove(const entity_t entity) {
+                entity_location &location = locate(entity);
+                archetype_type &source = *location.archetype;
+
+                if(!source.template has_component<C>()) {
+                    return false;
+                }
+
+                archetype_type &destination = get_adjacent_archetype(source, component_id<C>, false, [] (archetype_type&) {});
+
+                move_entity(location, destination);
+
+                return true;
+            }
+
+            /**
+             * Get a component of an entity.
+             *
+             * If `CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS` is defined, an
+             * exception is thrown if the entity does not have the component.
+             *
+             * @tparam C The component type.
+             * @param entity The entity. Must be alive.
+             */
+            template<component C>
+            CCLNODISCARD C& get(const entity_t entity) {
+                const entity_location &location = locate(entity);
+
+                return location.archetype->template get_components<C>()[location.row];
+            }
+
+            template<component C>
+            CCLNODISCARD const C& get(const entity_t entity) const {
+                return const_cast<registry*>(this)->template get<C>(entity);
+            }
+
+            template<component C>
+            CCLNODISCARD bool has(const entity_t entity) const {
+                return const_cast<registry*>(this)->locate(entity).archetype->template has_component<C>();
+            }
+
+            /**
+             * Create a view over the entities having a set of components.
+             * The view is invalidated when a new archetype is created.
+             *
+             * @tparam C The component types. Const-qualified components are read-only.
+             */
+            template<typename ...C>
+            CCLNODISCARD view_type<C...> view() const {
+                return view_type<C...>{_archetypes};
+            }
+
+            /**
+             * Number of alive entities.
+             */
+            constexpr size_type size() const noexcept { return entities.size(); }
+            constexpr bool is_empty() const noexcept { return size() == 0; }
+
+            constexpr const archetype_vector_type& archetypes() const noexcept { return _archetypes; }
+
+            constexpr allocator_type* get_allocator() const noexcept { return alloc::get_allocator(); }
+            constexpr allocation_flags get_allocation_flags() const noexcept { return alloc_flags; }
+
+        private:
+            entity_location& locate(const entity_t entity) {
+                const auto it = entities.find(entity);
+
+                CCL_THROW_IF(it == entities.end(), std::invalid_argument{"Invalid entity."});
+
+                return *it->second;
+            }
+
+            /**
+             * Update the location of an entity moved by the removal of a row.
+             */
+            void fix_moved_entity(const entity_t moved_entity, const size_type row) {
+                if(moved_entity != invalid_entity) {
+                    entities.find(moved_entity)->second->row = row;
+                }
+            }
+
+            /**
+             * Move an entity to another archetype. The component missing from
+             * the entity archetype, if any, must already be emplaced.
+             */
+            void move_entity(entity_location &location, archetype_type &destination) {
+                const size_type row = destination.size();
+
+                fix_moved_entity(location.archetype->move_row(location.row, destination), location.row);
+
+                location.archetype = &destination;
+                location.row = row;
+            }
+
+            /**
+             * Get the archetype of a set of components, creating it if needed.
+             */
+            template<component ...C>
+            archetype_type& get_archetype() {
+                const auto it = archetype_map.find(component_set_key<sizeof...(C)>{ { component_id<C>... } });
+
+                if(it != archetype_map.end()) {
+                    return **it->second;
+                }
+
+                archetype_type * const new_archetype = create_archetype();
+
+                (new_archetype->template add_column<C>(), ...);
+                CCL_ASSERT(new_archetype->component_count() == sizeof...(C));
+
+                return add_archetype(new_archetype);
+            }
+
+            /**
+             * Get the archetype with one component more or less than another,
+             * creating it if needed.
+             *
+             * @param source The archetype to start from.
+             * @param id The component to add or remove.
+             * @param is_adding True if adding the component, false if removing it.
+             * @param add_column A function adding the new component column to
+             *  a new archetype, if adding.
+             */
+            template<typename AddColumn>
+            archetype_type& get_adjacent_archetype(
+                const archetype_type &source,
+                const component_id_t id,
+                const bool is_adding,
+                AddColumn&& add_column
+            ) {
+                const auto it = archetype_map.find(adjacent_key{&source, id, is_adding});
+
+                if(it != archetype_map.end()) {
+                    return **it->second;
+                }
+
+                archetype_type * const new_archetype = create_archetype();
+
+                if(is_adding) {
+                    new_archetype->add_columns_of(source);
+                    add_column(*new_archetype);
+                } else {
+                    new_archetype->add_columns_of(source, id);
+                }
+
+                return add_archetype(new_archetype);
+            }
+
+            archetype_type* create_archetype() {
+                allocator_type * const allocator = alloc::get_allocator();
+                archetype_type * const new_archetype = allocator->template allocate<archetype_type>(1, alloc_flags);
+
+                return ::new(static_cast<void*>(new_archetype)) archetype_type{alloc_flags, allocator};
+            }
+
+            archetype_type& add_archetype(archetype_type * const new_archetype) {
+                _archetypes.push_back(new_archetype);
+                archetype_map.insert(archetype_key{new_archetype}, new_archetype);
+
+                return *new_archetype;
+            }
+
+            void destroy_archetypes() noexcept {
+                allocator_type * const allocator = alloc::get_allocator();
+
+                for(archetype_type * const a : _archetypes) {
+                    std::destroy_at(a);
+                    allocator->deallocate(a);
+                }
+
+                _archetypes.destroy();
+            }
+    };
+}
+
+#endif // CCL_ECS_REGISTRY_HPP
@@ -0,0 +1,149 @@
+/**
+ * @file
+ *
+ * ECS view.
+ */
+#ifndef CCL_ECS_VIEW_HPP
+#define CCL_ECS_VIEW_HPP
+
+#include <array>
+#include <concepts>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <ccl/api.hpp>
+#include <ccl/definitions.hpp>
+#include <ccl/exceptions.hpp>
+#include <ccl/util.hpp>
+#include <ccl/ecs/component.hpp>
+
+namespace ccl::ecs {
+    /**
+     * View over the entities having a set of components.
+     *
+     * The view holds the archetypes matching the components when it is
+     * created, at most `CCL_ECS_VIEW_MAX_ARCHETYPE_COUNT`. Archetypes created
+     * afterwards are not part of the view. Entities are visited one archetype
+     * at a time, one column page at a time: all the components of the same
+     * type passed to a visitor are contiguous in memory.
+     *
+     * Adding entities to, or removing entities from, the viewed archetypes while
+     * visiting them is not allowed.
+     *
+     * @tparam Archetype The archetype type.
+     * @tparam C The component types. Const-qualified components are read-only.
+     */
+    template<typename Archetype, typename ...C>
+    requires (component<std::remove_const_t<C>> && ...)
+    class view {
+        public:
+            using archetype_type = Archetype;
+            using size_type = typename archetype_type::size_type;
+
+            static constexpr size_type max_archetype_count = CCL_ECS_VIEW_MAX_ARCHETYPE_COUNT;
+
+        private:
+            std::array<archetype_type*, max_archetype_count> _archetypes{};
+            size_type archetype_count = 0;
+
+        public:
+            /**
+             * Create a view over the matching archetypes of a range.
+             *
+             * @param archetypes The archetypes to match.
+             */
+            template<std::ranges::input_range InputRange>
+            requires std::convertible_to<std::ranges::range_value_t<InputRange>, archetype_type*>
+            explicit constexpr view(InputRange&& archetypes) {
+                for(archetype_type * const a : archetypes) {
+                    if((a->template has_component<std::remove_const_t<C>>() && ...)) {
+                        CCL_THROW_IF(archetype_count == max_archetype_count, std::out_of_range{"Too many archetypes in view."});
+
+                        _archetypes[archetype_count++] = a;
+                    }
+                }
+            }
+
+            /**
+             * Visit all the entities, one chunk of contiguous rows at a time.
+             *
+             * @param visitor A function invoked as `visitor(count, entities, components...)`,
+             *  with `count` the number of rows in the chunk, `entities` a pointer to
+             *  the entity IDs and `components` one pointer to each component type,
+             *  in the order of the view.
+             */
+            template<typename Visitor>
+            constexpr void for_each_chunk(Visitor&& visitor) const {
+                constexpr size_type page_size = archetype_type::entity_vector_type::page_size;
+
+                for(size_type i = 0; i < archetype_count; ++i) {
+                    archetype_type &a = *_archetypes[i];
+
+                    const auto entity_pages = a.entities().pages();
+                    const std::tuple column_pages{ a.template get_components<std::remove_const_t<C>>().pages()... };
+                    size_type remaining = a.size();
+
+                    for(size_type page = 0; remaining; ++page) {
+                        const size_type count = min(remaining, page_size);
+
+                        std::apply(
+                            [&visitor, &entity_pages, count, page] (const auto& ...pages) {
+                                visitor(
+                                    count,
+                                    static_cast<const entity_t*>(entity_pages[page]),
+                                    static_cast<C*>(pages[page])...
+                                );
+                            },
+                            column_pages
+                        );
+
+                        remaining -= count;
+                    }
+                }
+            }
+
+            /**
+             * Visit all the entities.
+             *
+             * @param visitor A function invoked as `visitor(components...)` or
+             *  `visitor(entity, components...)`, with `components` one reference
+             *  to each component type, in the order of the view.
+             */
+            template<typename Visitor>
+            constexpr void for_each(Visitor&& visitor) const {
+                for_each_chunk(
+                    [&visitor] (const size_type count, const entity_t * const entities, C * const ...components) {
+                        for(size_type i = 0; i < count; ++i) {
+                            if constexpr(std::invocable<Visitor&, entity_t, C&...>) {
+                                visitor(entities[i], components[i]...);
+                            } else {
+                                visitor(components[i]...);
+                            }
+                        }
+                    }
+                );
+            }
+
+            /**
+             * Number of entities in the view.
+             */
+            constexpr size_type size() const noexcept {
+                size_type count = 0;
+
+                for(size_type i = 0; i < archetype_count; ++i) {
+                    count += _archetypes[i]->size();
+                }
+
+                return count;
+            }
+
+            constexpr bool is_empty() const noexcept { return size() == 0; }
+
+            constexpr std::span<archetype_type * const> archetypes() const noexcept {
+                return { _archetypes.data(), archetype_count };
+            }
+    };
+}
+
+#endif // CCL_ECS_VIEW_HPP
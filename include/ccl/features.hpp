@@ -30,4 +30,14 @@
     #define CCL_FEATURE_DEFAULT_ALLOCATION_FLAGS
 #endif // CCL_OVERRIDE_FEATURE_DEFAULT_ALLOCATION_FLAGS
 
+#ifndef CCL_OVERRIDE_FEATURE_SIMD
+    #define CCL_FEATURE_SIMD
+#endif // CCL_OVERRIDE_FEATURE_SIMD
+
+// Opt-in features: disabled unless enabled.
+
+#ifdef CCL_ENABLE_FEATURE_HASH_STATS
+    #define CCL_FEATURE_HASH_STATS
+#endif // CCL_ENABLE_FEATURE_HASH_STATS
+
 #endif // CCL_FEATURES_HPP
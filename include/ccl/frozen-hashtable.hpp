@@ -0,0 +1,382 @@
+/**
+ * @file
+ *
+ * Read-only hash table over a serialized image.
+ */
+#ifndef CCL_FROZEN_HASHTABLE_HPP
+#define CCL_FROZEN_HASHTABLE_HPP
+
+#include <bit>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <ccl/api.hpp>
+#include <ccl/debug.hpp>
+#include <ccl/exceptions.hpp>
+#include <ccl/hash.hpp>
+#include <ccl/util.hpp>
+#include <ccl/internal/control-group.hpp>
+
+namespace ccl {
+    /**
+     * Header of a frozen hash table image. All offsets are relative to
+     * the first byte of the image, so that the image can be loaded at
+     * any address.
+     */
+    struct frozen_hashtable_header {
+        static constexpr uint32_t expected_magic = 0x46434343; // "CCCF" in little endian
+        static constexpr uint32_t expected_version = 1;
+
+        uint32_t magic;
+        uint32_t version;
+        uint32_t key_size;
+        uint32_t key_alignment;
+        uint32_t value_size;
+        uint32_t value_alignment;
+        uint32_t capacity;
+        uint32_t size;
+        uint64_t control_offset;
+        uint64_t key_offset;
+        uint64_t value_offset;
+        uint64_t image_size;
+    };
+
+    /**
+     * A read-only hash table whose slots live in an external binary image,
+     * typically a memory-mapped file. Looking up a key in the image requires
+     * no deserialization: loading a table is as cheap as mapping its image.
+     *
+     * Images are written by `freeze()` from any hashtable or dense map
+     * with the same key and value types. Slots are open-addressed and
+     * probed linearly, one control group at a time, like those of a
+     * `hashtable`. The image embeds no pointers, but it is written with
+     * the native byte order and type layout, and the hash function must
+     * yield the same hashes in the writer and the readers.
+     *
+     * @tparam K The key type.
+     * @tparam V The value type.
+     * @tparam HashFunction The hash function type.
+     */
+    template<
+        typename K,
+        typename V,
+        typed_hash_function<K> HashFunction = hash<K>
+    > requires std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>
+    class frozen_hashtable {
+        public:
+            using key_type = K;
+            using value_type = V;
+            using hash_function_type = HashFunction;
+            using size_type = count_t;
+            using const_key_reference = const K&;
+            using const_value_reference = const V&;
+            using const_value_pointer = const V*;
+            using header_type = frozen_hashtable_header;
+
+            /**
+             * Minimum alignment of the first byte of an image.
+             */
+            static constexpr std::size_t image_alignment = max(alignof(header_type), alignof(K), alignof(V));
+
+            /**
+             * Minimum number of slots of an image.
+             */
+            static constexpr size_type minimum_capacity = 32;
+
+            /**
+             * Number of control bytes cloned past the last slot, letting
+             * control groups of any supported width be loaded at any slot.
+             */
+            static constexpr size_type control_padding = 31;
+
+            static_assert(internal::control_group::width <= control_padding + 1);
+
+        private:
+            const internal::control_byte *control = nullptr;
+            const K *keys = nullptr;
+            const V *values = nullptr;
+            size_type _capacity = 0;
+            size_type _size = 0;
+
+        public:
+            /**
+             * Initialise an empty table.
+             */
+            constexpr frozen_hashtable() = default;
+
+            /**
+             * Initialise a table over an image. The image is not copied and
+             * must outlive the table.
+             *
+             * @param image The image, as written by `freeze()`. Must be aligned
+             *  to `image_alignment`.
+             */
+            explicit frozen_hashtable(const std::span<const std::byte> image) {
+                if(!is_valid_image(image)) {
+                    CCL_THROW(std::invalid_argument{"Invalid frozen hashtable image."});
+
+                    return;
+                }
+
+                const header_type header = read_header(image);
+
+                control = reinterpret_cast<const internal::control_byte*>(image.data() + header.control_offset);
+                keys = reinterpret_cast<const K*>(image.data() + header.key_offset);
+                values = reinterpret_cast<const V*>(image.data() + header.value_offset);
+                _capacity = header.capacity;
+                _size = header.size;
+            }
+
+            /**
+             * Compute the number of slots of an image.
+             *
+             * @param item_count The number of items in the image.
+             */
+            static constexpr size_type image_capacity(const size_type item_count) noexcept {
+                // Keep the load factor below 7/8 and at least one slot empty,
+                // so that every probe ends.
+                return max(
+                    minimum_capacity,
+                    std::bit_ceil(static_cast<size_type>(item_count + item_count / 7 + 1))
+                );
+            }
+
+            /**
+             * Compute the size of an image.
+             *
+             * @param item_count The number of items in the image.
+             *
+             * @return The image size, in bytes.
+             */
+            static constexpr std::size_t image_size(const size_type item_count) noexcept {
+                return make_header(item_count).image_size;
+            }
+
+            /**
+             * Compute the size of the image of a map.
+             *
+             * @param map A hashtable or dense map.
+             *
+             * @return The image size, in bytes.
+             */
+            template<typename Map>
+            static constexpr std::size_t image_size(const Map &map) noexcept {
+                return image_size(static_cast<size_type>(map.size()));
+            }
+
+            /**
+             * Write the image of a map.
+             *
+             * @param map A hashtable or dense map, whose iterators yield pairs of key and
+             *  value pointers.
+             * @param image The output image. Must be aligned to `image_alignment` and at
+             *  least `image_size(map)` bytes long.
+             *
+             * @return The number of bytes written.
+             */
+            template<typename Map>
+            static std::size_t freeze(const Map &map, const std::span<std::byte> image) {
+                const header_type header = make_header(static_cast<size_type>(map.size()));
+
+                CCL_THROW_IF(image.size() < header.image_size, std::invalid_argument{"Image too small."});
+                CCL_THROW_IF(!is_aligned(image.data()), std::invalid_argument{"Image not aligned."});
+
+                std::byte * const data = image.data();
+                internal::control_byte * const out_control = reinterpret_cast<internal::control_byte*>(data + header.control_offset);
+                const size_type capacity = header.capacity;
+
+                std::memset(data, 0, header.image_size);
+                std::memcpy(data, &header, sizeof(header));
+
+                for(const auto item : map) {
+                    const hash_t key_hash = HashFunction{}(*item.first);
+                    size_type i = home_index(key_hash, capacity);
+
+                    while(internal::is_control_full(out_control[i])) {
+                        i = wrap_index(i + 1, capacity);
+                    }
+
+                    out_control[i] = internal::make_control_byte(key_hash);
+                    std::memcpy(data + header.key_offset + i * sizeof(K), item.first, sizeof(K));
+                    std::memcpy(data + header.value_offset + i * sizeof(V), item.second, sizeof(V));
+                }
+
+                for(size_type i = 0; i < control_padding; ++i) {
+                    out_control[capacity + i] = out_control[wrap_index(i, capacity)];
+                }
+
+                return header.image_size;
+            }
+
+            /**
+             * Check whether an image can be read as a table of this type.
+             *
+             * @param image The image.
+             */
+            static bool is_valid_image(const std::span<const std::byte> image) noexcept {
+                if(image.size() < sizeof(header_type) || !is_aligned(image.data())) {
+                    return false;
+                }
+
+                const header_type header = read_header(image);
+
+                return header.magic == header_type::expected_magic
+                    && header.version == header_type::expected_version
+                    && header.key_size == sizeof(K)
+                    && header.key_alignment == alignof(K)
+                    && header.value_size == sizeof(V)
+                    && header.value_alignment == alignof(V)
+                    && header.capacity >= minimum_capacity
+                    && is_power_2(header.capacity)
+                    && header.size < header.capacity
+                    && header.image_size <= image.size()
+                    && is_in_image(header.control_offset, static_cast<uint64_t>(header.capacity) + control_padding, 1, header.image_size)
+                    && is_in_image(header.key_offset, header.capacity, sizeof(K), header.image_size)
+                    && is_in_image(header.value_offset, header.capacity, sizeof(V), header.image_size)
+                    && header.key_offset % alignof(K) == 0
+                    && header.value_offset % alignof(V) == 0;
+            }
+
+            /**
+             * Look up a key.
+             *
+             * @param key The key.
+             *
+             * @return A pointer to the value of the key within the image, or
+             *  nullptr if the key is not present.
+             */
+            CCLNODISCARD const_value_pointer find(const_key_reference key) const noexcept {
+                if(!_capacity) {
+                    return nullptr;
+                }
+
+                const hash_t key_hash = HashFunction{}(key);
+                const internal::control_byte tag = internal::make_control_byte(key_hash);
+
+                // Valid images always have an empty slot; corrupt ones may not.
+                const size_type max_group_count = _capacity / internal::control_group::width + 1;
+                size_type index = home_index(key_hash, _capacity);
+
+                for(size_type g = 0; g < max_group_count; ++g, index = wrap_index(index + internal::control_group::width, _capacity)) {
+                    const internal::control_group group{control + index};
+
+                    for(auto matches = group.match(tag); matches; matches.clear_lowest()) {
+                        const size_type i = wrap_index(index + matches.lowest(), _capacity);
+
+                        if(keys[i] == key) {
+                            return &values[i];
+                        }
+                    }
+
+                    if(group.match_empty()) {
+                        return nullptr;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            CCLNODISCARD bool contains(const_key_reference key) const noexcept {
+                return find(key) != nullptr;
+            }
+
+            /**
+             * Get the value of a key.
+             *
+             * @param key The key. Must be present.
+             */
+            CCLNODISCARD const_value_reference at(const_key_reference key) const {
+                const const_value_pointer value = find(key);
+
+                CCL_THROW_IF(!value, std::out_of_range{"Key not present."});
+
+                return *value;
+            }
+
+            /**
+             * Visit all the key-value pairs, in slot order.
+             *
+             * @param visitor A function invoked as `visitor(const K&, const V&)`.
+             */
+            template<typename Visitor>
+            void for_each(Visitor&& visitor) const {
+                for(size_type i = 0; i < _capacity; ++i) {
+                    if(internal::is_control_full(control[i])) {
+                        visitor(keys[i], values[i]);
+                    }
+                }
+            }
+
+            constexpr size_type size() const noexcept { return _size; }
+            constexpr size_type capacity() const noexcept { return _capacity; }
+            constexpr bool is_empty() const noexcept { return _size == 0; }
+
+        private:
+            static constexpr header_type make_header(const size_type item_count) noexcept {
+                header_type header{};
+                const size_type capacity = image_capacity(item_count);
+
+                header.magic = header_type::expected_magic;
+                header.version = header_type::expected_version;
+                header.key_size = sizeof(K);
+                header.key_alignment = alignof(K);
+                header.value_size = sizeof(V);
+                header.value_alignment = alignof(V);
+                header.capacity = capacity;
+                header.size = item_count;
+                header.control_offset = sizeof(header_type);
+                header.key_offset = align_size(header.control_offset + capacity + control_padding, alignof(K));
+                header.value_offset = align_size(header.key_offset + capacity * sizeof(K), alignof(V));
+                header.image_size = align_size(header.value_offset + capacity * sizeof(V), image_alignment);
+
+                return header;
+            }
+
+            static header_type read_header(const std::span<const std::byte> image) noexcept {
+                header_type header;
+
+                std::memcpy(&header, image.data(), sizeof(header));
+
+                return header;
+            }
+
+            /**
+             * Check whether an array lies within an image, without overflowing.
+             *
+             * @param offset The array offset.
+             * @param count The number of items in the array.
+             * @param item_size The size of an item.
+             * @param image_size The image size.
+             */
+            static constexpr bool is_in_image(
+                const uint64_t offset,
+                const uint64_t count,
+                const uint64_t item_size,
+                const uint64_t image_size
+            ) noexcept {
+                return offset <= image_size && count <= (image_size - offset) / item_size;
+            }
+
+            static bool is_aligned(const void * const address) noexcept {
+                return reinterpret_cast<std::uintptr_t>(address) % image_alignment == 0;
+            }
+
+            static constexpr size_type wrap_index(const size_type index, const size_type capacity) noexcept {
+                return index & (capacity - 1);
+            }
+
+            /**
+             * First slot probed for a hash. Same as in `hashtable`.
+             */
+            static constexpr size_type home_index(const hash_t key_hash, const size_type capacity) noexcept {
+                const unsigned capacity_bits = static_cast<unsigned>(std::countr_zero(capacity));
+
+                return wrap_index(
+                    static_cast<size_type>(internal::mix_hash(key_hash) >> (internal::control_hash_shift - capacity_bits)),
+                    capacity
+                );
+            }
+    };
+}
+
+#endif // CCL_FROZEN_HASHTABLE_HPP
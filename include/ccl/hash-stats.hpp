@@ -0,0 +1,207 @@
+/**
+ * @file
+ *
+ * Hash container statistics.
+ */
+#ifndef CCL_HASH_STATS_HPP
+#define CCL_HASH_STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <ccl/api.hpp>
+#include <ccl/util.hpp>
+
+namespace ccl {
+    /**
+     * Occupancy and event statistics of a hash container, as returned by
+     * `get_stats()`. Only available when the `CCL_FEATURE_HASH_STATS`
+     * feature is enabled.
+     *
+     * Events are counted from the construction of the container, or from
+     * the last call to `reset_stats()`. Statistics are recorded by lookups
+     * as well, with relaxed atomic operations so that containers read by
+     * multiple threads at once can record them too.
+     */
+    struct hash_stats {
+        /**
+         * Number of slots, overflow slots excluded.
+         */
+        count_t capacity = 0;
+
+        /**
+         * Number of items.
+         */
+        count_t size = 0;
+
+        /**
+         * Number of items held in overflow slots.
+         */
+        count_t overflow_size = 0;
+
+        /**
+         * Number of consecutive slots probed for a key.
+         */
+        count_t chunk_size = 0;
+
+        /**
+         * Number of times all the items were moved to new slots.
+         */
+        count_t rehash_count = 0;
+
+        /**
+         * Number of times the chunk size was doubled.
+         */
+        count_t chunk_growth_count = 0;
+
+        /**
+         * Number of times a key was placed while its chunk was full.
+         */
+        count_t failed_chunk_count = 0;
+
+        /**
+         * Bytes of keys, values and hashes moved to new slots.
+         */
+        std::size_t bytes_moved = 0;
+
+        /**
+         * Number of probes, one per lookup or insertion.
+         */
+        std::size_t probe_count = 0;
+
+        /**
+         * Number of slots inspected by all the probes.
+         */
+        std::size_t total_probe_length = 0;
+
+        /**
+         * Number of slots inspected by the longest probe.
+         */
+        count_t max_probe_length = 0;
+
+        constexpr double load_factor() const noexcept {
+            return capacity ? static_cast<double>(size) / capacity : 0.0;
+        }
+
+        constexpr double mean_probe_length() const noexcept {
+            return probe_count ? static_cast<double>(total_probe_length) / probe_count : 0.0;
+        }
+    };
+}
+
+namespace ccl::internal {
+    /**
+     * Event counters of a hash container. Every operation is a no-op and
+     * the recorder is empty unless the `CCL_FEATURE_HASH_STATS` feature is
+     * enabled.
+     *
+     * Recording is thread safe: counters are updated with relaxed atomic
+     * operations, as const lookups record probes. Reading the events while
+     * they are recorded yields each counter as of some recent time.
+     */
+    class hash_stats_recorder {
+#ifdef CCL_FEATURE_HASH_STATS
+        hash_stats events;
+#endif // CCL_FEATURE_HASH_STATS
+
+        public:
+#ifdef CCL_FEATURE_HASH_STATS
+            static constexpr bool enabled = true;
+#else // CCL_FEATURE_HASH_STATS
+            static constexpr bool enabled = false;
+#endif // CCL_FEATURE_HASH_STATS
+
+            constexpr void record_rehash(const std::size_t bytes_moved CCLUNUSED) noexcept {
+#ifdef CCL_FEATURE_HASH_STATS
+                add(events.rehash_count, 1u);
+                add(events.bytes_moved, bytes_moved);
+#endif // CCL_FEATURE_HASH_STATS
+            }
+
+            constexpr void record_move(const std::size_t bytes_moved CCLUNUSED) noexcept {
+#ifdef CCL_FEATURE_HASH_STATS
+                add(events.bytes_moved, bytes_moved);
+#endif // CCL_FEATURE_HASH_STATS
+            }
+
+            constexpr void record_chunk_growth() noexcept {
+#ifdef CCL_FEATURE_HASH_STATS
+                add(events.chunk_growth_count, 1u);
+#endif // CCL_FEATURE_HASH_STATS
+            }
+
+            constexpr void record_failed_chunk() noexcept {
+#ifdef CCL_FEATURE_HASH_STATS
+                add(events.failed_chunk_count, 1u);
+#endif // CCL_FEATURE_HASH_STATS
+            }
+
+            constexpr void record_probe(const count_t length CCLUNUSED) noexcept {
+#ifdef CCL_FEATURE_HASH_STATS
+                add(events.probe_count, std::size_t{1});
+                add(events.total_probe_length, static_cast<std::size_t>(length));
+                raise(events.max_probe_length, length);
+#endif // CCL_FEATURE_HASH_STATS
+            }
+
+            /**
+             * Forget all the events. Must not be called while recording.
+             */
+            constexpr void reset() noexcept {
+#ifdef CCL_FEATURE_HASH_STATS
+                events = hash_stats{};
+#endif // CCL_FEATURE_HASH_STATS
+            }
+
+#ifdef CCL_FEATURE_HASH_STATS
+            /**
+             * Get the recorded events. Occupancy is left to the container.
+             */
+            constexpr hash_stats get() const noexcept {
+                hash_stats result;
+
+                result.rehash_count = load(events.rehash_count);
+                result.chunk_growth_count = load(events.chunk_growth_count);
+                result.failed_chunk_count = load(events.failed_chunk_count);
+                result.bytes_moved = load(events.bytes_moved);
+                result.probe_count = load(events.probe_count);
+                result.total_probe_length = load(events.total_probe_length);
+                result.max_probe_length = load(events.max_probe_length);
+
+                return result;
+            }
+
+        private:
+            template<typename T>
+            static constexpr void add(T &counter, const T value) noexcept {
+                if consteval {
+                    counter += value;
+                } else {
+                    std::atomic_ref<T>{counter}.fetch_add(value, std::memory_order_relaxed);
+                }
+            }
+
+            template<typename T>
+            static constexpr void raise(T &counter, const T value) noexcept {
+                if consteval {
+                    counter = max(counter, value);
+                } else {
+                    std::atomic_ref<T> ref{counter};
+                    T current = ref.load(std::memory_order_relaxed);
+
+                    while(current < value && !ref.compare_exchange_weak(current, value, std::memory_order_relaxed));
+                }
+            }
+
+            template<typename T>
+            static constexpr T load(const T &counter) noexcept {
+                if consteval {
+                    return counter;
+                } else {
+                    return std::atomic_ref<T>{const_cast<T&>(counter)}.load(std::memory_order_relaxed);
+                }
+            }
+#endif // CCL_FEATURE_HASH_STATS
+    };
+}
+
+#endif // CCL_HASH_STATS_HPP
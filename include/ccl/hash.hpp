@@ -6,6 +6,9 @@
 #ifndef CCL_HASH_HPP
 #define CCL_HASH_HPP
 
+#include <bit>
+#include <string_view>
+#include <type_traits>
 #include <ccl/api.hpp>
 #include <ccl/concepts.hpp>
 
@@ -184,6 +187,87 @@ namespace ccl {
     concept typed_hash_function = requires(Function f, T object) {
         { f(object) } -> std::convertible_to<hash_t>;
     };
+
+    /**
+     * A hash function capable of hashing, besides `T`, other types
+     * comparable to it, as marked by an `is_transparent` member type.
+     * Equal objects must hash to the same value regardless of their type.
+     *
+     * @tparam Function The function type.
+     * @tparam T The hashable type.
+     * @tparam Q The other type to hash.
+     */
+    template<typename Function, typename T, typename Q>
+    concept transparent_hash_function = typed_hash_function<Function, T>
+        && typed_hash_function<Function, Q>
+        && requires {
+            typename Function::is_transparent;
+        };
+
+    /**
+     * A type usable to look up keys of type `K` without constructing a `K`.
+     *
+     * @tparam Q The lookup type.
+     * @tparam K The key type.
+     * @tparam HashFunction The function used to compute the key hashes.
+     */
+    template<typename Q, typename K, typename HashFunction>
+    concept transparent_key = transparent_hash_function<HashFunction, K, Q>
+        && requires(const K& key, const Q& other) {
+            { key == other } -> std::convertible_to<bool>;
+        };
+
+    /**
+     * Transparent string hash function.
+     *
+     * Hashes any sequence of characters convertible to a string view, such
+     * as string objects, string views, pointer and length pairs (via a string
+     * view) and nul-terminated strings. The resulting hash is the same as
+     * the one of an equal `basic_string`.
+     *
+     * @tparam CharType The character type.
+     */
+    template<typename CharType = char>
+    struct string_hash {
+        using is_transparent = void;
+
+        constexpr hash_t operator()(const std::basic_string_view<CharType> str) const noexcept {
+            if(std::is_constant_evaluated()) {
+                return hash_constant(str);
+            }
+
+            return fnv1a_hash(
+                str.length() * sizeof(CharType),
+                reinterpret_cast<const uint8_t*>(str.data())
+            );
+        }
+
+        private:
+            /**
+             * Hash a string in a constant expression, where its bytes cannot
+             * be accessed directly. Bytes are visited in memory order.
+             */
+            static constexpr hash_t hash_constant(const std::basic_string_view<CharType> str) noexcept {
+                using unsigned_char_type = std::make_unsigned_t<CharType>;
+
+                hash_t result = fnv1a_basis;
+
+                for(const CharType c : str) {
+                    const auto bits = static_cast<unsigned_char_type>(c);
+
+                    for(std::size_t i = 0; i < sizeof(CharType); ++i) {
+                        const std::size_t byte_index = std::endian::native == std::endian::little
+                            ? i
+                            : sizeof(CharType) - 1 - i;
+
+                        result ^= static_cast<uint8_t>(bits >> (byte_index * 8));
+                        result *= fnv1a_prime;
+                    }
+                }
+
+                return result;
+            }
+    };
 }
 
 #endif // CCL_HASH_HPP
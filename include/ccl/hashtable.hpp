@@ -7,7 +7,10 @@
 #define CCL_HASHTABLE_HPP
 
 #include <algorithm>
+#include <bit>
 #include <cstring>
+#include <ranges>
+#include <span>
 #include <ccl/api.hpp>
 #include <ccl/definitions.hpp>
 #include <ccl/memory/allocator.hpp>
@@ -15,8 +18,9 @@
 #include <ccl/debug.hpp>
 #include <ccl/compressed-pair.hpp>
 #include <ccl/hash.hpp>
+#include <ccl/hash-stats.hpp>
 #include <ccl/util.hpp>
-#include <ccl/bitset.hpp>
+#include <ccl/internal/control-group.hpp>
 #include <ccl/internal/optional-allocator.hpp>
 #include <ccl/pair.hpp>
 
@@ -51,11 +55,7 @@ namespace ccl {
         explicit constexpr hashtable_iterator(hashtable_type& hashtable, const size_type item_index) noexcept : hashtable{&hashtable}, index{item_index} {
             // Ensure we are actually pointing at an existing value or at the end.
             // Useful for `begin()` iterators.
-            for(; index < hashtable._capacity; ++index) {
-                if(hashtable.slot_map[index]) {
-                    return;
-                }
-            }
+            index = hashtable.next_full_slot(index);
         }
 
         constexpr hashtable_iterator(const hashtable_iterator &other) noexcept : hashtable{other.hashtable}, index{other.index} {}
@@ -67,18 +67,16 @@ namespace ccl {
             return *this;
         }
 
-        constexpr const key_value_pair operator*() const noexcept { return key_value_pair{ &hashtable->keys[index], &hashtable->values[index] }; }
+        constexpr const key_value_pair operator*() const noexcept { return key_value_pair{ &hashtable->slot_key(index), &hashtable->slot_value(index) }; }
 
         constexpr const key_value_pair* operator->() const noexcept {
-            pair = key_value_pair{ &hashtable->keys[index], &hashtable->values[index] };
+            pair = key_value_pair{ &hashtable->slot_key(index), &hashtable->slot_value(index) };
 
             return &pair;
         }
 
         constexpr auto& operator --() noexcept {
-            do {
-                index--;
-            } while(!hashtable->slot_map[index]);
+            index = hashtable->prev_full_slot(index);
 
             return *this;
         }
@@ -86,19 +84,13 @@ namespace ccl {
         constexpr auto operator --(int) noexcept {
             const size_type old_index = this->index;
 
-            do {
-                if(index == 0) {
-                    break;
-                }
-
-                index--;
-            } while(!hashtable->slot_map[index]);
+            index = hashtable->prev_full_slot(index);
 
             return hashtable_iterator{*hashtable, old_index};
         }
 
         constexpr auto& operator ++() noexcept {
-            for(index += 1; index < hashtable->_capacity && !hashtable->slot_map[index]; ++index);
+            index = hashtable->next_full_slot(index + 1);
 
             return *this;
         }
@@ -106,7 +98,7 @@ namespace ccl {
         constexpr auto operator ++(int) noexcept {
             const size_type old_index = this->index;
 
-            for(index += 1; index < hashtable->_capacity && !hashtable->slot_map[index]; ++index);
+            index = hashtable->next_full_slot(index + 1);
 
             return hashtable_iterator{*hashtable, old_index};
         }
@@ -154,19 +146,107 @@ namespace ccl {
         return a.index <= b.index;
     }
 
+    /**
+     * Default hashtable policy. Derive from this type to override
+     * individual settings.
+     */
+    struct default_hashtable_policy {
+        /**
+         * Capacity of the first slots allocated. Must be a power of two.
+         */
+        static constexpr count_t minimum_capacity = CCL_HASHTABLE_MINIMUM_CAPACITY;
+
+        /**
+         * Minimum number of slots probed for a key before resorting to the
+         * stash. Chunks are made longer when the keys are small enough to
+         * fit more of them in a cache line. Must be a power of two.
+         */
+        static constexpr count_t minimum_chunk_size = CCL_HASHTABLE_MINIMUM_CHUNK_SIZE;
+
+        /**
+         * Fraction of the capacity that can be occupied before growing.
+         */
+        static constexpr float max_load_factor = CCL_HASHTABLE_MAX_LOAD_FACTOR;
+
+        /**
+         * Factor the capacity is multiplied by when growing. Must be a
+         * power of two, greater than 1.
+         */
+        static constexpr count_t growth_factor = 2;
+
+        /**
+         * Store the full hash of every key beside it. This costs
+         * `sizeof(hash_t)` bytes per slot, but hashes are never
+         * recomputed while rehashing and most mismatching keys are
+         * rejected without being compared.
+         */
+        static constexpr bool store_hashes = false;
+
+        /**
+         * Store each key and its value side by side in a single array,
+         * rather than in separate key and value arrays. Finding a small
+         * item then touches a single cache line beyond the control bytes,
+         * while separate arrays keep the keys densely packed when the
+         * values are large.
+         */
+        static constexpr bool interleave_items = false;
+
+        /**
+         * Grow incrementally. Rather than moving all the items at once when
+         * the table grows, the previous slots are kept alongside the new
+         * ones and migrated a few at a time by the following insertions.
+         * Lookups search both sets of slots in the meantime.
+         */
+        static constexpr bool incremental_rehash = false;
+
+        /**
+         * Number of previous slots migrated by each insertion while
+         * growing incrementally.
+         */
+        static constexpr count_t incremental_rehash_step = 16;
+
+        /**
+         * Clear in constant time. Every slot is stamped with the generation
+         * it was filled in, and clearing starts a new generation: the slots
+         * of the previous ones then read as empty, without being touched.
+         * This costs a byte per slot, and requires trivially destructible
+         * keys and values since the cleared items are never destroyed.
+         */
+        static constexpr bool generational_clear = false;
+
+        /**
+         * Low watermark of the load factor. Erasing a key by value shrinks
+         * the table as by `shrink_to_fit()` once its load factor falls below
+         * this value. Must stay below half the maximum load factor, so that
+         * shrinking and growing back do not alternate. 0 never shrinks.
+         */
+        static constexpr float shrink_load_factor = 0.0f;
+    };
+
     /**
      * An open-addressed hash table.
      *
+     * Each slot is described by a control byte holding its occupancy and
+     * a fragment of the key hash. Chunks of control bytes are matched in
+     * groups, so that keys are only compared for slots whose hash
+     * fragment matches.
+     *
+     * Keys whose chunk is full are kept in a small overflow stash. The
+     * capacity only grows when the load factor exceeds its maximum, while
+     * the chunks are lengthened when the stash overflows as well.
+     *
      * @tparam K Key type.
      * @tparam V Value type.
      * @tparam HashFunction The function used to compute the key hashes.
      * @tparam Allocator The allocator type.
+     * @tparam Policy The hashtable policy.
      */
     template<
         std::equality_comparable K,
         typename V,
         typed_hash_function<K> HashFunction = hash<K>,
-        typename Allocator = allocator
+        typename Allocator = allocator,
+        typename Policy = default_hashtable_policy
     >
     requires typed_allocator<Allocator, K> && typed_allocator<Allocator, V>
     class hashtable : private internal::with_optional_allocator<Allocator> {
@@ -174,6 +254,8 @@ namespace ccl {
         friend struct hashtable_iterator<const hashtable>;
 
         using alloc = internal::with_optional_allocator<Allocator>;
+        using control_byte = internal::control_byte;
+        using control_group = internal::control_group;
 
         public:
             using size_type = count_t;
@@ -193,49 +275,200 @@ namespace ccl {
             using const_value_reference = const V&;
 
             using allocator_type = Allocator;
+            using policy_type = Policy;
 
             using iterator = hashtable_iterator<hashtable>;
             using const_iterator = hashtable_iterator<const hashtable>;
 
-            static constexpr size_type minimum_capacity = CCL_HASHTABLE_MINIMUM_CAPACITY;
+            static constexpr size_type minimum_capacity = policy_type::minimum_capacity;
+            static constexpr size_type minimum_chunk_size = policy_type::minimum_chunk_size;
+            static constexpr size_type growth_factor = policy_type::growth_factor;
+            static constexpr bool store_hashes = policy_type::store_hashes;
+            static constexpr bool interleave_items = policy_type::interleave_items;
+            static constexpr bool incremental_rehash = policy_type::incremental_rehash;
+            static constexpr size_type incremental_rehash_step = policy_type::incremental_rehash_step;
+            static constexpr bool generational_clear = policy_type::generational_clear;
+            static constexpr float shrink_load_factor = policy_type::shrink_load_factor;
+            static constexpr size_type batch_size = CCL_HASH_BATCH_SIZE;
+            static constexpr size_type stash_size = CCL_HASHTABLE_STASH_SIZE;
+            static constexpr float max_load_factor = policy_type::max_load_factor;
+
+            static_assert(minimum_capacity > 0 && is_power_2(minimum_capacity), "Minimum capacity must be a power of two.");
+            static_assert(minimum_chunk_size > 0 && is_power_2(minimum_chunk_size), "Minimum chunk size must be a power of two.");
+            static_assert(growth_factor > 1 && is_power_2(growth_factor), "Growth factor must be a power of two greater than 1.");
+            static_assert(max_load_factor > 0 && max_load_factor < 1, "Maximum load factor must be between 0 and 1.");
+            static_assert(
+                shrink_load_factor >= 0 && shrink_load_factor < max_load_factor / 2,
+                "Shrink load factor must be between 0 and half the maximum load factor."
+            );
+            static_assert(
+                !generational_clear || (std::is_trivially_destructible_v<K> && std::is_trivially_destructible_v<V>),
+                "Clearing by generation requires trivially destructible keys and values."
+            );
 
             static constexpr size_type default_chunk_size = min(
                 minimum_capacity,
-                max<size_type>(
-                    CCL_HASHTABLE_MINIMUM_CHUNK_SIZE,
-                    1u << (
+                max(
+                    minimum_chunk_size,
+                    static_cast<size_type>(1u << (
                         bitcount(std::hardware_constructive_interference_size / sizeof(K))
                         + (std::hardware_constructive_interference_size % sizeof(K) > 0)
                         - 1
-                    )
+                    ))
                 )
             );
 
+        private:
+            /**
+             * A key and its value, as stored by interleaved slot arrays.
+             */
+            struct slot_item {
+                K key;
+                V value;
+            };
+
+            /**
+             * An array of slots. The `stash_size` slots of the overflow stash
+             * follow the `capacity` regular ones. All the arrays are carved out
+             * of a single block, headed by the control bytes.
+             */
+            struct slot_array {
+                control_byte *control = nullptr; // Slot control bytes, followed by the cloned and stash control bytes
+                control_byte *generations = nullptr; // Generation of each control byte, only allocated when clearing by generation
+                key_pointer keys = nullptr; // Only allocated when not interleaving items
+                value_pointer values = nullptr; // Only allocated when not interleaving items
+                slot_item *items = nullptr; // Only allocated when interleaving items
+                hash_type *hashes = nullptr; // Full key hashes, only allocated when stored
+                size_type capacity = 0;
+                size_type chunk_size = default_chunk_size;
+                size_type item_count = 0; // Occupied slots, stash included
+                size_type stash_count = 0; // Occupied stash slots
+                control_byte generation = 0; // Current generation, only used when clearing by generation
+            };
+
+            /**
+             * State of an incremental rehash.
+             */
+            struct migration_state {
+                /**
+                 * The slots being migrated. Empty when not growing.
+                 */
+                slot_array source;
+
+                /**
+                 * The next source slot to migrate.
+                 */
+                size_type next = 0;
+            };
+
+            struct no_migration_state {};
+
+        public:
+            /**
+             * An item extracted from a table, owning its key and value. The
+             * key hash is kept along, so that inserting the node does not
+             * hash the key again.
+             */
+            class node_type {
+                friend class hashtable;
+
+                union { K node_key; };
+                union { V node_value; };
+                hash_type key_hash = 0;
+                bool has_item = false;
+
+                constexpr node_type(K&& key, V&& value, const hash_type key_hash)
+                    : node_key{std::move(key)},
+                    node_value{std::move(value)},
+                    key_hash{key_hash},
+                    has_item{true}
+                {}
+
+                public:
+                    constexpr node_type() noexcept {}
+
+                    constexpr node_type(node_type &&other) : key_hash{other.key_hash}, has_item{other.has_item} {
+                        if(has_item) {
+                            std::construct_at(&node_key, std::move(other.node_key));
+                            std::construct_at(&node_value, std::move(other.node_value));
+                            other.reset();
+                        }
+                    }
+
+                    node_type(const node_type &other) = delete;
+                    node_type& operator =(const node_type &other) = delete;
+
+                    constexpr node_type& operator =(node_type &&other) {
+                        if(this != &other) {
+                            reset();
+
+                            if(other.has_item) {
+                                std::construct_at(&node_key, std::move(other.node_key));
+                                std::construct_at(&node_value, std::move(other.node_value));
+                                key_hash = other.key_hash;
+                                has_item = true;
+                                other.reset();
+                            }
+                        }
+
+                        return *this;
+                    }
+
+                    constexpr ~node_type() {
+                        reset();
+                    }
+
+                    /**
+                     * Destroy the item, if any.
+                     */
+                    constexpr void reset() noexcept {
+                        if(has_item) {
+                            std::destroy_at(&node_key);
+                            std::destroy_at(&node_value);
+                            has_item = false;
+                        }
+                    }
+
+                    constexpr bool empty() const noexcept { return !has_item; }
+                    constexpr explicit operator bool() const noexcept { return has_item; }
+
+                    /**
+                     * The key. The node must not be empty. Modifying the key
+                     * is undefined behaviour, as its hash would not be updated.
+                     */
+                    constexpr const_key_reference key() const noexcept { return node_key; }
+
+                    /**
+                     * The value. The node must not be empty.
+                     */
+                    constexpr value_reference value() noexcept { return node_value; }
+                    constexpr const_value_reference value() const noexcept { return node_value; }
+            };
+
+            /**
+             * Initialise an empty table. No memory is allocated until the
+             * first item is inserted.
+             */
             explicit constexpr hashtable(
                 const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
                 allocator_type * const allocator = nullptr
-            ) : alloc{allocator}, _capacity{0}, keys{nullptr}, values{nullptr}, alloc_flags{alloc_flags}
-            {
-                reserve(minimum_capacity);
-            }
+            ) noexcept : alloc{allocator}, alloc_flags{alloc_flags}
+            {}
 
             constexpr hashtable(const hashtable &other)
                 : alloc{other},
-                _capacity{other._capacity},
-                slot_map{other.slot_map},
-                keys{other.keys},
-                values{other.values}
-            {}
+                alloc_flags{other.alloc_flags}
+            {
+                copy_from(other);
+            }
 
             constexpr hashtable(hashtable &&other)
                 : alloc{std::move(other)},
-                _capacity{std::move(other._capacity)},
-                slot_map{std::move(other.slot_map)},
-                keys{std::move(other.keys)},
-                values{std::move(other.values)}
+                slots{other.slots},
+                migration{std::move(other.migration)},
+                alloc_flags{other.alloc_flags}
             {
-                other.keys = nullptr;
-                other.values = nullptr;
+                other.release();
             }
 
             template<typename InputRange>
@@ -245,13 +478,7 @@ namespace ccl {
                 const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
                 allocator_type * const allocator = nullptr
             ) : hashtable{alloc_flags, allocator} {
-                std::for_each(
-                    input.begin(),
-                    input.end(),
-                    [this] (const auto &pair) {
-                        insert(pair.first, pair.second);
-                    }
-                );
+                insert_range(std::forward<InputRange>(input));
             }
 
             ~hashtable() {
@@ -259,60 +486,38 @@ namespace ccl {
             }
 
             void destroy() noexcept {
-                if constexpr(
-                    !std::is_trivially_destructible_v<K>
-                    || !std::is_trivially_destructible_v<V>
-                ) {
-                    const size_type end = slot_map.size_bits();
-
-                    for(size_type i = 0; i < end; i+= 1) {
-                        const bool is_set = slot_map[i];
-
-                        if(is_set) {
-                            if constexpr(!std::is_trivially_destructible_v<K>) {
-                                std::destroy_at(&keys[i]);
-                            }
-
-                            if constexpr(!std::is_trivially_destructible_v<V>) {
-                                std::destroy_at(&values[i]);
-                            }
-                        }
-                    }
-                }
+                destroy_items(slots);
+                deallocate_slots(slots);
 
-                if(keys) {
-                    alloc::get_allocator()->deallocate(keys);
-                    alloc::get_allocator()->deallocate(values);
+                if constexpr(incremental_rehash) {
+                    destroy_items(migration.source);
+                    deallocate_slots(migration.source);
                 }
-
-                slot_map.destroy();
-
-                _capacity = 0;
-                keys = nullptr;
-                values = nullptr;
             }
 
             constexpr size_type capacity() const noexcept {
-                return _capacity;
+                return slots.capacity;
+            }
+
+            /**
+             * Number of items in the table.
+             */
+            constexpr size_type size() const noexcept {
+                if constexpr(incremental_rehash) {
+                    return slots.item_count + migration.source.item_count;
+                } else {
+                    return slots.item_count;
+                }
             }
 
             constexpr hashtable& operator =(const hashtable &other) {
-                destroy();
-                alloc::operator =(other);
-                reserve(other._capacity);
+                if(this != &other) {
+                    destroy();
+                    alloc::operator =(other);
 
-                if constexpr(
-                    std::is_trivially_copyable_v<K>
-                    && std::is_trivially_copyable_v<V>
-                ) { // Both trivially copiable
-                    ::memcpy(keys, other.keys, sizeof(K) * _capacity);
-                    ::memcpy(values, other.values, sizeof(V) * _capacity);
+                    alloc_flags = other.alloc_flags;
 
-                    slot_map = other.slot_map;
-                } else {
-                    for(const auto& pair : other) {
-                        insert(*pair.first, *pair.second);
-                    }
+                    copy_from(other);
                 }
 
                 return *this;
@@ -322,262 +527,1594 @@ namespace ccl {
                 destroy();
 
                 alloc::operator =(std::move(other));
-                slot_map = std::move(other.slot_map);
-                keys = std::move(other.keys);
-                values = std::move(other.values);
-                _capacity = other._capacity;
+                slots = other.slots;
+                migration = std::move(other.migration);
+                alloc_flags = other.alloc_flags;
 
-                other.keys = nullptr;
-                other.values = nullptr;
-                other._capacity = 0;
+                other.release();
 
                 return *this;
             }
 
-            constexpr void reserve(size_type new_capacity) {
-                if(new_capacity <= _capacity) {
+            /**
+             * Grow the table to hold at least the given number of slots. Any
+             * incremental rehash in progress is completed first.
+             *
+             * @param new_capacity The new minimum capacity.
+             */
+            constexpr void reserve(const size_type new_capacity) {
+                finish_migration();
+                reserve_slots(new_capacity);
+            }
+
+            /**
+             * Grow the table ahead of holding a number of items, so that
+             * inserting them does not rehash. Any incremental rehash in
+             * progress is completed first.
+             *
+             * @param item_count The number of items.
+             */
+            constexpr void reserve_items(const size_type item_count) {
+                size_type new_capacity = max(minimum_capacity, slots.capacity);
+
+                while(max_item_count(new_capacity) < item_count) {
+                    new_capacity <<= 1;
+                }
+
+                reserve(new_capacity);
+            }
+
+            /**
+             * Release the slots not needed by the current items. The items are
+             * moved to the smallest capacity holding them within the maximum
+             * load factor, with chunks of the default size. Empty tables release
+             * all their slots. Any incremental rehash in progress is completed
+             * first.
+             */
+            constexpr void shrink_to_fit() {
+                finish_migration();
+
+                if(!size()) {
+                    destroy_items(slots);
+                    deallocate_slots(slots);
+                    slots.chunk_size = default_chunk_size;
+
                     return;
                 }
 
-                bool done;
-                new_capacity = increase_capacity(_capacity, new_capacity);
-                bitset<allocator_type> new_slot_map;
-                const auto finish = end();
-                key_pointer new_keys;
-                value_pointer new_values;
+                size_type new_capacity = minimum_capacity;
 
-                do {
-                    bool keep_iterating = true;
-                    done = true;
-                    new_keys = alloc::get_allocator()->template allocate<key_type>(new_capacity, alloc_flags);
-                    new_values = alloc::get_allocator()->template allocate<value_type>(new_capacity, alloc_flags);
+                while(max_item_count(new_capacity) < size()) {
+                    new_capacity <<= 1;
+                }
 
-                    new_slot_map.resize(new_capacity);
-                    new_slot_map.zero();
+                if(new_capacity < slots.capacity || slots.chunk_size != default_chunk_size) {
+                    rebuild_slots(min(new_capacity, slots.capacity), default_chunk_size);
+                }
+            }
 
-                    for(auto it = begin(); it < finish && keep_iterating; ++it) {
-                        const size_type new_index = compute_key_index(*it->first, new_capacity);
-                        const size_type last_chunk_index = wrap_index(new_index + chunk_size, new_capacity);
-                        bool item_added = false;
+            /**
+             * Insert an item, unless its key is already present.
+             *
+             * @param key The key. Moved into the table if it is an rvalue.
+             * @param value The value. Forwarded to the value constructor.
+             */
+            template<typename ValueArg = V> requires std::constructible_from<V, ValueArg>
+            constexpr void insert(const_key_reference key, ValueArg&& value) {
+                find_or_emplace(key, std::forward<ValueArg>(value));
+            }
 
-                        for(size_type i = new_index; i != last_chunk_index; i = wrap_index(++i, new_capacity)) {
-                            if(!new_slot_map[i]) {
-                                std::construct_at(&new_keys[i], std::move(*it->first));
-                                std::construct_at(&new_values[i], std::move(*it->second));
+            template<typename ValueArg = V> requires std::constructible_from<V, ValueArg>
+            constexpr void insert(key_type&& key, ValueArg&& value) {
+                const hash_type key_hash = hash(key);
 
-                                std::destroy_at(&keys[it.index]);
-                                std::destroy_at(&values[it.index]);
+                find_or_emplace_hashed(std::move(key), key_hash, std::forward<ValueArg>(value));
+            }
 
-                                new_slot_map.set(i);
+            template<typename ...Args>
+            constexpr value_reference emplace(const_key_reference key, Args&& ...args) {
+                return slot_value(find_or_emplace(key, std::forward<Args>(args)...));
+            }
 
-                                item_added = true;
-                                break;
-                            }
-                        }
+            template<typename ...Args>
+            constexpr value_reference emplace(key_type&& key, Args&& ...args) {
+                const hash_type key_hash = hash(key);
 
-                        // If the chunk is full because of too many close-by
-                        // elements we have to start over and increase the capacity once more.
-                        if(!item_added) {
-                            alloc::get_allocator()->deallocate(new_keys);
-                            alloc::get_allocator()->deallocate(new_values);
-                            new_capacity <<= 1;
-                            done = false;
-                            break;
-                        }
-                    }
-                } while(!done);
+                return slot_value(find_or_emplace_hashed(std::move(key), key_hash, std::forward<Args>(args)...));
+            }
 
-                if(keys) {
-                    alloc::get_allocator()->deallocate(keys);
-                    alloc::get_allocator()->deallocate(values);
-                }
+            /**
+             * Insert a key, constructing its value in place, unless the key is
+             * already present. Neither the key nor the arguments are consumed
+             * if the key is present.
+             *
+             * @param key The key.
+             * @param args The value constructor arguments.
+             *
+             * @return An iterator to the key and whether it was inserted.
+             */
+            template<typename ...Args>
+            constexpr pair<iterator, bool> try_emplace(const_key_reference key, Args&& ...args) {
+                return try_emplace_hashed(key, hash(key), std::forward<Args>(args)...);
+            }
 
-                _capacity = new_capacity;
-                slot_map = std::move(new_slot_map);
-                keys = new_keys;
-                values = new_values;
+            template<typename ...Args>
+            constexpr pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args) {
+                const hash_type key_hash = hash(key);
+
+                return try_emplace_hashed(std::move(key), key_hash, std::forward<Args>(args)...);
             }
 
-            constexpr void insert(const_key_reference key, const_value_reference value) {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
-                size_type first_empty = invalid_size;
+            /**
+             * Insert an item, or assign the value of its key if already present.
+             *
+             * @param key The key.
+             * @param value The value. Forwarded to either the value constructor
+             *  or its assignment operator.
+             *
+             * @return An iterator to the key and whether it was inserted.
+             */
+            template<typename ValueArg> requires std::constructible_from<V, ValueArg> && std::assignable_from<V&, ValueArg>
+            constexpr pair<iterator, bool> insert_or_assign(const_key_reference key, ValueArg&& value) {
+                return insert_or_assign_hashed(key, hash(key), std::forward<ValueArg>(value));
+            }
 
-                // Check all items in a chunk. If we find the exact key,
-                // nothing needs to be done. Item is already there. Otherwise
-                // find the first available slot in the chunk and add the item.
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && key == keys[i]) {
-                        return;
-                    }
+            template<typename ValueArg> requires std::constructible_from<V, ValueArg> && std::assignable_from<V&, ValueArg>
+            constexpr pair<iterator, bool> insert_or_assign(key_type&& key, ValueArg&& value) {
+                const hash_type key_hash = hash(key);
 
-                    if(!slot_map[i] && first_empty == invalid_size) {
-                        first_empty = i;
-                    }
-                }
+                return insert_or_assign_hashed(std::move(key), key_hash, std::forward<ValueArg>(value));
+            }
 
-                if(first_empty != invalid_size) {
-                    std::construct_at(&keys[first_empty], key);
-                    std::construct_at(&values[first_empty], value);
-                    slot_map[first_empty] = true;
-                    return;
+            /**
+             * Insert multiple items. The keys of each batch are hashed and
+             * their chunks prefetched before any of them is inserted.
+             *
+             * @param keys The keys to insert.
+             * @param values The values to insert, one per key.
+             */
+            constexpr void insert_batch(const std::span<const key_type> keys, const std::span<const value_type> values) {
+                CCL_THROW_IF(keys.size() != values.size(), std::invalid_argument{"Key and value counts differ."});
+
+                for_each_hashed(keys, [this, keys, values] (const std::size_t i, const hash_type key_hash) {
+                    find_or_emplace_hashed(keys[i], key_hash, values[i]);
+                });
+            }
+
+            /**
+             * Insert the items of a range of key-value pairs, unless their keys
+             * are already present. Sized ranges grow the table once, up front.
+             * The keys of ranges that can be traversed more than once are
+             * hashed in batches, and their chunks prefetched before any of
+             * them is inserted.
+             *
+             * @param input The pairs to insert.
+             */
+            template<std::ranges::input_range InputRange>
+            constexpr void insert_range(InputRange&& input) {
+                using item_reference = std::ranges::range_reference_t<InputRange>;
+
+                if constexpr(std::ranges::sized_range<InputRange>) {
+                    reserve_items(size() + static_cast<size_type>(std::ranges::size(input)));
                 }
 
-                // No slots available in the chunk. Reserve and
-                // rehash.
-                rehash();
-                insert(key, value);
-            }
+                if constexpr(
+                    std::ranges::forward_range<InputRange>
+                    && std::same_as<std::remove_cvref_t<decltype(std::declval<item_reference>().first)>, K>
+                ) {
+                    hash_type key_hashes[batch_size];
+                    const auto last = std::ranges::end(input);
 
-            template<typename ...Args>
-            constexpr value_reference emplace(const_key_reference key, Args&& ...args) {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
-                size_type first_empty = invalid_size;
+                    for(auto it = std::ranges::begin(input); it != last; ) {
+                        const auto batch_first = it;
+                        size_type count = 0;
 
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && key == keys[i]) {
-                        return values[i];
-                    }
+                        for(; count < batch_size && it != last; ++count, ++it) {
+                            key_hashes[count] = hash((*it).first);
+                            prefetch_chunk(slots, key_hashes[count]);
+                        }
+
+                        it = batch_first;
+
+                        for(size_type i = 0; i < count; ++i, ++it) {
+                            item_reference item = *it;
 
-                    if(!slot_map[i] && first_empty == invalid_size) {
-                        first_empty = i;
+                            find_or_emplace_hashed(item.first, key_hashes[i], item.second);
+                        }
+                    }
+                } else {
+                    for(auto&& item : input) {
+                        insert(item.first, item.second);
                     }
                 }
+            }
+
+            /**
+             * Insert the item of a node, unless its key is already present.
+             *
+             * @param node The node. Emptied if its item is inserted.
+             *
+             * @return True if the item was inserted, false otherwise.
+             */
+            constexpr bool insert(node_type &&node) {
+                if(node.empty()) {
+                    return false;
+                }
+
+                const size_type old_size = size();
+
+                find_or_emplace_hashed(std::move(node.node_key), node.key_hash, std::move(node.node_value));
 
-                if(first_empty != invalid_size) {
-                    std::construct_at(&keys[first_empty], key);
-                    std::construct_at(&values[first_empty], std::forward<Args>(args)...);
-                    slot_map[first_empty] = true;
-                    return values[first_empty];
+                if(size() == old_size) {
+                    return false;
                 }
 
-                // No slots available
-                rehash();
-                return emplace(key, std::forward<Args>(args)...);
+                node.reset();
+
+                return true;
             }
 
+            /**
+             * Erase a key, if present. May shrink the table, depending on the
+             * policy, invalidating all iterators.
+             *
+             * @param key The key.
+             */
             constexpr void erase(const_key_reference key) {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
-
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && keys[i] == key) {
-                        std::destroy_at(&keys[i]);
-                        std::destroy_at(&values[i]);
-                        slot_map[i] = false;
-                        return;
-                    }
+                const size_type i = locate(key);
+
+                if(i != invalid_size) {
+                    erase_slot(i);
+                    shrink_if_sparse();
                 }
             }
 
             template<typename Iterator>
             constexpr void erase(const Iterator& it) {
-                const size_type i = it.index;
+                erase_slot(it.index);
+            }
+
+            /**
+             * Remove a key, moving it and its value to a node.
+             *
+             * @param key The key.
+             *
+             * @return The node, empty if the key was not present.
+             */
+            constexpr node_type extract(const_key_reference key) {
+                const hash_type key_hash = hash(key);
+                const size_type i = locate_hashed(key, key_hash);
+
+                if(i == invalid_size) {
+                    return node_type{};
+                }
+
+                node_type node = extract_slot(i, key_hash);
 
-                std::destroy_at(&keys[i]);
-                std::destroy_at(&values[i]);
-                slot_map[i] = false;
+                shrink_if_sparse();
+
+                return node;
             }
 
-            CCLNODISCARD constexpr auto& at(const_key_reference key) const {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
+            constexpr node_type extract(const iterator& it) {
+                return extract_slot(it.index, slot_key_hash(it.index));
+            }
 
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && keys[i] == key) {
-                        return values[i];
-                    }
+            /**
+             * Move the items of another table into this one. Items are moved
+             * straight to their new slots, without hashing their keys again
+             * if hashes are stored. Items whose key is already present are
+             * left in `other`.
+             *
+             * @param other The table to move the items from.
+             */
+            constexpr void merge(hashtable &other) {
+                if(this == &other) {
+                    return;
                 }
 
-                CCL_THROW(std::out_of_range{"Key not present."});
-            }
+                reserve_items(size() + other.size());
 
-            constexpr value_reference operator [](const_key_reference key) {
-                static_assert(std::is_default_constructible_v<V>);
+                const size_type other_slot_count = other.slot_count();
 
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
+                for(size_type i = 0; i < other_slot_count; ++i) {
+                    if(other.is_slot_full(i)) {
+                        const size_type old_size = size();
 
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && keys[i] == key) {
-                        return values[i];
+                        find_or_emplace_hashed(
+                            std::move(other.slot_key(i)),
+                            other.slot_key_hash(i),
+                            std::move(other.slot_value(i))
+                        );
+
+                        if(size() != old_size) {
+                            other.erase_slot(i);
+                        }
                     }
                 }
+            }
+
+            constexpr void merge(hashtable &&other) {
+                merge(other);
+            }
+
+            CCLNODISCARD constexpr auto& at(const_key_reference key) const {
+                const size_type i = locate(key);
+
+                CCL_THROW_IF(i == invalid_size, std::out_of_range{"Key not present."});
+
+                return slot_value(i);
+            }
+
+            /**
+             * Access the value of a key, looking it up through a compatible
+             * type. Requires a transparent hash function.
+             *
+             * @param key The key to look up.
+             *
+             * @return The value of the key.
+             */
+            template<transparent_key<K, HashFunction> Q>
+            CCLNODISCARD constexpr auto& at(const Q& key) const {
+                const size_type i = locate(key);
+
+                CCL_THROW_IF(i == invalid_size, std::out_of_range{"Key not present."});
+
+                return slot_value(i);
+            }
+
+            constexpr value_reference operator [](const_key_reference key) {
+                static_assert(std::is_default_constructible_v<V>);
 
                 return emplace(key);
             }
 
             constexpr void clear() {
-                if constexpr(!std::is_trivially_destructible_v<K>) {
-                    for(size_type i = 0; i < _capacity; ++i) {
-                        if(slot_map[i]) {
-                            std::destroy_at(&keys[i]);
-                        }
-                    }
-                }
+                destroy_items(slots);
 
-                if constexpr(!std::is_trivially_destructible_v<V>) {
-                    for(size_type i = 0; i < _capacity; ++i) {
-                        if(slot_map[i]) {
-                            std::destroy_at(&values[i]);
-                        }
-                    }
+                // Starting a new generation is enough, unless the generations
+                // wrapped around and stale slots could be taken for current ones.
+                const bool reset_control = !generational_clear || ++slots.generation == 0;
+
+                if(slots.control && reset_control) {
+                    ::memset(slots.control, internal::control_empty, control_count(slots.capacity));
                 }
 
-                slot_map.zero();
+                slots.item_count = 0;
+                slots.stash_count = 0;
+
+                if constexpr(incremental_rehash) {
+                    destroy_items(migration.source);
+                    deallocate_slots(migration.source);
+                }
             }
 
             constexpr iterator find(const_key_reference key) {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
-
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && keys[i] == key) {
-                        return iterator { *this, i };
-                    }
-                }
+                const size_type i = locate(key);
 
-                return end();
+                return i != invalid_size ? iterator { *this, i } : end();
             }
 
             constexpr const_iterator find(const_key_reference key) const {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
+                const size_type i = locate(key);
 
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && keys[i] == key) {
-                        return const_iterator { *this, i };
-                    }
+                return i != invalid_size ? const_iterator { *this, i } : end();
+            }
+
+            constexpr bool contains(const_key_reference key) const {
+                return locate(key) != invalid_size;
+            }
+
+            /**
+             * Find a key, looking it up through a compatible type. Requires
+             * a transparent hash function. No temporary key is constructed.
+             *
+             * @param key The key to look up.
+             *
+             * @return An iterator to the key or `end()` if not present.
+             */
+            template<transparent_key<K, HashFunction> Q>
+            constexpr iterator find(const Q& key) {
+                const size_type i = locate(key);
+
+                return i != invalid_size ? iterator { *this, i } : end();
+            }
+
+            template<transparent_key<K, HashFunction> Q>
+            constexpr const_iterator find(const Q& key) const {
+                const size_type i = locate(key);
+
+                return i != invalid_size ? const_iterator { *this, i } : end();
+            }
+
+            template<transparent_key<K, HashFunction> Q>
+            constexpr bool contains(const Q& key) const {
+                return locate(key) != invalid_size;
+            }
+
+            /**
+             * Find a key whose hash was already computed by the caller, as
+             * by `HashFunction{}(key)`. Any other hash gives wrong results.
+             *
+             * @param key The key to look up.
+             * @param key_hash The hash of `key`.
+             *
+             * @return An iterator to the key or `end()` if not present.
+             */
+            constexpr iterator find_hashed(const_key_reference key, const hash_type key_hash) {
+                const size_type i = locate_hashed(key, key_hash);
+
+                return i != invalid_size ? iterator { *this, i } : end();
+            }
+
+            constexpr const_iterator find_hashed(const_key_reference key, const hash_type key_hash) const {
+                const size_type i = locate_hashed(key, key_hash);
+
+                return i != invalid_size ? const_iterator { *this, i } : end();
+            }
+
+            constexpr bool contains_hashed(const_key_reference key, const hash_type key_hash) const {
+                return locate_hashed(key, key_hash) != invalid_size;
+            }
+
+            /**
+             * Insert a key whose hash was already computed by the caller,
+             * constructing its value in place, unless the key is already present.
+             *
+             * @param key The key.
+             * @param key_hash The hash of `key`.
+             * @param args The value constructor arguments.
+             *
+             * @return The value of the key.
+             */
+            template<typename ...Args>
+            constexpr value_reference emplace_hashed(const_key_reference key, const hash_type key_hash, Args&& ...args) {
+                return slot_value(find_or_emplace_hashed(key, key_hash, std::forward<Args>(args)...));
+            }
+
+            /**
+             * Remove a key whose hash was already computed by the caller, if present.
+             *
+             * @param key The key.
+             * @param key_hash The hash of `key`.
+             */
+            constexpr void erase_hashed(const_key_reference key, const hash_type key_hash) {
+                const size_type i = locate_hashed(key, key_hash);
+
+                if(i != invalid_size) {
+                    erase_slot(i);
+                    shrink_if_sparse();
                 }
+            }
 
-                return end();
+            /**
+             * Find multiple keys. The keys of each batch are hashed and their
+             * chunks prefetched before any of them is looked up, so that the
+             * cache misses of a batch overlap.
+             *
+             * @param keys The keys to find.
+             * @param out Output iterator receiving one iterator per key, `end()`
+             *  for the keys not present.
+             */
+            template<std::output_iterator<iterator> OutputIterator>
+            constexpr void find_batch(const std::span<const key_type> keys, OutputIterator out) {
+                for_each_hashed(keys, [this, keys, &out] (const std::size_t i, const hash_type key_hash) {
+                    const size_type index = locate_hashed(keys[i], key_hash);
+
+                    *out++ = index != invalid_size ? iterator { *this, index } : end();
+                });
             }
 
-            constexpr bool contains(const_key_reference key) const {
-                return find(key) != end();
+            template<std::output_iterator<const_iterator> OutputIterator>
+            constexpr void find_batch(const std::span<const key_type> keys, OutputIterator out) const {
+                for_each_hashed(keys, [this, keys, &out] (const std::size_t i, const hash_type key_hash) {
+                    const size_type index = locate_hashed(keys[i], key_hash);
+
+                    *out++ = index != invalid_size ? const_iterator { *this, index } : end();
+                });
+            }
+
+            /**
+             * Check the presence of multiple keys. The keys of each batch are
+             * hashed and their chunks prefetched before any of them is looked up.
+             *
+             * @param keys The keys to look for.
+             * @param out Output iterator receiving one boolean per key.
+             */
+            template<std::output_iterator<bool> OutputIterator>
+            constexpr void contains_batch(const std::span<const key_type> keys, OutputIterator out) const {
+                for_each_hashed(keys, [this, keys, &out] (const std::size_t i, const hash_type key_hash) {
+                    *out++ = locate_hashed(keys[i], key_hash) != invalid_size;
+                });
             }
 
             constexpr iterator begin() { return iterator{ *this, 0 }; }
-            constexpr iterator end() { return iterator{ *this, _capacity }; }
+            constexpr iterator end() { return iterator{ *this, slot_count() }; }
 
             constexpr const_iterator begin() const { return const_iterator{ *this, 0 }; }
-            constexpr const_iterator end() const { return const_iterator{ *this, _capacity }; }
+            constexpr const_iterator end() const { return const_iterator{ *this, slot_count() }; }
 
             constexpr const_iterator cbegin() const { return const_iterator{ *this, 0 }; }
-            constexpr const_iterator cend() const { return const_iterator{ *this, _capacity }; }
+            constexpr const_iterator cend() const { return const_iterator{ *this, slot_count() }; }
 
             constexpr allocator_type* get_allocator() const noexcept { return alloc::get_allocator(); }
             constexpr allocation_flags get_allocation_flags() const noexcept { return alloc_flags; }
-            constexpr size_type get_chunk_size() const noexcept { return chunk_size; }
+            constexpr size_type get_chunk_size() const noexcept { return slots.chunk_size; }
+
+#ifdef CCL_FEATURE_HASH_STATS
+            /**
+             * Get the occupancy of the table and the events recorded since
+             * its construction or the last call to `reset_stats()`.
+             */
+            constexpr hash_stats get_stats() const noexcept {
+                hash_stats result = stats.get();
+
+                result.capacity = slots.capacity;
+                result.size = size();
+                result.overflow_size = slots.stash_count;
+                result.chunk_size = slots.chunk_size;
+
+                if constexpr(incremental_rehash) {
+                    result.overflow_size += migration.source.stash_count;
+                }
+
+                return result;
+            }
+
+            constexpr void reset_stats() noexcept {
+                stats.reset();
+            }
+#endif // CCL_FEATURE_HASH_STATS
+
+            /**
+             * Check whether an incremental rehash is in progress.
+             */
+            constexpr bool is_rehashing() const noexcept {
+                if constexpr(incremental_rehash) {
+                    return migration.source.control != nullptr;
+                } else {
+                    return false;
+                }
+            }
 
         private:
-            void rehash() {
-                chunk_size <<= 1;
-                reserve(max<size_type>(1, _capacity << 1));
+            /**
+             * Outcome of probing a chunk for a key.
+             */
+            struct probe_result {
+                /**
+                 * Slot holding the key, or `invalid_size`.
+                 */
+                size_type match;
+
+                /**
+                 * First vacant slot in the chunk, or `invalid_size`. Only
+                 * looked for when requested.
+                 */
+                size_type first_empty;
+            };
+
+            /**
+             * Number of control bytes following the last slot, mirroring the
+             * leading ones. This lets a group be loaded at any slot without
+             * handling the wrap-around.
+             */
+            static constexpr size_type cloned_control_count = control_group::width - 1;
+
+            /**
+             * Number of stash control bytes, padded to allow loading a whole
+             * group at any stash slot.
+             */
+            static constexpr size_type stash_control_count = stash_size + control_group::width - 1;
+
+            /**
+             * Alignment of the block holding all the slots of a slot array.
+             */
+            static constexpr std::size_t slot_alignment = max(alignof(K), alignof(V), alignof(hash_type));
+
+            /**
+             * Bytes moved along with every item.
+             */
+            static constexpr std::size_t item_size = sizeof(K) + sizeof(V) + (store_hashes ? sizeof(hash_type) : 0);
+
+            /**
+             * Grow the capacity by the growth factor once the load factor is too high.
+             */
+            constexpr void rehash() {
+                if constexpr(incremental_rehash) {
+                    if(slots.capacity) {
+                        finish_migration();
+                        begin_migration();
+                        return;
+                    }
+                }
+
+                rebuild_slots(max(minimum_capacity, static_cast<size_type>(slots.capacity * growth_factor)), default_chunk_size);
+            }
+
+            /**
+             * Lengthen the chunks of the current slots, after both the chunk
+             * of a key and the stash overflowed. The capacity is unchanged.
+             */
+            constexpr void lengthen_chunks() {
+                stats.record_chunk_growth();
+                rebuild_slots(slots.capacity, slots.chunk_size << 1);
+            }
+
+            /**
+             * Shrink the table once its load factor fell below the low watermark.
+             */
+            constexpr void shrink_if_sparse() {
+                if constexpr(shrink_load_factor > 0) {
+                    const auto low_item_count = static_cast<size_type>(static_cast<float>(slots.capacity) * shrink_load_factor);
+
+                    if(slots.capacity > minimum_capacity && size() < low_item_count) {
+                        shrink_to_fit();
+                    }
+                }
+            }
+
+            constexpr void reserve_slots(const size_type new_capacity) {
+                if(new_capacity <= slots.capacity) {
+                    return;
+                }
+
+                rebuild_slots(increase_capacity(slots.capacity, max(minimum_capacity, new_capacity)), default_chunk_size);
+            }
+
+            /**
+             * Move all the items of the current slots to a new slot array at once.
+             *
+             * @param new_capacity The capacity of the new slots.
+             * @param new_chunk_size The initial chunk size of the new slots.
+             *  Doubled until all the items fit.
+             */
+            constexpr void rebuild_slots(const size_type new_capacity, const size_type new_chunk_size) {
+                const size_type old_slot_count = slot_total(slots);
+                slot_array target;
+
+                target.capacity = new_capacity;
+                target.chunk_size = new_chunk_size;
+
+                allocate_slots(target);
+
+                // Items are placed before being moved. If a chunk and the stash
+                // overflow because of too many close-by elements we have to
+                // start over with longer chunks, in the same slots.
+                while(!place_slots(target)) {
+                    stats.record_chunk_growth();
+                    clear_control(target);
+                    target.chunk_size <<= 1;
+                }
+
+                // Placing the items again yields the same slots.
+                clear_control(target);
+
+                for(size_type i = 0; i < old_slot_count; ++i) {
+                    if(is_full(slots, i)) {
+                        const hash_type key_hash = slot_hash(slots, i);
+                        const size_type index = find_empty_slot(target, key_hash);
+
+                        move_item(slots, i, target, index != invalid_size ? index : find_stash_slot(target));
+                    }
+                }
+
+                if(slots.control) {
+                    stats.record_rehash(static_cast<std::size_t>(slots.item_count) * item_size);
+                }
+
+                deallocate_slots(slots);
+                slots = target;
+            }
+
+            /**
+             * Start growing incrementally. The current slots become the
+             * migration source.
+             */
+            constexpr void begin_migration() {
+                slot_array &source = migration.source;
+
+                source = slots;
+                migration.next = 0;
+
+                stats.record_rehash(0);
+
+                slots = slot_array{};
+                slots.capacity = source.capacity * growth_factor;
+
+                allocate_slots(slots);
+            }
+
+            /**
+             * Move items from the migration source to the current slots.
+             *
+             * @param count The maximum number of source slots to visit.
+             */
+            constexpr void migrate(const size_type count) {
+                if constexpr(incremental_rehash) {
+                    slot_array &source = migration.source;
+
+                    if(!source.control) {
+                        return;
+                    }
+
+                    const size_type source_slot_count = slot_total(source);
+                    const size_type last = count < source_slot_count - migration.next
+                        ? migration.next + count
+                        : source_slot_count;
+
+                    for(; migration.next < last; ++migration.next) {
+                        const size_type i = migration.next;
+
+                        if(is_full(source, i)) {
+                            const hash_type key_hash = slot_hash(source, i);
+                            size_type new_index;
+
+                            // The current slots may overflow before the
+                            // migration is over. Lengthen their chunks at once.
+                            while((new_index = find_free_slot(slots, key_hash)) == invalid_size) {
+                                lengthen_chunks();
+                            }
+
+                            move_item(source, i, slots, new_index);
+                            set_control(source, i, internal::control_deleted);
+                            stats.record_move(item_size);
+                        }
+                    }
+
+                    if(migration.next == source_slot_count) {
+                        deallocate_slots(source);
+                    }
+                }
+            }
+
+            constexpr void finish_migration() {
+                migrate(invalid_size);
+            }
+
+            /**
+             * Find a key or insert it, constructing its value in place.
+             *
+             * @param key The key.
+             * @param args The value constructor arguments, used only if the key
+             *  is not present.
+             *
+             * @return The slot of the key.
+             */
+            template<typename ...Args>
+            constexpr size_type find_or_emplace(const_key_reference key, Args&& ...args) {
+                return find_or_emplace_hashed(key, hash(key), std::forward<Args>(args)...);
+            }
+
+            template<typename KeyArg, typename ...Args>
+            constexpr pair<iterator, bool> try_emplace_hashed(KeyArg&& key, const hash_type key_hash, Args&& ...args) {
+                const size_type old_size = size();
+                const size_type index = find_or_emplace_hashed(std::forward<KeyArg>(key), key_hash, std::forward<Args>(args)...);
+
+                return { iterator{ *this, index }, size() != old_size };
+            }
+
+            template<typename KeyArg, typename ValueArg>
+            constexpr pair<iterator, bool> insert_or_assign_hashed(KeyArg&& key, const hash_type key_hash, ValueArg&& value) {
+                const size_type old_size = size();
+                const size_type index = find_or_emplace_hashed(std::forward<KeyArg>(key), key_hash, std::forward<ValueArg>(value));
+                const bool inserted = size() != old_size;
+
+                // The value is only forwarded to the constructor if the key was
+                // inserted, otherwise it is still untouched.
+                if(!inserted) {
+                    slot_value(index) = std::forward<ValueArg>(value);
+                }
+
+                return { iterator{ *this, index }, inserted };
+            }
+
+            template<typename KeyArg, typename ...Args>
+            constexpr size_type find_or_emplace_hashed(KeyArg&& key, const hash_type key_hash, Args&& ...args) {
+                while(true) {
+                    migrate(incremental_rehash_step);
+
+                    const probe_result slot = probe<true>(slots, key, key_hash);
+
+                    // If we find the exact key, nothing needs to be done. Item is
+                    // already there. Otherwise use the first available slot in the
+                    // chunk.
+                    if(slot.match != invalid_size) {
+                        return slot.match;
+                    }
+
+                    if constexpr(incremental_rehash) {
+                        if(is_rehashing()) {
+                            const size_type source_index = probe<false>(migration.source, key, key_hash).match;
+
+                            if(source_index != invalid_size) {
+                                return slot_total(slots) + source_index;
+                            }
+                        }
+                    }
+
+                    if(size() >= max_item_count(slots.capacity)) {
+                        rehash();
+                        continue;
+                    }
+
+                    const size_type index = slot.first_empty != invalid_size
+                        ? slot.first_empty
+                        : find_stash_slot(slots);
+
+                    if(slot.first_empty == invalid_size) {
+                        stats.record_failed_chunk();
+                    }
+
+                    if(index != invalid_size) {
+                        std::construct_at(&key_at(slots, index), std::forward<KeyArg>(key));
+                        std::construct_at(&value_at(slots, index), std::forward<Args>(args)...);
+                        occupy_slot(slots, index, key_hash);
+
+                        return index;
+                    }
+
+                    // No slots available in the chunk nor in the stash.
+                    lengthen_chunks();
+                }
+            }
+
+            /**
+             * Scan the chunk of a key, one control group at a time, then the
+             * stash if any key overflowed into it.
+             *
+             * @tparam FindEmpty Whether to look for the first vacant slot as well.
+             * @tparam Q The key type or a transparent lookup type.
+             *
+             * @param target The slots to scan.
+             * @param key The key to look for.
+             * @param key_hash The hash of `key`.
+             */
+            template<bool FindEmpty, typename Q = K>
+            constexpr probe_result probe(const slot_array &target, const Q& key, const hash_type key_hash) const {
+                const control_byte tag = internal::make_control_byte(key_hash);
+                const size_type index = home_index(key_hash, target.capacity);
+                const size_type probe_length = min(target.chunk_size, target.capacity);
+                probe_result result { invalid_size, invalid_size };
+
+                for(size_type offset = 0; offset < probe_length; offset += control_group::width) {
+                    const size_type group_index = wrap_index(index + offset, target.capacity);
+                    const size_type lane_count = probe_length - offset;
+                    const control_group group = load_group(target, group_index);
+
+                    for(auto matches = group.match(tag).limit(lane_count); matches; matches.clear_lowest()) {
+                        const size_type i = wrap_index(group_index + matches.lowest(), target.capacity);
+
+                        if constexpr(store_hashes) {
+                            if(target.hashes[i] != key_hash) {
+                                continue;
+                            }
+                        }
+
+                        if(key_at(target, i) == key) {
+                            stats.record_probe(offset + matches.lowest() + 1);
+
+                            result.match = i;
+                            return result;
+                        }
+                    }
+
+                    if constexpr(FindEmpty) {
+                        if(result.first_empty == invalid_size) {
+                            const auto vacancies = group.match_vacant().limit(lane_count);
+
+                            if(vacancies) {
+                                result.first_empty = wrap_index(group_index + vacancies.lowest(), target.capacity);
+                            }
+                        }
+                    }
+
+                    // Keys are inserted in the first vacant slot of their chunk
+                    // and slots only become empty again when rebuilt. The key
+                    // cannot follow an empty slot, nor have overflowed into
+                    // the stash.
+                    if(group.match_empty().limit(lane_count)) {
+                        stats.record_probe(min(offset + static_cast<size_type>(control_group::width), probe_length));
+
+                        return result;
+                    }
+                }
+
+                if(target.stash_count) {
+                    result.match = probe_stash(target, key, tag);
+                }
+
+                stats.record_probe(probe_length + (target.stash_count ? stash_size : 0));
+
+                return result;
+            }
+
+            /**
+             * Scan the stash for a key.
+             *
+             * @param target The slots to scan.
+             * @param key The key to look for.
+             * @param tag The control byte of `key`.
+             *
+             * @return The slot holding the key, or `invalid_size`.
+             */
+            template<typename Q = K>
+            constexpr size_type probe_stash(const slot_array &target, const Q& key, const control_byte tag) const {
+                const size_type stash_control_index = control_count(target.capacity) - stash_control_count;
+
+                for(size_type offset = 0; offset < stash_size; offset += control_group::width) {
+                    const control_group group = load_group(target, stash_control_index + offset);
+
+                    for(auto matches = group.match(tag).limit(stash_size - offset); matches; matches.clear_lowest()) {
+                        const size_type i = target.capacity + offset + matches.lowest();
+
+                        if(key_at(target, i) == key) {
+                            return i;
+                        }
+                    }
+                }
+
+                return invalid_size;
+            }
+
+            /**
+             * Find the first vacant slot of the stash.
+             *
+             * @return The slot index or `invalid_size` if the stash is full.
+             */
+            static constexpr size_type find_stash_slot(const slot_array &target) {
+                if(target.stash_count == stash_size) {
+                    return invalid_size;
+                }
+
+                const size_type stash_control_index = control_count(target.capacity) - stash_control_count;
+
+                for(size_type offset = 0; offset < stash_size; offset += control_group::width) {
+                    const auto vacancies = load_group(target, stash_control_index + offset).match_vacant().limit(stash_size - offset);
+
+                    if(vacancies) {
+                        return target.capacity + offset + vacancies.lowest();
+                    }
+                }
+
+                return invalid_size;
+            }
+
+            /**
+             * Find the slot holding a key.
+             *
+             * @return The slot index or `invalid_size` if the key is not present.
+             *  Slots of the migration source follow the current ones.
+             */
+            template<typename Q = K>
+            constexpr size_type locate(const Q& key) const {
+                return locate_hashed(key, hash(key));
+            }
+
+            template<typename Q = K>
+            constexpr size_type locate_hashed(const Q& key, const hash_type key_hash) const {
+                const size_type index = probe<false>(slots, key, key_hash).match;
+
+                if constexpr(incremental_rehash) {
+                    if(index == invalid_size && is_rehashing()) {
+                        const size_type source_index = probe<false>(migration.source, key, key_hash).match;
+
+                        return source_index != invalid_size ? slot_total(slots) + source_index : invalid_size;
+                    }
+                }
+
+                return index;
+            }
+
+            /**
+             * Hash a sequence of keys in batches, prefetching the chunk of
+             * every key of a batch before resolving any of them.
+             *
+             * @param keys The keys.
+             * @param resolve Function invoked with the index and hash of
+             *  each key.
+             */
+            template<typename Resolve>
+            constexpr void for_each_hashed(const std::span<const key_type> keys, Resolve&& resolve) const {
+                hash_type key_hashes[batch_size];
+
+                for(std::size_t first = 0; first < keys.size(); first += batch_size) {
+                    const std::size_t count = min(keys.size() - first, static_cast<std::size_t>(batch_size));
+
+                    for(std::size_t i = 0; i < count; ++i) {
+                        key_hashes[i] = hash(keys[first + i]);
+                        prefetch_chunk(slots, key_hashes[i]);
+                    }
+
+                    for(std::size_t i = 0; i < count; ++i) {
+                        resolve(first + i, key_hashes[i]);
+                    }
+                }
+            }
+
+            /**
+             * Prefetch the beginning of the chunk of a hash.
+             */
+            static constexpr void prefetch_chunk(const slot_array &target, const hash_type key_hash) noexcept {
+                if(!target.capacity) {
+                    return;
+                }
+
+                const size_type index = home_index(key_hash, target.capacity);
+
+                prefetch(target.control + index);
+
+                if constexpr(generational_clear) {
+                    prefetch(target.generations + index);
+                }
+
+                prefetch(&key_at(target, index));
+            }
+
+            /**
+             * Find the first vacant slot in the chunk of a hash.
+             *
+             * @return The slot index or `invalid_size` if the chunk is full.
+             */
+            static constexpr size_type find_empty_slot(const slot_array &target, const hash_type key_hash) {
+                const size_type index = home_index(key_hash, target.capacity);
+                const size_type probe_length = min(target.chunk_size, target.capacity);
+
+                for(size_type offset = 0; offset < probe_length; offset += control_group::width) {
+                    const size_type group_index = wrap_index(index + offset, target.capacity);
+                    const auto vacancies = load_group(target, group_index).match_vacant().limit(probe_length - offset);
+
+                    if(vacancies) {
+                        return wrap_index(group_index + vacancies.lowest(), target.capacity);
+                    }
+                }
+
+                return invalid_size;
+            }
+
+            /**
+             * Find the first vacant slot in the chunk of a hash or, failing that,
+             * in the stash.
+             *
+             * @return The slot index or `invalid_size` if both are full.
+             */
+            constexpr size_type find_free_slot(const slot_array &target, const hash_type key_hash) const {
+                const size_type index = find_empty_slot(target, key_hash);
+
+                if(index != invalid_size) {
+                    return index;
+                }
+
+                stats.record_failed_chunk();
+
+                return find_stash_slot(target);
+            }
+
+            /**
+             * Mark the slots the current items would take in a new control
+             * array, without moving them.
+             *
+             * @param target The new slots. Only the control bytes are assigned.
+             *
+             * @return True if all items were placed, false if a chunk and the stash overflowed.
+             */
+            constexpr bool place_slots(slot_array &target) const {
+                const size_type slot_count = slot_total(slots);
+
+                for(size_type i = 0; i < slot_count; ++i) {
+                    if(is_full(slots, i)) {
+                        const size_type new_index = find_free_slot(target, slot_hash(slots, i));
+
+                        if(new_index == invalid_size) {
+                            return false;
+                        }
+
+                        set_control(target, new_index, control_of(slots, i));
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * Mark all the slots of a slot array as empty, without touching
+             * their items.
+             */
+            static constexpr void clear_control(slot_array &target) noexcept {
+                ::memset(target.control, internal::control_empty, control_count(target.capacity));
+                target.item_count = 0;
+                target.stash_count = 0;
+            }
+
+            /**
+             * Copy the slots of another table, keeping every item at its
+             * current slot.
+             */
+            constexpr void copy_from(const hashtable &other) {
+                copy_slots(slots, other.slots);
+
+                if constexpr(incremental_rehash) {
+                    copy_slots(migration.source, other.migration.source);
+                    migration.next = other.migration.next;
+                }
+            }
+
+            constexpr void copy_slots(slot_array &target, const slot_array &source) {
+                target.chunk_size = source.chunk_size;
+
+                if(!source.control) {
+                    return;
+                }
+
+                target.capacity = source.capacity;
+                target.item_count = source.item_count;
+                target.stash_count = source.stash_count;
+                allocate_slots(target);
+
+                const size_type slot_count = slot_total(target);
+
+                ::memcpy(target.control, source.control, control_count(target.capacity));
+
+                if constexpr(generational_clear) {
+                    ::memcpy(target.generations, source.generations, control_count(target.capacity));
+                    target.generation = source.generation;
+                }
+
+                if constexpr(store_hashes) {
+                    ::memcpy(target.hashes, source.hashes, sizeof(hash_type) * slot_count);
+                }
+
+                if constexpr(
+                    std::is_trivially_copyable_v<K>
+                    && std::is_trivially_copyable_v<V>
+                ) { // Both trivially copiable
+                    if constexpr(interleave_items) {
+                        ::memcpy(target.items, source.items, sizeof(slot_item) * slot_count);
+                    } else {
+                        ::memcpy(target.keys, source.keys, sizeof(K) * slot_count);
+                        ::memcpy(target.values, source.values, sizeof(V) * slot_count);
+                    }
+                } else {
+                    for(size_type i = 0; i < slot_count; ++i) {
+                        if(is_full(source, i)) {
+                            std::construct_at(&key_at(target, i), key_at(source, i));
+                            std::construct_at(&value_at(target, i), value_at(source, i));
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Forget all the slots, without releasing them.
+             */
+            constexpr void release() noexcept {
+                slots = slot_array{};
+
+                if constexpr(incremental_rehash) {
+                    migration = migration_state{};
+                }
+            }
+
+            /**
+             * Allocate the slots of a slot array as a single block. The control
+             * bytes come first, all empty, followed by the generations, the items
+             * and the hashes.
+             */
+            constexpr void allocate_slots(slot_array &target) const {
+                const size_type slot_count = slot_total(target);
+                const std::size_t control_size = control_count(target.capacity) * (generational_clear ? 2 : 1);
+                std::size_t keys_offset = 0;
+                std::size_t values_offset = 0;
+                std::size_t size;
+
+                if constexpr(interleave_items) {
+                    keys_offset = align_size(control_size, alignof(slot_item));
+                    size = keys_offset + sizeof(slot_item) * slot_count;
+                } else {
+                    keys_offset = align_size(control_size, alignof(K));
+                    values_offset = align_size(keys_offset + sizeof(K) * slot_count, alignof(V));
+                    size = values_offset + sizeof(V) * slot_count;
+                }
+
+                const std::size_t hashes_offset = align_size(size, alignof(hash_type));
+
+                if constexpr(store_hashes) {
+                    size = hashes_offset + sizeof(hash_type) * slot_count;
+                }
+
+                std::byte * const block = static_cast<std::byte*>(
+                    alloc::get_allocator()->allocate(size, slot_alignment, alloc_flags)
+                );
+
+                target.control = reinterpret_cast<control_byte*>(block);
+
+                if constexpr(generational_clear) {
+                    target.generations = target.control + control_count(target.capacity);
+                    target.generation = 0;
+                }
+
+                if constexpr(interleave_items) {
+                    target.items = reinterpret_cast<slot_item*>(block + keys_offset);
+                } else {
+                    target.keys = reinterpret_cast<key_pointer>(block + keys_offset);
+                    target.values = reinterpret_cast<value_pointer>(block + values_offset);
+                }
+
+                if constexpr(store_hashes) {
+                    target.hashes = reinterpret_cast<hash_type*>(block + hashes_offset);
+                }
+
+                ::memset(target.control, internal::control_empty, control_size);
+            }
+
+            /**
+             * Release the memory of a slot array, leaving it empty.
+             */
+            constexpr void deallocate_slots(slot_array &target) const noexcept {
+                if(target.control) {
+                    alloc::get_allocator()->deallocate(target.control);
+                }
+
+                target.control = nullptr;
+                target.generations = nullptr;
+                target.keys = nullptr;
+                target.values = nullptr;
+                target.items = nullptr;
+                target.hashes = nullptr;
+                target.capacity = 0;
+                target.item_count = 0;
+                target.stash_count = 0;
+            }
+
+            static constexpr void destroy_items(slot_array &target) noexcept {
+                if constexpr(
+                    !std::is_trivially_destructible_v<K>
+                    || !std::is_trivially_destructible_v<V>
+                ) {
+                    const size_type slot_count = slot_total(target);
+
+                    for(size_type i = 0; i < slot_count; ++i) {
+                        if(is_full(target, i)) {
+                            std::destroy_at(&key_at(target, i));
+                            std::destroy_at(&value_at(target, i));
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Move an item to a slot of another slot array, occupying it.
+             */
+            static constexpr void move_item(
+                slot_array &source,
+                const size_type source_index,
+                slot_array &target,
+                const size_type target_index
+            ) {
+                std::construct_at(&key_at(target, target_index), std::move(key_at(source, source_index)));
+                std::construct_at(&value_at(target, target_index), std::move(value_at(source, source_index)));
+
+                if constexpr(store_hashes) {
+                    target.hashes[target_index] = source.hashes[source_index];
+                }
+
+                set_control(target, target_index, control_of(source, source_index));
+
+                std::destroy_at(&key_at(source, source_index));
+                std::destroy_at(&value_at(source, source_index));
+            }
+
+            /**
+             * Mark a slot as occupied by a key with the given hash.
+             */
+            static constexpr void occupy_slot(slot_array &target, const size_type index, const hash_type key_hash) noexcept {
+                if constexpr(store_hashes) {
+                    target.hashes[index] = key_hash;
+                }
+
+                set_control(target, index, internal::make_control_byte(key_hash));
+            }
+
+            static constexpr key_reference key_at(const slot_array &target, const size_type index) noexcept {
+                if constexpr(interleave_items) {
+                    return target.items[index].key;
+                } else {
+                    return target.keys[index];
+                }
+            }
+
+            static constexpr value_reference value_at(const slot_array &target, const size_type index) noexcept {
+                if constexpr(interleave_items) {
+                    return target.items[index].value;
+                } else {
+                    return target.values[index];
+                }
+            }
+
+            /**
+             * Hash of the key stored in an occupied slot.
+             */
+            static constexpr hash_type slot_hash(const slot_array &target, const size_type index) {
+                if constexpr(store_hashes) {
+                    return target.hashes[index];
+                } else {
+                    return hash(key_at(target, index));
+                }
+            }
+
+            /**
+             * Assign the control byte of a slot, keeping the cloned control
+             * bytes and the item counts in sync.
+             */
+            static constexpr void set_control(
+                slot_array &target,
+                const size_type index,
+                const control_byte value
+            ) noexcept {
+                const size_type occupancy_change = internal::is_control_full(value) - is_full(target, index);
+
+                target.item_count += occupancy_change;
+
+                if(index >= target.capacity) {
+                    target.stash_count += occupancy_change;
+                    set_control_byte(target, index + cloned_control_count, value);
+
+                    return;
+                }
+
+                set_control_byte(target, index, value);
+
+                for(size_type i = index; i < cloned_control_count; i += target.capacity) {
+                    set_control_byte(target, target.capacity + i, value);
+                }
+            }
+
+            static constexpr void set_control_byte(
+                slot_array &target,
+                const size_type control_index,
+                const control_byte value
+            ) noexcept {
+                target.control[control_index] = value;
+
+                if constexpr(generational_clear) {
+                    target.generations[control_index] = target.generation;
+                }
+            }
+
+            /**
+             * Control byte of a slot. The stash control bytes follow the
+             * cloned ones.
+             */
+            static constexpr control_byte control_of(const slot_array &target, const size_type index) noexcept {
+                const size_type control_index = index < target.capacity ? index : index + cloned_control_count;
+
+                if constexpr(generational_clear) {
+                    if(target.generations[control_index] != target.generation) {
+                        return internal::control_empty;
+                    }
+                }
+
+                return target.control[control_index];
+            }
+
+            /**
+             * Load the control group starting at a control byte. The slots of
+             * past generations read as empty.
+             */
+            static constexpr control_group load_group(const slot_array &target, const size_type control_index) noexcept {
+                if constexpr(generational_clear) {
+                    return control_group{target.control + control_index, target.generations + control_index, target.generation};
+                } else {
+                    return control_group{target.control + control_index};
+                }
+            }
+
+            static constexpr bool is_full(const slot_array &target, const size_type index) noexcept {
+                return internal::is_control_full(control_of(target, index));
+            }
+
+            /**
+             * Number of slots of a slot array, stash included.
+             */
+            static constexpr size_type slot_total(const slot_array &target) noexcept {
+                return target.capacity ? target.capacity + stash_size : 0;
+            }
+
+            /**
+             * Number of control bytes of a slot array. The cloned control
+             * bytes follow the regular ones and precede those of the stash,
+             * which are padded to allow loading whole groups.
+             */
+            static constexpr size_type control_count(const size_type target_capacity) noexcept {
+                return target_capacity + cloned_control_count + stash_control_count;
+            }
+
+            /**
+             * Number of items a slot array may hold before growing.
+             */
+            static constexpr size_type max_item_count(const size_type target_capacity) noexcept {
+                return static_cast<size_type>(static_cast<float>(target_capacity) * max_load_factor);
+            }
+
+            /**
+             * Number of addressable slots. Slots of the migration source
+             * follow the current ones.
+             */
+            constexpr size_type slot_count() const noexcept {
+                if constexpr(incremental_rehash) {
+                    return slot_total(slots) + slot_total(migration.source);
+                } else {
+                    return slot_total(slots);
+                }
+            }
+
+            /**
+             * Resolve an addressable slot to its slot array and index.
+             */
+            constexpr pair<const slot_array*, size_type> resolve_slot(const size_type index) const noexcept {
+                if constexpr(incremental_rehash) {
+                    const size_type current_slot_count = slot_total(slots);
+
+                    if(index >= current_slot_count) {
+                        return { &migration.source, index - current_slot_count };
+                    }
+                }
+
+                return { &slots, index };
+            }
+
+            constexpr bool is_slot_full(const size_type index) const noexcept {
+                const auto [target, i] = resolve_slot(index);
+
+                return is_full(*target, i);
+            }
+
+            /**
+             * First occupied addressable slot at or after a given one, or
+             * `slot_count()` if there is none.
+             */
+            constexpr size_type next_full_slot(const size_type index) const noexcept {
+                const size_type current_slot_count = slot_total(slots);
+
+                if(index < current_slot_count) {
+                    const size_type next = find_full_slot(slots, index);
+
+                    if(next < current_slot_count) {
+                        return next;
+                    }
+                }
+
+                if constexpr(incremental_rehash) {
+                    const size_type source_index = index > current_slot_count ? index - current_slot_count : 0;
+
+                    return current_slot_count + find_full_slot(migration.source, source_index);
+                } else {
+                    return current_slot_count;
+                }
+            }
+
+            /**
+             * Last occupied addressable slot before a given one, or 0 if
+             * there is none.
+             */
+            constexpr size_type prev_full_slot(const size_type index) const noexcept {
+                const size_type current_slot_count = slot_total(slots);
+
+                if constexpr(incremental_rehash) {
+                    if(index > current_slot_count) {
+                        const size_type prev = find_full_slot_before(migration.source, index - current_slot_count);
+
+                        if(prev != invalid_size) {
+                            return current_slot_count + prev;
+                        }
+                    }
+                }
+
+                const size_type prev = find_full_slot_before(slots, min(index, current_slot_count));
+
+                return prev != invalid_size ? prev : 0;
+            }
+
+            /**
+             * First occupied slot of a slot array at or after a given one, or
+             * the slot total if there is none. Scans a control group at a time.
+             */
+            static constexpr size_type find_full_slot(const slot_array &target, size_type index) noexcept {
+                const size_type total = slot_total(target);
+
+                while(index < total) {
+                    const bool in_stash = index >= target.capacity;
+                    const size_type region_end = in_stash ? total : target.capacity;
+                    const size_type control_index = in_stash ? index + cloned_control_count : index;
+                    const auto full = load_group(target, control_index).match_full().limit(region_end - index);
+
+                    if(full) {
+                        return index + static_cast<size_type>(full.lowest());
+                    }
+
+                    index = min(static_cast<size_type>(index + control_group::width), region_end);
+                }
+
+                return total;
+            }
+
+            /**
+             * Last occupied slot of a slot array before a given one, or
+             * `invalid_size` if there is none. Scans a control group at a time.
+             */
+            static constexpr size_type find_full_slot_before(const slot_array &target, size_type index) noexcept {
+                index = min(index, slot_total(target));
+
+                while(index > 0) {
+                    const bool in_stash = index > target.capacity;
+                    const size_type region_start = in_stash ? target.capacity : 0;
+                    const size_type group_start = index - region_start > control_group::width ? index - control_group::width : region_start;
+                    const size_type control_index = in_stash ? group_start + cloned_control_count : group_start;
+                    const auto full = load_group(target, control_index).match_full().limit(index - group_start);
+
+                    if(full) {
+                        return group_start + static_cast<size_type>(full.highest());
+                    }
+
+                    index = group_start;
+                }
+
+                return invalid_size;
+            }
+
+            constexpr key_reference slot_key(const size_type index) const noexcept {
+                const auto [target, i] = resolve_slot(index);
+
+                return key_at(*target, i);
+            }
+
+            constexpr value_reference slot_value(const size_type index) const noexcept {
+                const auto [target, i] = resolve_slot(index);
+
+                return value_at(*target, i);
+            }
+
+            /**
+             * Hash of the key of an occupied addressable slot.
+             */
+            constexpr hash_type slot_key_hash(const size_type index) const {
+                const auto [target, i] = resolve_slot(index);
+
+                return slot_hash(*target, i);
+            }
+
+            /**
+             * Move the item of an addressable slot to a node, and erase it.
+             */
+            constexpr node_type extract_slot(const size_type index, const hash_type key_hash) {
+                node_type node{std::move(slot_key(index)), std::move(slot_value(index)), key_hash};
+
+                erase_slot(index);
+
+                return node;
+            }
+
+            constexpr void erase_slot(const size_type index) {
+                if constexpr(incremental_rehash) {
+                    const size_type current_slot_count = slot_total(slots);
+
+                    if(index >= current_slot_count) {
+                        clear_slot(migration.source, index - current_slot_count);
+                        return;
+                    }
+                }
+
+                clear_slot(slots, index);
+            }
+
+            static constexpr void clear_slot(slot_array &target, const size_type index) {
+                std::destroy_at(&key_at(target, index));
+                std::destroy_at(&value_at(target, index));
+                set_control(target, index, internal::control_deleted);
             }
 
-            static hash_type hash(const_key_reference x) {
+            template<typename Q = K>
+            static hash_type hash(const Q& x) {
                 return hash_function_type{}(x);
             }
 
@@ -588,15 +2125,29 @@ namespace ccl {
                 return index & (capacity - 1);
             }
 
-            static constexpr size_type compute_key_index(const_key_reference x, const size_type capacity) {
-                return wrap_index(hash(x), capacity);
+            /**
+             * First slot of the chunk of a hash.
+             *
+             * The slot is taken from the bits of the mixed hash right below
+             * those stored in the control bytes. Hashes that only differ in
+             * their high bits, such as identity hashes of strided integers,
+             * are spread over the whole table.
+             *
+             * Empty slot arrays yield an index that is never used, as their
+             * probe length is 0. Looking a key up in an empty table thus takes
+             * no extra branch.
+             */
+            static constexpr size_type home_index(const hash_type key_hash, const size_type capacity) {
+                const unsigned capacity_bits = static_cast<unsigned>(std::countr_zero(capacity));
+
+                return static_cast<size_type>(
+                    internal::mix_hash(key_hash) >> (internal::control_hash_shift - capacity_bits)
+                ) & (capacity - 1);
             }
 
-            size_type _capacity = 0;
-            size_type chunk_size = default_chunk_size;
-            bitset<allocator_type> slot_map; // Slot availability bit map
-            key_pointer keys = nullptr;
-            value_pointer values = nullptr;
+            slot_array slots;
+            CCLZEROSIZE either_or_t<migration_state, no_migration_state, incremental_rehash> migration;
+            CCLZEROSIZE mutable internal::hash_stats_recorder stats;
             allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS;
 
             static constexpr size_type invalid_size = ~static_cast<size_type>(0);
@@ -6,7 +6,11 @@
 #ifndef CCL_I18N_LANGUAGE_HPP
 #define CCL_I18N_LANGUAGE_HPP
 
+#include <string_view>
+#include <utility>
 #include <ccl/api.hpp>
+#include <ccl/hash.hpp>
+#include <ccl/static-map.hpp>
 
 namespace ccl::i18n {
     /**
@@ -390,6 +394,44 @@ namespace ccl::i18n {
         "zh",
         "zu"
     };
+
+    /**
+     * Number of languages, `LANGUAGE_NONE` excluded.
+     */
+    static constexpr std::size_t language_count = std::size(iso639_1_language_codes) - 1;
+
+    namespace internal {
+        template<std::size_t ...I>
+        constexpr auto make_iso639_1_language_map(std::index_sequence<I...>) {
+            using item_type = pair<std::string_view, language>;
+
+            const item_type items[] = {
+                item_type{iso639_1_language_codes[I + 1], static_cast<language>(I + 1)}...
+            };
+
+            return static_map<std::string_view, language, language_count, string_hash<>>{items};
+        }
+    }
+
+    /**
+     * ISO639-1 language code mapping [char[] -> ccl::language].
+     */
+    static constexpr auto iso639_1_languages = internal::make_iso639_1_language_map(
+        std::make_index_sequence<language_count>{}
+    );
+
+    /**
+     * Get the language of an ISO639-1 code.
+     *
+     * @param code The two-letter language code.
+     *
+     * @return The language, or `LANGUAGE_NONE` if the code is unknown.
+     */
+    constexpr language language_from_iso639_1(const std::string_view code) noexcept {
+        const language * const result = iso639_1_languages.find(code);
+
+        return result ? *result : LANGUAGE_NONE;
+    }
 }
 
 #endif /* CCL_I18N_LANGUAGE_HPP */
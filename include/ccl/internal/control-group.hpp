@@ -0,0 +1,303 @@
+/**
+ * @file
+ *
+ * Hash table control bytes.
+ *
+ * Every slot of an open-addressed table is described by one control byte.
+ * The most significant bit tells whether the slot is occupied and the
+ * remaining 7 bits hold a fragment of the key hash. Vacant slots are either
+ * empty, or deleted if they held an item that was erased. A group of consecutive
+ * control bytes can be matched against a hash fragment at once, rejecting
+ * most non-matching slots before any key is compared.
+ *
+ * Groups can also be loaded along with a generation byte per slot, in which
+ * case the slots of any other generation than the given one read as empty.
+ */
+#ifndef CCL_INTERNAL_CONTROL_GROUP_HPP
+#define CCL_INTERNAL_CONTROL_GROUP_HPP
+
+#include <bit>
+#include <ccl/api.hpp>
+#include <ccl/hash.hpp>
+
+#ifdef CCL_FEATURE_SIMD
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+
+        #define CCL_CONTROL_GROUP_AVX2
+    #elif defined(__SSE2__) || defined(_M_X64)
+        #include <emmintrin.h>
+
+        #define CCL_CONTROL_GROUP_SSE2
+    #endif
+#endif // CCL_FEATURE_SIMD
+
+namespace ccl::internal {
+    using control_byte = uint8_t;
+
+    /**
+     * Control byte of an empty slot.
+     */
+    static constexpr control_byte control_empty = 0;
+
+    /**
+     * Control byte of a slot whose item was erased. Lookups probe past
+     * deleted slots, while insertions may reuse them.
+     */
+    static constexpr control_byte control_deleted = 1;
+
+    /**
+     * Control byte bit marking a slot as occupied.
+     */
+    static constexpr control_byte control_full_bit = 0x80;
+
+    /**
+     * Position of the first bit of a mixed hash stored in control bytes.
+     */
+    static constexpr unsigned control_hash_shift = 57;
+
+    /**
+     * Multiplicative mix of a hash, spreading all of its bits over the
+     * most significant ones.
+     */
+    constexpr uint64_t mix_hash(const hash_t hash) noexcept {
+        constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+
+        return static_cast<uint64_t>(hash) * multiplier;
+    }
+
+    /**
+     * Compute the control byte of an occupied slot.
+     *
+     * The low bits of a hash select the slot, so the 7 bits stored in the
+     * control byte are taken from a multiplicative mix of the whole hash to
+     * stay informative for keys sharing the same slot.
+     *
+     * @param hash The key hash.
+     *
+     * @return The control byte.
+     */
+    constexpr control_byte make_control_byte(const hash_t hash) noexcept {
+        return control_full_bit | static_cast<control_byte>(mix_hash(hash) >> control_hash_shift);
+    }
+
+    /**
+     * Check whether a control byte represents an occupied slot.
+     */
+    constexpr bool is_control_full(const control_byte c) noexcept {
+        return c & control_full_bit;
+    }
+
+    /**
+     * A set of matching lanes within a control group.
+     *
+     * @tparam MaskType The underlying mask type.
+     * @tparam LaneShift Log2 of the number of mask bits per lane.
+     */
+    template<typename MaskType, std::size_t LaneShift>
+    class control_mask {
+        public:
+            using mask_type = MaskType;
+
+            static constexpr std::size_t lane_shift = LaneShift;
+            static constexpr std::size_t lane_count = (sizeof(mask_type) * 8) >> lane_shift;
+
+        private:
+            mask_type bits;
+
+        public:
+            explicit constexpr control_mask(const mask_type bits) noexcept : bits{bits} {}
+
+            constexpr explicit operator bool() const noexcept { return bits != 0; }
+
+            /**
+             * Index of the first matching lane. The mask must not be empty.
+             */
+            constexpr std::size_t lowest() const noexcept {
+                return static_cast<std::size_t>(std::countr_zero(bits)) >> lane_shift;
+            }
+
+            /**
+             * Index of the last matching lane. The mask must not be empty.
+             */
+            constexpr std::size_t highest() const noexcept {
+                return static_cast<std::size_t>(std::bit_width(bits) - 1) >> lane_shift;
+            }
+
+            /**
+             * Remove the first matching lane.
+             */
+            constexpr void clear_lowest() noexcept {
+                bits &= bits - 1;
+            }
+
+            /**
+             * Restrict the mask to the first `n` lanes.
+             */
+            constexpr control_mask limit(const std::size_t n) const noexcept {
+                if(n >= lane_count) {
+                    return *this;
+                }
+
+                return control_mask{
+                    static_cast<mask_type>(bits & ((static_cast<mask_type>(1) << (n << lane_shift)) - 1))
+                };
+            }
+
+            constexpr mask_type get_bits() const noexcept { return bits; }
+    };
+
+#if defined(CCL_CONTROL_GROUP_AVX2)
+    /**
+     * A group of 32 control bytes, matched with AVX2.
+     */
+    class control_group {
+        __m256i bytes;
+
+        public:
+            using mask = control_mask<uint32_t, 0>;
+
+            static constexpr std::size_t width = 32;
+
+            explicit control_group(const control_byte * const data) noexcept
+                : bytes{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data))}
+            {}
+
+            control_group(
+                const control_byte * const data,
+                const control_byte * const generations,
+                const control_byte generation
+            ) noexcept
+                : bytes{_mm256_and_si256(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)),
+                    _mm256_cmpeq_epi8(
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(generations)),
+                        _mm256_set1_epi8(static_cast<char>(generation))
+                    )
+                )}
+            {}
+
+            mask match(const control_byte c) const noexcept {
+                const __m256i pattern = _mm256_set1_epi8(static_cast<char>(c));
+
+                return mask{static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, pattern)))};
+            }
+
+            mask match_empty() const noexcept {
+                return match(control_empty);
+            }
+
+            mask match_vacant() const noexcept {
+                return mask{~static_cast<uint32_t>(_mm256_movemask_epi8(bytes))};
+            }
+
+            mask match_full() const noexcept {
+                return mask{static_cast<uint32_t>(_mm256_movemask_epi8(bytes))};
+            }
+    };
+#elif defined(CCL_CONTROL_GROUP_SSE2)
+    /**
+     * A group of 16 control bytes, matched with SSE2.
+     */
+    class control_group {
+        __m128i bytes;
+
+        public:
+            using mask = control_mask<uint16_t, 0>;
+
+            static constexpr std::size_t width = 16;
+
+            explicit control_group(const control_byte * const data) noexcept
+                : bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))}
+            {}
+
+            control_group(
+                const control_byte * const data,
+                const control_byte * const generations,
+                const control_byte generation
+            ) noexcept
+                : bytes{_mm_and_si128(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)),
+                    _mm_cmpeq_epi8(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(generations)),
+                        _mm_set1_epi8(static_cast<char>(generation))
+                    )
+                )}
+            {}
+
+            mask match(const control_byte c) const noexcept {
+                const __m128i pattern = _mm_set1_epi8(static_cast<char>(c));
+
+                return mask{static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, pattern)))};
+            }
+
+            mask match_empty() const noexcept {
+                return match(control_empty);
+            }
+
+            mask match_vacant() const noexcept {
+                return mask{static_cast<uint16_t>(~_mm_movemask_epi8(bytes))};
+            }
+
+            mask match_full() const noexcept {
+                return mask{static_cast<uint16_t>(_mm_movemask_epi8(bytes))};
+            }
+    };
+#else
+    /**
+     * A group of 8 control bytes, matched within a 64-bit word.
+     *
+     * `match()` may report false positives for lanes following a true
+     * match. Callers compare keys anyway, so these are harmless.
+     */
+    class control_group {
+        uint64_t bytes;
+
+        static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+        static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+        public:
+            using mask = control_mask<uint64_t, 3>;
+
+            static constexpr std::size_t width = 8;
+
+            explicit constexpr control_group(const control_byte * const data) noexcept : bytes{0} {
+                for(std::size_t i = 0; i < width; ++i) {
+                    bytes |= static_cast<uint64_t>(data[i]) << (i * 8);
+                }
+            }
+
+            constexpr control_group(
+                const control_byte * const data,
+                const control_byte * const generations,
+                const control_byte generation
+            ) noexcept : bytes{0} {
+                for(std::size_t i = 0; i < width; ++i) {
+                    const control_byte c = generations[i] == generation ? data[i] : control_empty;
+
+                    bytes |= static_cast<uint64_t>(c) << (i * 8);
+                }
+            }
+
+            constexpr mask match(const control_byte c) const noexcept {
+                const uint64_t x = bytes ^ (lsbs * c);
+
+                return mask{(x - lsbs) & ~x & msbs};
+            }
+
+            constexpr mask match_empty() const noexcept {
+                return match(control_empty);
+            }
+
+            constexpr mask match_vacant() const noexcept {
+                return mask{~bytes & msbs};
+            }
+
+            constexpr mask match_full() const noexcept {
+                return mask{bytes & msbs};
+            }
+    };
+#endif
+}
+
+#endif // CCL_INTERNAL_CONTROL_GROUP_HPP
@@ -0,0 +1,125 @@
+/**
+ * @file
+ *
+ * Merge of sorted sequences of distinct items.
+ *
+ * Sequences of 32-bit integers are merged four items at a time: a block of
+ * each sequence is compared all-against-all with one equality test per
+ * rotation of the other block, and the block with the lowest last item is
+ * moved past.
+ */
+#ifndef CCL_INTERNAL_SORTED_MERGE_HPP
+#define CCL_INTERNAL_SORTED_MERGE_HPP
+
+#include <concepts>
+#include <span>
+#include <type_traits>
+#include <ccl/api.hpp>
+#include <ccl/features.hpp>
+
+#ifdef CCL_FEATURE_SIMD
+    #if defined(__SSE2__) || defined(_M_X64)
+        #include <emmintrin.h>
+
+        #define CCL_SORTED_MERGE_SSE2
+    #endif
+#endif // CCL_FEATURE_SIMD
+
+namespace ccl::internal {
+    /**
+     * Invoke a membership visitor. Visitors may return a boolean, false
+     * stopping the visit, or nothing to visit all the items.
+     *
+     * @return False if the visitor asked to stop.
+     */
+    template<typename T, typename Visitor>
+    constexpr bool visit_membership(Visitor &visitor, const T &item, const bool is_member) {
+        if constexpr(std::is_void_v<std::invoke_result_t<Visitor&, const T&, bool>>) {
+            visitor(item, is_member);
+
+            return true;
+        } else {
+            return static_cast<bool>(visitor(item, is_member));
+        }
+    }
+
+    /**
+     * Visit the items of a sorted sequence, telling whether each of them is
+     * present in another sorted sequence. Both sequences must be sorted in
+     * ascending order and hold distinct items.
+     *
+     * @param items The items to visit.
+     * @param other The items to look for.
+     * @param visitor A function invoked as `visitor(item, is_in_other)` for
+     *  each item of `items`, in order. Returning false stops the visit.
+     *
+     * @return False if the visitor stopped the visit.
+     */
+    template<std::totally_ordered T, typename Visitor>
+    constexpr bool for_each_sorted_membership(
+        const std::span<const T> items,
+        const std::span<const T> other,
+        Visitor&& visitor
+    ) {
+        std::size_t i = 0;
+        std::size_t j = 0;
+        unsigned block_matches = 0; // Matches of the items in [i, i + 4) found so far
+
+#ifdef CCL_SORTED_MERGE_SSE2
+        if constexpr(std::integral<T> && sizeof(T) == 4) {
+            if(!std::is_constant_evaluated()) {
+                while(i + 4 <= items.size() && j + 4 <= other.size()) {
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(items.data() + i));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(other.data() + j));
+
+                    __m128i eq = _mm_cmpeq_epi32(a, b);
+
+                    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1))));
+                    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 3, 2))));
+                    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 1, 0, 3))));
+
+                    block_matches |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+
+                    const T a_last = items[i + 3];
+                    const T b_last = other[j + 3];
+
+                    // The items of the other sequence past the block are all
+                    // greater than its last one: no more matches for this block.
+                    if(a_last <= b_last) {
+                        for(std::size_t k = 0; k < 4; ++k) {
+                            if(!visit_membership(visitor, items[i + k], ((block_matches >> k) & 1) != 0)) {
+                                return false;
+                            }
+                        }
+
+                        i += 4;
+                        block_matches = 0;
+                    }
+
+                    if(b_last <= a_last) {
+                        j += 4;
+                    }
+                }
+            }
+        }
+#endif // CCL_SORTED_MERGE_SSE2
+
+        for(std::size_t k = i; k < items.size(); ++k) {
+            const T &item = items[k];
+
+            while(j < other.size() && other[j] < item) {
+                ++j;
+            }
+
+            const bool is_block_match = k - i < 4 && ((block_matches >> (k - i)) & 1);
+
+            if(!visit_membership(visitor, item, is_block_match || (j < other.size() && other[j] == item))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+#endif // CCL_INTERNAL_SORTED_MERGE_HPP
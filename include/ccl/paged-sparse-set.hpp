@@ -0,0 +1,363 @@
+/**
+ * @file
+ *
+ * Sparse set of unsigned integral IDs, indexed by a paged array.
+ */
+#ifndef CCL_PAGED_SPARSE_SET_HPP
+#define CCL_PAGED_SPARSE_SET_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <ccl/api.hpp>
+#include <ccl/debug.hpp>
+#include <ccl/definitions.hpp>
+#include <ccl/exceptions.hpp>
+#include <ccl/paged-vector.hpp>
+#include <ccl/vector.hpp>
+#include <ccl/memory/allocator.hpp>
+#include <ccl/concepts.hpp>
+#include <ccl/util.hpp>
+#include <ccl/internal/optional-allocator.hpp>
+
+namespace ccl {
+    /**
+     * A sparse set of unsigned integral IDs.
+     *
+     * IDs are stored contiguously in a dense array. A sparse array, indexed
+     * by ID, holds the position of each ID in the dense array. The sparse
+     * array is split in pages of `CCL_PAGE_SIZE` indices, allocated the first
+     * time one of their IDs is inserted, so that sparse ID spaces only pay
+     * for the pages they use.
+     *
+     * Looking up or removing an ID takes two array reads and no hashing.
+     * Removing an ID moves the last one in its place: the dense array is
+     * not kept in insertion order.
+     *
+     * @tparam T The ID type.
+     * @tparam Allocator The allocator type.
+     */
+    template<
+        std::unsigned_integral T,
+        typed_allocator<T> Allocator = allocator
+    > class paged_sparse_set : internal::with_optional_allocator<Allocator> {
+        public:
+            using value_type = T;
+            using pointer = T*;
+            using const_pointer = const T*;
+            using allocator_type = Allocator;
+            using size_type = count_t;
+
+            static constexpr size_type page_size = CCL_PAGE_SIZE;
+            static constexpr size_type page_size_shift_width = bitcount(page_size) - 1;
+
+            /**
+             * Dense index of the IDs not in the set.
+             */
+            static constexpr size_type invalid_index = std::numeric_limits<size_type>::max();
+
+            /**
+             * Largest ID the set can hold. Wider IDs are rejected on insertion,
+             * so that the page table never holds more than 2^32 / `page_size`
+             * page pointers.
+             */
+            static constexpr T max_id = static_cast<T>(
+                std::min<uint64_t>(std::numeric_limits<T>::max(), std::numeric_limits<size_type>::max())
+            );
+
+            static_assert(is_power_2(page_size));
+
+        private:
+            using alloc = internal::with_optional_allocator<Allocator>;
+            using page_pointer = size_type*;
+            using page_vector_type = vector<page_pointer, allocator_type>;
+            using data_vector_type = vector<T, allocator_type>;
+            using cloner = page_cloner<size_type, page_pointer, allocator_type>;
+
+            page_vector_type _pages;
+            data_vector_type _data;
+
+        public:
+            constexpr paged_sparse_set(
+                const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
+                allocator_type * const allocator = nullptr
+            ) : alloc{allocator}, _pages{alloc_flags, allocator}, _data{alloc_flags, allocator}
+            {}
+
+            constexpr paged_sparse_set(const paged_sparse_set &other)
+                : alloc{other.get_allocator()},
+                _pages{other.get_allocation_flags(), other.get_allocator()},
+                _data{other._data}
+            {
+                clone_pages_from(other);
+            }
+
+            constexpr paged_sparse_set(paged_sparse_set &&other)
+                : alloc{other.get_allocator()},
+                _pages{std::move(other._pages)},
+                _data{std::move(other._data)}
+            {}
+
+            /**
+             * Initialise a set from a range of IDs. Sized ranges are stored
+             * without growing the dense array while inserting.
+             *
+             * @param input The IDs to insert.
+             */
+            template<std::ranges::input_range InputRange>
+            requires (!std::same_as<std::remove_cvref_t<InputRange>, paged_sparse_set>)
+            constexpr paged_sparse_set(
+                InputRange&& input,
+                const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
+                allocator_type * const allocator = nullptr
+            ) : paged_sparse_set{alloc_flags, allocator} {
+                if constexpr(std::ranges::sized_range<InputRange>) {
+                    reserve(static_cast<size_type>(std::ranges::size(input)));
+                }
+
+                for(const T id : input) {
+                    insert(id);
+                }
+            }
+
+            constexpr ~paged_sparse_set() {
+                destroy_pages();
+            }
+
+            constexpr paged_sparse_set& operator =(const paged_sparse_set &other) {
+                if(this != &other) {
+                    destroy_pages();
+                    alloc::operator=(other);
+
+                    _data = other._data;
+                    clone_pages_from(other);
+                }
+
+                return *this;
+            }
+
+            constexpr paged_sparse_set& operator =(paged_sparse_set &&other) {
+                if(this != &other) {
+                    // Pages are released through the allocator that made them,
+                    // before taking the allocator of the other set.
+                    destroy();
+                    alloc::operator=(std::move(other));
+
+                    _pages = std::move(other._pages);
+                    _data = std::move(other._data);
+                }
+
+                return *this;
+            }
+
+            /**
+             * Grow the dense array ahead of holding a number of IDs.
+             *
+             * @param item_count The number of IDs.
+             */
+            constexpr void reserve(const size_type item_count) {
+                _data.reserve(item_count);
+            }
+
+            /**
+             * Insert an ID, unless already present.
+             *
+             * @param id The ID to insert.
+             *
+             * @return True if the ID was inserted, false if it was already present.
+             */
+            constexpr bool insert(const T id) {
+                size_type &index = sparse_entry(id);
+
+                if(index != invalid_index) {
+                    return false;
+                }
+
+                CCL_THROW_IF(_data.size() == invalid_index, std::out_of_range{"Set full."});
+
+                _data.push_back(id);
+                index = _data.size() - 1;
+
+                return true;
+            }
+
+            /**
+             * Remove an ID, if present. The last ID of the dense array takes
+             * the place of the removed one.
+             *
+             * @param id The ID to remove.
+             *
+             * @return True if the ID was present, false otherwise.
+             */
+            constexpr bool remove(const T id) {
+                size_type * const entry = find_entry(id);
+
+                if(!entry || *entry == invalid_index) {
+                    return false;
+                }
+
+                const size_type index = *entry;
+                const size_type last_index = _data.size() - 1;
+
+                if(index != last_index) {
+                    const T last_id = _data.data()[last_index];
+
+                    _data.data()[index] = last_id;
+                    *find_entry(last_id) = index;
+                }
+
+                *entry = invalid_index;
+                _data.erase(_data.end() - 1);
+
+                return true;
+            }
+
+            /**
+             * Remove all the IDs of a range, if present.
+             *
+             * @param input The IDs to remove.
+             *
+             * @return The number of IDs removed.
+             */
+            template<std::ranges::input_range InputRange>
+            constexpr size_type remove_all(InputRange&& input) {
+                size_type count = 0;
+
+                for(const T id : input) {
+                    count += remove(id);
+                }
+
+                return count;
+            }
+
+            CCLNODISCARD constexpr bool contains(const T id) const noexcept {
+                return index_of(id) != invalid_index;
+            }
+
+            /**
+             * Get the position of an ID in the dense array.
+             *
+             * @param id The ID.
+             *
+             * @return The index of the ID or `invalid_index` if not present.
+             */
+            CCLNODISCARD constexpr size_type index_of(const T id) const noexcept {
+                const size_type * const entry = find_entry(id);
+
+                return entry ? *entry : invalid_index;
+            }
+
+            /**
+             * Remove all the IDs. Allocated pages are kept.
+             */
+            constexpr void clear() noexcept {
+                for(const T id : _data) {
+                    *find_entry(id) = invalid_index;
+                }
+
+                _data.clear();
+            }
+
+            /**
+             * Remove all the IDs and release all the allocated memory.
+             */
+            constexpr void destroy() noexcept {
+                destroy_pages();
+                _data.destroy();
+            }
+
+            constexpr decltype(auto) begin() { return _data.begin(); }
+            constexpr decltype(auto) begin() const { return _data.begin(); }
+            constexpr decltype(auto) end() { return _data.end(); }
+            constexpr decltype(auto) end() const { return _data.end(); }
+
+            constexpr decltype(auto) cbegin() const { return _data.cbegin(); }
+            constexpr decltype(auto) cend() const { return _data.cend(); }
+
+            constexpr size_type size() const noexcept { return _data.size(); }
+            constexpr bool is_empty() const noexcept { return _data.is_empty(); }
+
+            constexpr pointer data() noexcept { return _data.data(); }
+            constexpr const_pointer data() const noexcept { return _data.data(); }
+
+            /**
+             * Number of sparse array pages, allocated or not.
+             */
+            constexpr size_type page_count() const noexcept { return _pages.size(); }
+
+            constexpr allocator_type* get_allocator() const noexcept { return alloc::get_allocator(); }
+            constexpr allocation_flags get_allocation_flags() const noexcept { return _data.get_allocation_flags(); }
+
+        private:
+            static constexpr size_type index_in_page(const T id) noexcept {
+                return static_cast<size_type>(id & (page_size - 1));
+            }
+
+            /**
+             * Find the sparse array entry of an ID.
+             *
+             * @return A pointer to the entry, or nullptr if its page is not allocated.
+             */
+            constexpr size_type* find_entry(const T id) const noexcept {
+                const T page_index = id >> page_size_shift_width;
+
+                if(page_index >= _pages.size()) {
+                    return nullptr;
+                }
+
+                const page_pointer page = _pages.data()[page_index];
+
+                return page ? page + index_in_page(id) : nullptr;
+            }
+
+            /**
+             * Get the sparse array entry of an ID, allocating its page.
+             */
+            constexpr size_type& sparse_entry(const T id) {
+                if constexpr(sizeof(T) > sizeof(size_type)) {
+                    CCL_THROW_IF(id > max_id, std::out_of_range{"ID out of range."});
+                }
+
+                const T page_index = id >> page_size_shift_width;
+
+                if(page_index >= _pages.size()) {
+                    _pages.resize(static_cast<size_type>(page_index + 1), nullptr);
+                }
+
+                page_pointer &page = _pages.data()[page_index];
+
+                if(!page) {
+                    page = alloc::get_allocator()->template allocate<size_type>(page_size, get_allocation_flags());
+                    std::fill(page, page + page_size, invalid_index);
+                }
+
+                return page[index_in_page(id)];
+            }
+
+            constexpr void clone_pages_from(const paged_sparse_set &other) {
+                const cloner cloner{get_allocation_flags(), alloc::get_allocator()};
+
+                _pages.resize(other._pages.size(), nullptr);
+
+                for(size_type i = 0; i < other._pages.size(); ++i) {
+                    if(other._pages.data()[i]) {
+                        _pages.data()[i] = cloner.clone(other._pages.data()[i]);
+                    }
+                }
+            }
+
+            constexpr void destroy_pages() noexcept {
+                for(const page_pointer page : _pages) {
+                    if(page) {
+                        alloc::get_allocator()->deallocate(page);
+                    }
+                }
+
+                _pages.destroy();
+            }
+    };
+}
+
+#endif // CCL_PAGED_SPARSE_SET_HPP
@@ -683,8 +683,9 @@ namespace ccl {
 
                 static_assert(std::is_move_assignable_v<T>);
 
-                std::move(finish, end(), start);
-                std::destroy(finish, end());
+                const iterator new_end = std::move(finish, end(), start);
+
+                std::destroy(new_end, end());
 
                 _size -= finish - start;
             }
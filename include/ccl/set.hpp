@@ -8,12 +8,17 @@
 
 #include <initializer_list>
 #include <algorithm>
+#include <bit>
+#include <cstring>
+#include <ranges>
+#include <span>
 #include <ccl/api.hpp>
 #include <ccl/definitions.hpp>
 #include <ccl/memory/allocator.hpp>
 #include <ccl/concepts.hpp>
 #include <ccl/internal/optional-allocator.hpp>
 #include <ccl/hash.hpp>
+#include <ccl/hash-stats.hpp>
 #include <ccl/bitset.hpp>
 #include <ccl/util.hpp>
 
@@ -38,11 +43,7 @@ namespace ccl {
         explicit constexpr set_iterator(set_type& set, const size_type item_index) noexcept : set{&set}, index{item_index} {
             // Ensure we are actually pointing at an existing value or at the end.
             // Useful for `begin()` iterators.
-            for(; index < set._capacity; ++index) {
-                if(set.slot_map[index]) {
-                    return;
-                }
-            }
+            index = set.next_full_slot(index);
         }
 
         constexpr set_iterator(const set_iterator &other) noexcept : set{other.set}, index{other.index} {}
@@ -61,13 +62,7 @@ namespace ccl {
         }
 
         constexpr auto& operator --() noexcept {
-            do {
-                if(index == 0) {
-                    break;
-                }
-
-                index--;
-            } while(!set->slot_map[index]);
+            index = set->prev_full_slot(index);
 
             return *this;
         }
@@ -75,21 +70,13 @@ namespace ccl {
         constexpr auto operator --(int) noexcept {
             const size_type old_index = this->index;
 
-            do {
-                if(index == 0) {
-                    break;
-                }
-
-                index--;
-            } while(!set->slot_map[index]);
+            index = set->prev_full_slot(index);
 
             return set_iterator{*set, old_index};
         }
 
         constexpr auto& operator ++() noexcept {
-            do {
-                index++;
-            } while(index < set->_capacity && !set->slot_map[index]);
+            index = set->next_full_slot(index + 1);
 
             return *this;
         }
@@ -97,9 +84,7 @@ namespace ccl {
         constexpr auto operator ++(int) noexcept {
             const size_type old_index = index;
 
-            do {
-                index++;
-            } while(index < set->_capacity && !set->slot_map[index]);
+            index = set->next_full_slot(index + 1);
 
             return set_iterator{*set, old_index};
         }
@@ -146,17 +131,70 @@ namespace ccl {
         return a.index <= b.index;
     }
 
+    /**
+     * Default set policy.
+     */
+    struct default_set_policy {
+        /**
+         * Capacity of the first slots allocated. Must be a power of two.
+         */
+        static constexpr count_t minimum_capacity = CCL_SET_MINIMUM_CAPACITY;
+
+        /**
+         * Number of consecutive slots a key may be stored in. The set grows
+         * when all the slots of a chunk are occupied. Must be lower than
+         * the minimum capacity.
+         */
+        static constexpr count_t chunk_size = CCL_SET_KEY_CHUNK_SIZE;
+
+        /**
+         * Fraction of the capacity that can be occupied before growing.
+         * At 1, the set only grows when a chunk is full.
+         */
+        static constexpr float max_load_factor = 1.0f;
+
+        /**
+         * Factor the capacity is multiplied by when growing. Must be a
+         * power of two, greater than 1.
+         */
+        static constexpr count_t growth_factor = 2;
+
+        /**
+         * Clear in constant time. Every cluster of the slot map is stamped
+         * with the generation it was last written in, and clearing starts a
+         * new generation: the clusters of the previous ones then read as
+         * empty, without being touched. This costs a byte per cluster of
+         * 64 slots, and requires trivially destructible keys since the
+         * cleared keys are never destroyed.
+         */
+        static constexpr bool generational_clear = false;
+
+        /**
+         * Low watermark of the load factor. Erasing a key by value shrinks
+         * the set as by `shrink_to_fit()` once its load factor falls below
+         * this value and halved since the last shrink. Must stay below a
+         * quarter of the maximum load factor, so that shrinking and growing
+         * back do not alternate. 0 never shrinks.
+         */
+        static constexpr float shrink_load_factor = 0.0f;
+    };
+
     /**
      * An unordered set.
      *
+     * The slot map, marking the occupied slots, and the keys are stored
+     * in a single block.
+     *
      * @tparam K Key type.
      * @tparam HashFunction The function used to compute the key hashes.
      * @tparam Allocator The allocator type.
+     * @tparam Policy The set policy.
      */
     template<
         typename K,
         typename HashFunction = hash<K>,
-        typed_allocator<K> Allocator = allocator
+        typed_allocator<K> Allocator = allocator,
+        typename Policy = default_set_policy
     >
     requires typed_allocator<Allocator, K> && std::equality_comparable<K>
     class set : private internal::with_optional_allocator<Allocator> {
@@ -164,6 +202,24 @@ namespace ccl {
         friend struct set_iterator<const set>;
 
         using alloc = internal::with_optional_allocator<Allocator>;
+        using slot_cluster_type = uint64_t;
+        using generation_type = uint8_t;
+
+        static constexpr std::size_t slot_cluster_bits = sizeof(slot_cluster_type) * 8;
+
+        /**
+         * Clusters of a slot map stamped with generations. Clusters of past
+         * generations read as empty.
+         */
+        struct stamped_clusters {
+            const slot_cluster_type *map;
+            const generation_type *generations;
+            generation_type generation;
+
+            constexpr slot_cluster_type operator [](const std::size_t index) const noexcept {
+                return generations[index] == generation ? map[index] : 0;
+            }
+        };
 
         public:
             using size_type = count_t;
@@ -177,33 +233,128 @@ namespace ccl {
             using hash_function_type = HashFunction;
 
             using allocator_type = Allocator;
+            using policy_type = Policy;
 
             using iterator = set_iterator<set>;
             using const_iterator = set_iterator<const set>;
 
-            static constexpr size_type minimum_capacity = CCL_SET_MINIMUM_CAPACITY;
+            static constexpr size_type minimum_capacity = policy_type::minimum_capacity;
+            static constexpr size_type chunk_size = policy_type::chunk_size;
+            static constexpr float max_load_factor = policy_type::max_load_factor;
+            static constexpr size_type growth_factor = policy_type::growth_factor;
+            static constexpr size_type batch_size = CCL_HASH_BATCH_SIZE;
+            static constexpr bool generational_clear = policy_type::generational_clear;
+            static constexpr float shrink_load_factor = policy_type::shrink_load_factor;
+
+            static_assert(
+                !generational_clear || std::is_trivially_destructible_v<K>,
+                "Clearing by generation requires trivially destructible keys."
+            );
+
+            static_assert(minimum_capacity > 0 && is_power_2(minimum_capacity), "Minimum capacity must be a power of two.");
+            static_assert(chunk_size > 0 && chunk_size < minimum_capacity, "Chunk size must be positive and lower than the minimum capacity.");
+            static_assert(growth_factor > 1 && is_power_2(growth_factor), "Growth factor must be a power of two greater than 1.");
+            static_assert(max_load_factor > 0 && max_load_factor <= 1, "Maximum load factor must be between 0 and 1.");
+            static_assert(
+                shrink_load_factor >= 0 && shrink_load_factor < max_load_factor / 4,
+                "Shrink load factor must be between 0 and a quarter of the maximum load factor."
+            );
+
+            /**
+             * A key extracted from a set, owning it. The key hash is kept
+             * along, so that inserting the node does not hash the key again.
+             */
+            class node_type {
+                friend class set;
+
+                union { K node_key; };
+                hash_type key_hash = 0;
+                bool has_key = false;
+
+                constexpr node_type(K&& key, const hash_type key_hash)
+                    : node_key{std::move(key)},
+                    key_hash{key_hash},
+                    has_key{true}
+                {}
+
+                public:
+                    constexpr node_type() noexcept {}
+
+                    constexpr node_type(node_type &&other) : key_hash{other.key_hash}, has_key{other.has_key} {
+                        if(has_key) {
+                            std::construct_at(&node_key, std::move(other.node_key));
+                            other.reset();
+                        }
+                    }
+
+                    node_type(const node_type &other) = delete;
+                    node_type& operator =(const node_type &other) = delete;
+
+                    constexpr node_type& operator =(node_type &&other) {
+                        if(this != &other) {
+                            reset();
+
+                            if(other.has_key) {
+                                std::construct_at(&node_key, std::move(other.node_key));
+                                key_hash = other.key_hash;
+                                has_key = true;
+                                other.reset();
+                            }
+                        }
+
+                        return *this;
+                    }
+
+                    constexpr ~node_type() {
+                        reset();
+                    }
+
+                    /**
+                     * Destroy the key, if any.
+                     */
+                    constexpr void reset() noexcept {
+                        if(has_key) {
+                            std::destroy_at(&node_key);
+                            has_key = false;
+                        }
+                    }
+
+                    constexpr bool empty() const noexcept { return !has_key; }
+                    constexpr explicit operator bool() const noexcept { return has_key; }
 
+                    /**
+                     * The key. The node must not be empty.
+                     */
+                    constexpr const_key_reference key() const noexcept { return node_key; }
+            };
+
+            /**
+             * Initialise an empty set. No memory is allocated until the
+             * first key is inserted.
+             */
             explicit constexpr set(
                 const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
                 allocator_type * const allocator = nullptr
-            ) : alloc{allocator},
+            ) noexcept : alloc{allocator},
                 _capacity{0},
-                slot_map{alloc_flags, allocator},
+                slot_map{nullptr},
                 keys{nullptr},
                 alloc_flags{alloc_flags}
-            {
-                reserve(minimum_capacity);
-            }
+            {}
 
             constexpr set(const set &other) = delete;
 
             constexpr set(set &&other)
                 : alloc{std::move(other)},
-                _capacity{std::move(other._capacity)},
-                slot_map{std::move(other.slot_map)},
-                keys{std::move(other.keys)}
+                _capacity{other._capacity},
+                _size{other._size},
+                slot_map{other.slot_map},
+                keys{other.keys},
+                generation{other.generation},
+                shrink_attempt_size{other.shrink_attempt_size},
+                alloc_flags{other.alloc_flags}
             {
-                other.keys = nullptr;
+                other.release();
             }
 
             template<typename InputRange>
@@ -221,20 +372,36 @@ namespace ccl {
             }
 
             void destroy() noexcept {
-                slot_map.destroy();
+                if(slot_map) {
+                    if constexpr(!std::is_trivially_destructible_v<K>) {
+                        for(size_type i = 0; i < _capacity; ++i) {
+                            if(is_full(i)) {
+                                std::destroy_at(&keys[i]);
+                            }
+                        }
+                    }
 
-                if(keys) {
-                    alloc::get_allocator()->deallocate(keys);
+                    alloc::get_allocator()->deallocate(slot_map);
                 }
 
-                _capacity = 0;
-                keys = nullptr;
+                release();
             }
 
             constexpr size_type capacity() const noexcept {
                 return _capacity;
             }
 
+            /**
+             * Number of keys in the set.
+             */
+            constexpr size_type size() const noexcept {
+                return _size;
+            }
+
+            constexpr bool is_empty() const noexcept {
+                return _size == 0;
+            }
+
             constexpr set& operator =(const set &other) {
                 destroy();
                 alloc::operator =(other);
@@ -251,129 +418,72 @@ namespace ccl {
                 destroy();
 
                 alloc::operator =(std::move(other));
-                slot_map = std::move(other.slot_map);
-                keys = std::move(other.keys);
+                slot_map = other.slot_map;
+                keys = other.keys;
                 _capacity = other._capacity;
+                _size = other._size;
+                generation = other.generation;
+                shrink_attempt_size = other.shrink_attempt_size;
                 alloc_flags = other.alloc_flags;
 
-                other.keys = nullptr;
+                other.release();
 
                 return *this;
             }
 
-            constexpr void reserve(size_type new_capacity) {
+            constexpr void reserve(const size_type new_capacity) {
                 if(new_capacity <= _capacity) {
                     return;
                 }
 
-                bool done;
-                new_capacity = increase_capacity(_capacity, new_capacity);
-                bitset<allocator_type> new_slot_map;
-                const auto finish = end();
-                key_pointer new_keys;
-
-                do {
-                    bool keep_iterating = true;
-                    done = true;
-                    new_keys = alloc::get_allocator()->template allocate<key_type>(new_capacity, alloc_flags);
-
-                    new_slot_map.resize(new_capacity);
-                    new_slot_map.zero();
-
-                    for(auto it = begin(); it < finish && keep_iterating; ++it) {
-                        const size_type new_index = compute_key_index(*it, new_capacity);
-                        const size_type last_chunk_index = wrap_index(new_index + CCL_SET_KEY_CHUNK_SIZE, new_capacity);
-                        bool item_added = false;
-
-                        for(size_type i = new_index; i != last_chunk_index; i = wrap_index(++i, new_capacity)) {
-                            if(!new_slot_map[i]) {
-                                std::construct_at(&new_keys[i], std::move(*it));
-                                std::destroy_at(std::to_address(it));
-                                new_slot_map.set(i);
-
-                                item_added = true;
-                                break;
-                            }
-                        }
-
-                        // If the chunk is full because of too many close-by
-                        // elements we have to start over and increase the capacity once more.
-                        if(!item_added) {
-                            alloc::get_allocator()->deallocate(new_keys);
-                            new_capacity <<= 1;
-                            done = false;
-                            break;
-                        }
-                    }
-                } while(!done);
+                rebuild(increase_capacity(_capacity, max(minimum_capacity, new_capacity)));
+            }
 
-                if(keys) {
-                    alloc::get_allocator()->deallocate(keys);
+            /**
+             * Grow the set ahead of holding a number of keys, so that
+             * inserting them does not rehash.
+             *
+             * @param key_count The number of keys.
+             */
+            constexpr void reserve_items(const size_type key_count) {
+                size_type new_capacity = max(minimum_capacity, _capacity);
+
+                while(max_item_count(new_capacity) < key_count) {
+                    new_capacity <<= 1;
                 }
 
-                _capacity = new_capacity;
-                slot_map = std::move(new_slot_map);
-                keys = new_keys;
+                reserve(new_capacity);
             }
 
-            constexpr void insert(const_key_reference key) {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + CCL_SET_KEY_CHUNK_SIZE, _capacity);
-                size_type first_empty = invalid_size;
+            /**
+             * Release the slots not needed by the current keys. The keys are
+             * moved to the smallest capacity holding them within the maximum
+             * load factor, without overflowing any chunk. Nothing is moved
+             * if clustered keys would overflow a chunk at every smaller
+             * capacity. Empty sets release all their slots.
+             */
+            constexpr void shrink_to_fit() {
+                if(!_size) {
+                    destroy();
 
-                // Check all items in a chunk. If we find the exact key,
-                // nothing needs to be done. Item is already there. Otherwise
-                // find the first available slot in the chunk and add the item.
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && key == keys[i]) {
-                        return;
-                    }
-
-                    if(!slot_map[i] && first_empty == invalid_size) {
-                        first_empty = i;
-                    }
+                    return;
                 }
 
-                if(first_empty != invalid_size) {
-                    std::construct_at(&keys[first_empty], key);
-                    slot_map[first_empty] = true;
-                    return;
+                const size_type new_capacity = shrunk_capacity();
+
+                if(new_capacity < _capacity) {
+                    rebuild(new_capacity);
                 }
+            }
 
-                // No slots available in the chunk. Reserve and
-                // rehash.
-                reserve(max<size_type>(1, _capacity << 1));
-                insert(key);
+            constexpr void insert(const_key_reference key) {
+                insert_hashed(key, hash(key));
             }
 
             constexpr void insert(key_type&& key) {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + CCL_SET_KEY_CHUNK_SIZE, _capacity);
-                size_type first_empty = invalid_size;
-
-                // Check all items in a chunk. If we find the exact key,
-                // nothing needs to be done. Item is already there. Otherwise
-                // find the first available slot in the chunk and add the item.
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && key == keys[i]) {
-                        return;
-                    }
-
-                    if(!slot_map[i] && first_empty == invalid_size) {
-                        first_empty = i;
-                    }
-                }
-
-                if(first_empty != invalid_size) {
-                    std::construct_at(&keys[first_empty], std::move(key));
-                    slot_map[first_empty] = true;
-                    return;
-                }
+                const hash_type key_hash = hash(key);
 
-                // No slots available in the chunk. Reserve and
-                // rehash.
-                reserve(max<size_type>(1, _capacity << 1));
-                insert(std::move(key));
+                insert_hashed(std::move(key), key_hash);
             }
 
             template<typename Iterator>
@@ -383,8 +493,26 @@ namespace ccl {
                 }
             }
 
+            /**
+             * Insert the keys of a range. Sized ranges of keys inserted into
+             * an empty set are hashed once, and the set allocated for all of
+             * them before any of them is inserted.
+             *
+             * @param input The keys to insert.
+             */
             template<std::ranges::range InputRange>
             constexpr void insert_range(InputRange&& input) {
+                if constexpr(
+                    std::ranges::sized_range<InputRange>
+                    && std::ranges::forward_range<InputRange>
+                    && std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<InputRange>>, K>
+                ) {
+                    if(!_capacity) {
+                        build(input);
+                        return;
+                    }
+                }
+
                 for(auto it = input.begin(); it != input.end(); ++it) {
                     insert(*it);
                 }
@@ -396,55 +524,278 @@ namespace ccl {
                 }
             }
 
-            constexpr void erase(const_key_reference key) {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + CCL_SET_KEY_CHUNK_SIZE, _capacity);
+            /**
+             * Insert multiple keys. The keys of each batch are hashed and
+             * their chunks prefetched before any of them is inserted.
+             *
+             * @param keys The keys to insert.
+             */
+            constexpr void insert_batch(const std::span<const key_type> keys) {
+                for_each_hashed(keys, [this, keys] (const std::size_t i, const hash_type key_hash) {
+                    insert_hashed(keys[i], key_hash);
+                });
+            }
 
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && keys[i] == key) {
-                        std::destroy_at(&keys[i]);
-                        slot_map[i] = false;
-                        return;
+            /**
+             * Insert the key of a node, unless already present.
+             *
+             * @param node The node. Emptied if its key is inserted.
+             *
+             * @return True if the key was inserted, false otherwise.
+             */
+            constexpr bool insert(node_type &&node) {
+                if(node.empty() || !insert_hashed(std::move(node.node_key), node.key_hash)) {
+                    return false;
+                }
+
+                node.reset();
+
+                return true;
+            }
+
+            /**
+             * Remove a key, moving it to a node.
+             *
+             * @param key The key.
+             *
+             * @return The node, empty if the key was not present.
+             */
+            constexpr node_type extract(const_key_reference key) {
+                const hash_type key_hash = hash(key);
+                const size_type i = locate_hashed(key, key_hash);
+
+                if(i == invalid_size) {
+                    return node_type{};
+                }
+
+                node_type node{std::move(keys[i]), key_hash};
+
+                std::destroy_at(&keys[i]);
+                vacate(i);
+                shrink_if_sparse();
+
+                return node;
+            }
+
+            /**
+             * Move the keys of another set into this one. Keys already
+             * present are left in `other`.
+             *
+             * @param other The set to move the keys from.
+             */
+            constexpr void merge(set &other) {
+                if(this == &other) {
+                    return;
+                }
+
+                reserve_items(size() + other.size());
+
+                for(size_type i = 0; i < other._capacity; ++i) {
+                    if(other.is_full(i) && insert_hashed(std::move(other.keys[i]), hash(other.keys[i]))) {
+                        std::destroy_at(&other.keys[i]);
+                        other.vacate(i);
                     }
                 }
             }
 
+            constexpr void merge(set &&other) {
+                merge(other);
+            }
+
+            /**
+             * Erase a key, if present. May shrink the set, depending on the
+             * policy, invalidating all iterators.
+             *
+             * @param key The key.
+             */
+            constexpr void erase(const_key_reference key) {
+                const size_type i = locate(key);
+
+                if(i != invalid_size) {
+                    std::destroy_at(&keys[i]);
+                    vacate(i);
+                    shrink_if_sparse();
+                }
+            }
+
             constexpr void clear() {
                 if constexpr(!std::is_trivially_destructible_v<K>) {
                     for(size_type i = 0; i < _capacity; ++i) {
-                        if(slot_map[i]) {
+                        if(is_full(i)) {
                             std::destroy_at(&keys[i]);
                         }
                     }
                 }
 
-                slot_map.zero();
-            }
+                // Starting a new generation is enough, unless the generations
+                // wrapped around and stale clusters could be taken for current ones.
+                const bool reset_map = !generational_clear || ++generation == 0;
 
-            constexpr iterator find(const_key_reference key) {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + CCL_SET_KEY_CHUNK_SIZE, _capacity);
+                _size = 0;
 
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && keys[i] == key) {
-                        return iterator { *this, i };
-                    }
+                if(slot_map && reset_map) {
+                    ::memset(slot_map, 0, slot_map_size(_capacity));
                 }
+            }
 
-                return end();
+            constexpr iterator find(const_key_reference key) {
+                const size_type i = locate(key);
+
+                return i != invalid_size ? iterator { *this, i } : end();
             }
 
             constexpr bool contains(const_key_reference key) const {
-                const size_type index = compute_key_index(key, _capacity);
-                const size_type last_chunk_index = wrap_index(index + CCL_SET_KEY_CHUNK_SIZE, _capacity);
+                return locate(key) != invalid_size;
+            }
+
+            /**
+             * Find a key, looking it up through a compatible type. Requires
+             * a transparent hash function. No temporary key is constructed.
+             *
+             * @param key The key to look up.
+             *
+             * @return An iterator to the key or `end()` if not present.
+             */
+            template<transparent_key<K, HashFunction> Q>
+            constexpr iterator find(const Q& key) {
+                const size_type i = locate(key);
+
+                return i != invalid_size ? iterator { *this, i } : end();
+            }
+
+            template<transparent_key<K, HashFunction> Q>
+            constexpr bool contains(const Q& key) const {
+                return locate(key) != invalid_size;
+            }
+
+            /**
+             * Find multiple keys. The keys of each batch are hashed and their
+             * chunks prefetched before any of them is looked up, so that the
+             * cache misses of a batch overlap.
+             *
+             * @param keys The keys to find.
+             * @param out Output iterator receiving one iterator per key, `end()`
+             *  for the keys not present.
+             */
+            template<std::output_iterator<iterator> OutputIterator>
+            constexpr void find_batch(const std::span<const key_type> keys, OutputIterator out) {
+                for_each_hashed(keys, [this, keys, &out] (const std::size_t i, const hash_type key_hash) {
+                    const size_type index = locate_hashed(keys[i], key_hash);
+
+                    *out++ = index != invalid_size ? iterator { *this, index } : end();
+                });
+            }
+
+            /**
+             * Check the presence of multiple keys. The keys of each batch are
+             * hashed and their chunks prefetched before any of them is looked up.
+             *
+             * @param keys The keys to look for.
+             * @param out Output iterator receiving one boolean per key.
+             */
+            template<std::output_iterator<bool> OutputIterator>
+            constexpr void contains_batch(const std::span<const key_type> keys, OutputIterator out) const {
+                for_each_hashed(keys, [this, keys, &out] (const std::size_t i, const hash_type key_hash) {
+                    *out++ = locate_hashed(keys[i], key_hash) != invalid_size;
+                });
+            }
+
+            /**
+             * Compute the union of two sets. Each key is hashed once, and the
+             * result is allocated for the keys of both sets before any of
+             * them is inserted.
+             *
+             * @param a The first set.
+             * @param b The second set.
+             *
+             * @return A new set with the keys of both sets, using the allocator of `a`.
+             */
+            friend set set_union(const set &a, const set &b) {
+                set result{a.alloc_flags, a.get_allocator()};
+
+                result.reserve_items(a._size + b._size);
+
+                for(const set * const source : { &a, &b }) {
+                    for_each_key_hashed(*source, { &result }, [&result] (const_key_reference key, const hash_type key_hash) {
+                        result.insert_hashed(key, key_hash);
 
-                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
-                    if(slot_map[i] && keys[i] == key) {
                         return true;
+                    });
+                }
+
+                return result;
+            }
+
+            /**
+             * Compute the intersection of two sets. The keys of the smaller set
+             * are hashed in batches and looked up in the larger one, whose chunks
+             * are prefetched. The result is allocated for the keys of the smaller
+             * set and the hashes reused to insert the common keys.
+             *
+             * @param a The first set.
+             * @param b The second set.
+             *
+             * @return A new set with the keys present in both sets, using the allocator of `a`.
+             */
+            friend set set_intersection(const set &a, const set &b) {
+                const set &smaller = a._size <= b._size ? a : b;
+                const set &larger = a._size <= b._size ? b : a;
+                set result{a.alloc_flags, a.get_allocator()};
+
+                result.reserve_items(smaller._size);
+
+                for_each_key_hashed(smaller, { &larger, &result }, [&result, &larger] (const_key_reference key, const hash_type key_hash) {
+                    if(larger.locate_hashed(key, key_hash) != invalid_size) {
+                        result.insert_hashed(key, key_hash);
                     }
+
+                    return true;
+                });
+
+                return result;
+            }
+
+            /**
+             * Compute the difference of two sets. The keys of `a` are hashed
+             * in batches and looked up in `b`, whose chunks are prefetched.
+             *
+             * @param a The set to take the keys from.
+             * @param b The set of the keys to exclude.
+             *
+             * @return A new set with the keys of `a` not present in `b`, using the allocator of `a`.
+             */
+            friend set set_difference(const set &a, const set &b) {
+                set result{a.alloc_flags, a.get_allocator()};
+
+                result.reserve_items(a._size);
+
+                for_each_key_hashed(a, { &b, &result }, [&result, &b] (const_key_reference key, const hash_type key_hash) {
+                    if(b.locate_hashed(key, key_hash) == invalid_size) {
+                        result.insert_hashed(key, key_hash);
+                    }
+
+                    return true;
+                });
+
+                return result;
+            }
+
+            /**
+             * Check whether all the keys of a set are present in another one.
+             * The keys of `a` are hashed in batches and looked up in `b`, whose
+             * chunks are prefetched, until one is missing.
+             *
+             * @param a The candidate subset.
+             * @param b The candidate superset.
+             */
+            friend bool is_subset(const set &a, const set &b) {
+                if(a._size > b._size) {
+                    return false;
                 }
 
-                return false;
+                return for_each_key_hashed(a, { &b }, [&b] (const_key_reference key, const hash_type key_hash) {
+                    return b.locate_hashed(key, key_hash) != invalid_size;
+                });
             }
 
             constexpr iterator begin() { return iterator{ *this, 0 }; }
@@ -459,8 +810,337 @@ namespace ccl {
             constexpr allocator_type* get_allocator() const noexcept { return alloc::get_allocator(); }
             constexpr allocation_flags get_allocation_flags() const noexcept { return alloc_flags; }
 
+#ifdef CCL_FEATURE_HASH_STATS
+            /**
+             * Get the occupancy of the set and the events recorded since
+             * its construction or the last call to `reset_stats()`.
+             */
+            constexpr hash_stats get_stats() const noexcept {
+                hash_stats result = stats.get();
+
+                result.capacity = _capacity;
+                result.size = _size;
+                result.chunk_size = chunk_size;
+
+                return result;
+            }
+
+            constexpr void reset_stats() noexcept {
+                stats.reset();
+            }
+#endif // CCL_FEATURE_HASH_STATS
+
         private:
-            static hash_type hash(const_key_reference x) {
+            /**
+             * Find the slot holding a key.
+             *
+             * @tparam Q The key type or a transparent lookup type.
+             *
+             * @return The slot index or `invalid_size` if the key is not present.
+             */
+            template<typename Q = K>
+            constexpr size_type locate(const Q& key) const {
+                return locate_hashed(key, hash(key));
+            }
+
+            template<typename Q = K>
+            constexpr size_type locate_hashed(const Q& key, const hash_type key_hash) const {
+                // Empty sets have no slots to probe.
+                if(!_capacity) {
+                    return invalid_size;
+                }
+
+                const size_type index = wrap_index(key_hash, _capacity);
+                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
+
+                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
+                    if(is_full(i) && keys[i] == key) {
+                        stats.record_probe(wrap_index(i - index, _capacity) + 1);
+
+                        return i;
+                    }
+                }
+
+                stats.record_probe(chunk_size);
+
+                return invalid_size;
+            }
+
+            /**
+             * Insert a key, given its hash.
+             *
+             * @return True if the key was inserted, false if already present.
+             */
+            template<typename KeyArg>
+            constexpr bool insert_hashed(KeyArg&& key, const hash_type key_hash) {
+                if(!_capacity) {
+                    reserve(minimum_capacity);
+                }
+
+                const size_type index = wrap_index(key_hash, _capacity);
+                const size_type last_chunk_index = wrap_index(index + chunk_size, _capacity);
+                size_type first_empty = invalid_size;
+
+                // Check all items in a chunk. If we find the exact key,
+                // nothing needs to be done. Item is already there. Otherwise
+                // find the first available slot in the chunk and add the item.
+                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, _capacity)) {
+                    if(is_full(i) && key == keys[i]) {
+                        stats.record_probe(wrap_index(i - index, _capacity) + 1);
+
+                        return false;
+                    }
+
+                    if(!is_full(i) && first_empty == invalid_size) {
+                        first_empty = i;
+                    }
+                }
+
+                stats.record_probe(chunk_size);
+
+                if(first_empty != invalid_size && _size < max_item_count(_capacity)) {
+                    std::construct_at(&keys[first_empty], std::forward<KeyArg>(key));
+                    occupy(first_empty);
+                    return true;
+                }
+
+                // No slots available in the chunk, or too many keys. Reserve
+                // and rehash.
+                if(first_empty == invalid_size) {
+                    stats.record_failed_chunk();
+                }
+
+                reserve(_capacity * growth_factor);
+
+                return insert_hashed(std::forward<KeyArg>(key), key_hash);
+            }
+
+            /**
+             * Move all the keys to new slots.
+             *
+             * @param new_capacity The capacity of the new slots. Doubled until
+             *  no chunk overflows.
+             */
+            constexpr void rebuild(size_type new_capacity) {
+                std::size_t moved_count = 0;
+
+                if(new_capacity > _capacity) {
+                    shrink_attempt_size = invalid_size;
+                }
+
+                slot_cluster_type *new_slot_map;
+                key_pointer new_keys;
+
+                // Keys are placed before being moved. If a chunk is full because
+                // of too many close-by elements we have to start over and increase
+                // the capacity once more.
+                while(true) {
+                    allocate_slots(new_capacity, new_slot_map, new_keys);
+
+                    if(place_keys(new_slot_map, new_capacity)) {
+                        break;
+                    }
+
+                    stats.record_failed_chunk();
+                    alloc::get_allocator()->deallocate(new_slot_map);
+                    new_capacity <<= 1;
+                }
+
+                // Placing the keys again yields the same slots.
+                ::memset(new_slot_map, 0, slot_map_size(new_capacity));
+
+                for(size_type i = 0; i < _capacity; ++i) {
+                    if(is_full(i)) {
+                        const size_type new_index = find_free_slot(new_slot_map, new_capacity, hash(keys[i]));
+
+                        std::construct_at(&new_keys[new_index], std::move(keys[i]));
+                        std::destroy_at(&keys[i]);
+                        occupy(new_slot_map, new_index);
+                        moved_count++;
+                    }
+                }
+
+                if(slot_map) {
+                    alloc::get_allocator()->deallocate(slot_map);
+                    stats.record_rehash(moved_count * sizeof(K));
+                }
+
+                _capacity = new_capacity;
+                slot_map = new_slot_map;
+                keys = new_keys;
+                generation = 0;
+            }
+
+            /**
+             * Insert the keys of a range into a set with no slots. All the keys
+             * are hashed first, and the set reserved for the load factor of
+             * all of them before they are inserted with their hashes.
+             *
+             * @param input The keys to insert.
+             */
+            template<typename InputRange>
+            constexpr void build(InputRange&& input) {
+                const size_type key_count = static_cast<size_type>(std::ranges::size(input));
+
+                if(!key_count) {
+                    return;
+                }
+
+                hash_type * const key_hashes = alloc::get_allocator()->template allocate<hash_type>(key_count, alloc_flags);
+                size_type i = 0;
+
+                for(const auto &key : input) {
+                    key_hashes[i++] = hash(key);
+                }
+
+                reserve_items(key_count);
+                i = 0;
+
+                for(const auto &key : input) {
+                    insert_hashed(key, key_hashes[i++]);
+                }
+
+                alloc::get_allocator()->deallocate(key_hashes);
+            }
+
+            /**
+             * Shrink the set once its load factor fell below the low watermark.
+             */
+            constexpr void shrink_if_sparse() {
+                if constexpr(shrink_load_factor > 0) {
+                    const auto low_size = static_cast<size_type>(static_cast<float>(_capacity) * shrink_load_factor);
+
+                    // Only try again once the size halved since the last attempt,
+                    // which may have kept the capacity because of clustered keys.
+                    if(_capacity > minimum_capacity && _size < low_size && _size <= shrink_attempt_size / 2) {
+                        const size_type new_capacity = shrunk_capacity();
+
+                        if(new_capacity < _capacity) {
+                            rebuild(new_capacity);
+                        }
+
+                        shrink_attempt_size = _size;
+                    }
+                }
+            }
+
+            /**
+             * Smallest capacity holding the current keys within the maximum load
+             * factor, without overflowing any chunk. The keys are placed in a
+             * scratch slot map of each candidate capacity, lower than the current
+             * one, until none of their chunks overflows.
+             *
+             * @return The new capacity, or the current one if no lower capacity
+             *  can hold the keys.
+             */
+            constexpr size_type shrunk_capacity() const {
+                size_type new_capacity = max(minimum_capacity, std::bit_ceil(_size));
+
+                while(max_item_count(new_capacity) < _size) {
+                    new_capacity <<= 1;
+                }
+
+                for(; new_capacity < _capacity; new_capacity <<= 1) {
+                    const std::size_t map_size = slot_map_size(new_capacity);
+                    slot_cluster_type * const map = static_cast<slot_cluster_type*>(
+                        alloc::get_allocator()->allocate(map_size, alignof(slot_cluster_type), alloc_flags)
+                    );
+
+                    ::memset(map, 0, map_size);
+
+                    const bool is_placed = place_keys(map, new_capacity);
+
+                    alloc::get_allocator()->deallocate(map);
+
+                    if(is_placed) {
+                        return new_capacity;
+                    }
+
+                    stats.record_failed_chunk();
+                }
+
+                return _capacity;
+            }
+
+            /**
+             * Hash a sequence of keys in batches, prefetching the chunk of
+             * every key of a batch before resolving any of them.
+             *
+             * @param batch_keys The keys.
+             * @param resolve Function invoked with the index and hash of
+             *  each key.
+             */
+            template<typename Resolve>
+            constexpr void for_each_hashed(const std::span<const key_type> batch_keys, Resolve&& resolve) const {
+                hash_type key_hashes[batch_size];
+
+                for(std::size_t first = 0; first < batch_keys.size(); first += batch_size) {
+                    const std::size_t count = min(batch_keys.size() - first, static_cast<std::size_t>(batch_size));
+
+                    for(std::size_t i = 0; i < count; ++i) {
+                        key_hashes[i] = hash(batch_keys[first + i]);
+
+                        if(_capacity) {
+                            prefetch(&keys[wrap_index(key_hashes[i], _capacity)]);
+                        }
+                    }
+
+                    for(std::size_t i = 0; i < count; ++i) {
+                        resolve(first + i, key_hashes[i]);
+                    }
+                }
+            }
+
+            /**
+             * Hash the keys of a set in batches, prefetching the chunk of
+             * every key of a batch in other sets before resolving any of them.
+             *
+             * @param source The set of the keys to hash.
+             * @param probed The sets to prefetch the chunks of.
+             * @param resolve Function invoked with each key and its hash,
+             *  returning false to stop.
+             *
+             * @return False if stopped by `resolve`, true otherwise.
+             */
+            template<typename Resolve>
+            static constexpr bool for_each_key_hashed(
+                const set &source,
+                const std::initializer_list<const set*> probed,
+                Resolve&& resolve
+            ) {
+                size_type batch_slots[batch_size];
+                hash_type key_hashes[batch_size];
+
+                for(size_type i = 0; i < source._capacity; ) {
+                    size_type count = 0;
+
+                    for(; count < batch_size && i < source._capacity; ++i) {
+                        if(source.is_full(i)) {
+                            batch_slots[count] = i;
+                            key_hashes[count] = hash(source.keys[i]);
+
+                            for(const set * const p : probed) {
+                                if(p->_capacity) {
+                                    prefetch(&p->keys[wrap_index(key_hashes[count], p->_capacity)]);
+                                }
+                            }
+
+                            ++count;
+                        }
+                    }
+
+                    for(size_type j = 0; j < count; ++j) {
+                        if(!resolve(source.keys[batch_slots[j]], key_hashes[j])) {
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            template<typename Q = K>
+            static hash_type hash(const Q& x) {
                 return hash_function_type{}(x);
             }
 
@@ -471,13 +1151,204 @@ namespace ccl {
                 return index & (capacity - 1);
             }
 
-            static constexpr size_type compute_key_index(const_key_reference x, const size_type capacity) {
+            template<typename Q = K>
+            static constexpr size_type compute_key_index(const Q& x, const size_type capacity) {
                 return wrap_index(hash(x), capacity);
             }
 
+            /**
+             * Number of keys a capacity may hold before growing.
+             */
+            static constexpr size_type max_item_count(const size_type capacity) noexcept {
+                return static_cast<size_type>(static_cast<float>(capacity) * max_load_factor);
+            }
+
+            static constexpr size_type slot_map_cluster_count(const size_type capacity) noexcept {
+                return (capacity + slot_cluster_bits - 1) / slot_cluster_bits;
+            }
+
+            /**
+             * Size of a slot map, in bytes.
+             */
+            static constexpr std::size_t slot_map_size(const size_type capacity) noexcept {
+                return sizeof(slot_cluster_type) * slot_map_cluster_count(capacity);
+            }
+
+            /**
+             * Size of a slot map and of the generations of its clusters, if
+             * any, in bytes.
+             */
+            static constexpr std::size_t slot_header_size(const size_type capacity) noexcept {
+                return slot_map_size(capacity) + (generational_clear ? sizeof(generation_type) * slot_map_cluster_count(capacity) : 0);
+            }
+
+            /**
+             * Generations of the slot map clusters, following the slot map.
+             */
+            constexpr generation_type* slot_generations() const noexcept {
+                return reinterpret_cast<generation_type*>(slot_map + slot_map_cluster_count(_capacity));
+            }
+
+            /**
+             * A cluster of the slot map. Clusters of past generations read as empty.
+             */
+            constexpr slot_cluster_type slot_cluster(const std::size_t cluster_index) const noexcept {
+                if constexpr(generational_clear) {
+                    return stamped_clusters{slot_map, slot_generations(), generation}[cluster_index];
+                } else {
+                    return slot_map[cluster_index];
+                }
+            }
+
+            constexpr bool is_full(const size_type index) const noexcept {
+                return (slot_cluster(index / slot_cluster_bits) >> (index % slot_cluster_bits)) & 1;
+            }
+
+            constexpr void occupy(const size_type index) noexcept {
+                if constexpr(generational_clear) {
+                    const size_type cluster_index = index / slot_cluster_bits;
+                    generation_type &cluster_generation = slot_generations()[cluster_index];
+
+                    // Reset clusters of past generations before writing them.
+                    if(cluster_generation != generation) {
+                        slot_map[cluster_index] = 0;
+                        cluster_generation = generation;
+                    }
+                }
+
+                occupy(slot_map, index);
+                _size++;
+            }
+
+            constexpr void vacate(const size_type index) noexcept {
+                // Only occupied slots are vacated, whose cluster is current.
+                vacate(slot_map, index);
+                _size--;
+            }
+
+            static constexpr bool is_full(const slot_cluster_type * const map, const size_type index) noexcept {
+                return (map[index / slot_cluster_bits] >> (index % slot_cluster_bits)) & 1;
+            }
+
+            static constexpr void occupy(slot_cluster_type * const map, const size_type index) noexcept {
+                map[index / slot_cluster_bits] |= static_cast<slot_cluster_type>(1) << (index % slot_cluster_bits);
+            }
+
+            static constexpr void vacate(slot_cluster_type * const map, const size_type index) noexcept {
+                map[index / slot_cluster_bits] &= ~(static_cast<slot_cluster_type>(1) << (index % slot_cluster_bits));
+            }
+
+            /**
+             * First occupied slot at or after a given one, or the capacity if
+             * there is none.
+             */
+            constexpr size_type next_full_slot(const size_type index) const noexcept {
+                const std::size_t next = generational_clear
+                    ? internal::find_set_bit(stamped_clusters{slot_map, slot_generations(), generation}, _capacity, index)
+                    : internal::find_set_bit(slot_map, _capacity, index);
+
+                return next < _capacity ? static_cast<size_type>(next) : _capacity;
+            }
+
+            /**
+             * Last occupied slot before a given one, or 0 if there is none.
+             */
+            constexpr size_type prev_full_slot(const size_type index) const noexcept {
+                const std::size_t prev = generational_clear
+                    ? internal::find_prev_set_bit(stamped_clusters{slot_map, slot_generations(), generation}, _capacity, index)
+                    : internal::find_prev_set_bit(slot_map, _capacity, index);
+
+                return prev < _capacity ? static_cast<size_type>(prev) : 0;
+            }
+
+            /**
+             * Find the first vacant slot in the chunk of a hash.
+             *
+             * @return The slot index or `invalid_size` if the chunk is full.
+             */
+            static constexpr size_type find_free_slot(
+                const slot_cluster_type * const map,
+                const size_type capacity,
+                const hash_type key_hash
+            ) noexcept {
+                const size_type index = wrap_index(key_hash, capacity);
+                const size_type last_chunk_index = wrap_index(index + chunk_size, capacity);
+
+                for(size_type i = index; i != last_chunk_index; i = wrap_index(++i, capacity)) {
+                    if(!is_full(map, i)) {
+                        return i;
+                    }
+                }
+
+                return invalid_size;
+            }
+
+            /**
+             * Mark the slots the current keys would take in a new slot map,
+             * without moving them.
+             *
+             * @return True if all the keys were placed, false if a chunk is full.
+             */
+            constexpr bool place_keys(slot_cluster_type * const map, const size_type capacity) const {
+                for(size_type i = 0; i < _capacity; ++i) {
+                    if(is_full(i)) {
+                        const size_type new_index = find_free_slot(map, capacity, hash(keys[i]));
+
+                        if(new_index == invalid_size) {
+                            return false;
+                        }
+
+                        occupy(map, new_index);
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * Allocate the slot map and the keys of a capacity as a single block,
+             * the keys following the slot map and the generations of its clusters.
+             * The slot map is cleared, and all its clusters belong to generation 0.
+             */
+            constexpr void allocate_slots(
+                const size_type capacity,
+                slot_cluster_type *&out_slot_map,
+                key_pointer &out_keys
+            ) const {
+                const std::size_t keys_offset = align_size(slot_header_size(capacity), alignof(K));
+                std::byte * const block = static_cast<std::byte*>(
+                    alloc::get_allocator()->allocate(
+                        keys_offset + sizeof(K) * capacity,
+                        max(alignof(K), alignof(slot_cluster_type)),
+                        alloc_flags
+                    )
+                );
+
+                out_slot_map = reinterpret_cast<slot_cluster_type*>(block);
+                out_keys = reinterpret_cast<key_pointer>(block + keys_offset);
+
+                ::memset(out_slot_map, 0, slot_header_size(capacity));
+            }
+
+            /**
+             * Forget all the slots, without releasing them.
+             */
+            constexpr void release() noexcept {
+                _capacity = 0;
+                _size = 0;
+                slot_map = nullptr;
+                keys = nullptr;
+                generation = 0;
+                shrink_attempt_size = invalid_size;
+            }
+
             size_type _capacity = 0;
-            bitset<allocator_type> slot_map; // Slot availability bit map. true is filled, false is empty
+            size_type _size = 0;
+            slot_cluster_type *slot_map = nullptr; // Slot availability bit map, heading the slot block. 1 is filled, 0 is empty
             key_pointer keys = nullptr;
+            generation_type generation = 0; // Current generation of the slot map, only used when clearing by generation
+            size_type shrink_attempt_size = invalid_size; // Size at the last shrink by the low watermark, if any
+            CCLZEROSIZE mutable internal::hash_stats_recorder stats;
             allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS;
 
             static constexpr size_type invalid_size = ~static_cast<size_type>(0);
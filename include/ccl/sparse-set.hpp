@@ -6,14 +6,21 @@
 #ifndef CCL_SPARSE_SET_HPP
 #define CCL_SPARSE_SET_HPP
 
+#include <algorithm>
+#include <concepts>
+#include <ranges>
+#include <span>
 #include <utility>
 #include <ccl/api.hpp>
+#include <ccl/definitions.hpp>
 #include <ccl/hashtable.hpp>
 #include <ccl/vector.hpp>
 #include <ccl/memory/allocator.hpp>
 #include <ccl/concepts.hpp>
 #include <ccl/hash.hpp>
+#include <ccl/util.hpp>
 #include <ccl/internal/optional-allocator.hpp>
+#include <ccl/internal/sorted-merge.hpp>
 
 namespace ccl {
     template<
@@ -32,6 +39,8 @@ namespace ccl {
             using hash_type = hash_t;
             using size_type = uint32_t;
 
+            static constexpr size_type batch_size = CCL_HASH_BATCH_SIZE;
+
         private:
             using alloc = internal::with_optional_allocator<Allocator>;
             using data_vector_type = vector<T, allocator_type>;
@@ -55,6 +64,68 @@ namespace ccl {
                 return wrap_index(hash(x), capacity);
             }
 
+            /**
+             * Visit the items of a set, telling whether each of them is present
+             * in another set. If the dense storage of both sets is sorted, the
+             * two are merged without looking up any item. Otherwise, the items
+             * are looked up in batches, prefetching their slots in the index of
+             * the other set.
+             *
+             * Sortedness is checked on every call, as the dense storage can be
+             * modified through the iterators. The check stops at the first
+             * item out of order, so it is short on unsorted storage; sorted
+             * storage is scanned in full, which is cheaper than the lookups it
+             * saves.
+             *
+             * @param source The set of the items to visit.
+             * @param probed The set to look the items up in.
+             * @param visitor A function invoked as `visitor(item, is_in_probed)`
+             *  for each item of `source`, in dense order. Returning false stops
+             *  the visit.
+             */
+            template<typename Visitor>
+            static constexpr void for_each_membership(const sparse_set &source, const sparse_set &probed, Visitor&& visitor) {
+                const std::span<const T> items{ source.data(), source.size() };
+
+                if constexpr(std::totally_ordered<T>) {
+                    const std::span<const T> other{ probed.data(), probed.size() };
+
+                    if(std::is_sorted(items.begin(), items.end()) && std::is_sorted(other.begin(), other.end())) {
+                        internal::for_each_sorted_membership(items, other, visitor);
+
+                        return;
+                    }
+                }
+
+                bool is_present[batch_size];
+
+                for(std::size_t first = 0; first < items.size(); first += batch_size) {
+                    const auto batch = items.subspan(first, min(items.size() - first, static_cast<std::size_t>(batch_size)));
+
+                    probed.index_map.contains_batch(batch, is_present);
+
+                    for(std::size_t i = 0; i < batch.size(); ++i) {
+                        if(!internal::visit_membership(visitor, batch[i], is_present[i])) {
+                            return;
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Add the items of the dense storage from a position onwards to
+             * the index. The items must not be indexed yet.
+             *
+             * @param first The position of the first item to index.
+             */
+            constexpr void index_items(const size_type first) {
+                index_map.reserve_items(size());
+
+                for(size_type i = first; i < size(); ++i) {
+                    index_map.insert(_data[i], i);
+                }
+            }
+
         public:
             constexpr sparse_set(
                 const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
@@ -74,30 +145,218 @@ namespace ccl {
                 index_map{std::move(other.index_map)}
             {}
 
-            constexpr void insert(const_reference_type item) {
-                if(!index_map.contains(item)) {
-                    const size_type item_index = static_cast<size_type>(_data.size());
+            /**
+             * Initialise a set from a range of items. Sized ranges are stored
+             * without growing the set while inserting.
+             *
+             * @param input The items to insert.
+             */
+            template<std::ranges::input_range InputRange>
+            requires (!std::same_as<std::remove_cvref_t<InputRange>, sparse_set>)
+            constexpr sparse_set(
+                InputRange&& input,
+                const allocation_flags alloc_flags = CCL_ALLOCATOR_DEFAULT_FLAGS,
+                allocator_type * const allocator = nullptr
+            ) : sparse_set{alloc_flags, allocator} {
+                if constexpr(std::ranges::sized_range<InputRange>) {
+                    reserve(static_cast<size_type>(std::ranges::size(input)));
+                }
+
+                for(auto&& item : input) {
+                    insert(item);
+                }
+            }
 
+            /**
+             * Grow the set ahead of holding a number of items, so that
+             * inserting them does not grow the dense storage or rehash
+             * the index.
+             *
+             * @param item_count The number of items.
+             */
+            constexpr void reserve(const size_type item_count) {
+                _data.reserve(item_count);
+                index_map.reserve_items(item_count);
+            }
+
+            constexpr void insert(const_reference_type item) {
+                if(index_map.try_emplace(item, static_cast<size_type>(_data.size())).second) {
                     _data.push_back(item);
-                    index_map.insert(item, item_index);
                 }
             }
 
-            constexpr void remove(const_reference_type item) {
+            /**
+             * Insert an item, unless already present. The index keeps its own
+             * copy of the item, the dense storage receives the moved item.
+             *
+             * @param item The item to insert.
+             */
+            constexpr void insert(value_type&& item) {
+                if(index_map.try_emplace(item, static_cast<size_type>(_data.size())).second) {
+                    _data.emplace_back(std::move(item));
+                }
+            }
+
+            /**
+             * Remove an item, if present. The last item of the dense storage
+             * takes the place of the removed one, so that only its index has
+             * to be updated.
+             *
+             * @param item The item to remove.
+             *
+             * @return True if the item was present, false otherwise.
+             */
+            constexpr bool remove(const_reference_type item) {
                 const auto it = index_map.find(item);
 
-                if(it != index_map.end()) {
-                    const size_type index = static_cast<size_type>(*it->second);
+                if(it == index_map.end()) {
+                    return false;
+                }
+
+                const size_type index = *it->second;
+                const size_type last_index = size() - 1;
 
-                    _data.erase(_data.begin() + index);
-                    index_map.erase(item);
+                if(index != last_index) {
+                    *index_map.find(_data[last_index])->second = index;
+                    _data[index] = std::move(_data[last_index]);
                 }
+
+                index_map.erase(it);
+                _data.erase(_data.end() - 1);
+
+                return true;
+            }
+
+            /**
+             * Remove all the items of a range, if present.
+             *
+             * @param input The items to remove.
+             *
+             * @return The number of items removed.
+             */
+            template<std::ranges::input_range InputRange>
+            constexpr size_type remove_all(InputRange&& input) {
+                size_type count = 0;
+
+                for(auto&& item : input) {
+                    count += remove(item);
+                }
+
+                return count;
             }
 
             constexpr bool contains(const_reference_type item) const {
                 return index_map.contains(item);
             }
 
+            /**
+             * Compute the union of two sets. The result is a copy of the larger
+             * set, followed by the items of the smaller set it does not hold.
+             * Unlike the intersection and the difference, the result is not
+             * sorted even if both sets are: it keeps the index copied from the
+             * larger set rather than indexing a merged order again.
+             *
+             * @param a The first set.
+             * @param b The second set.
+             *
+             * @return A new set with the items of both sets, using the allocator
+             *  of the larger one.
+             */
+            friend sparse_set set_union(const sparse_set &a, const sparse_set &b) {
+                const sparse_set &smaller = a.size() <= b.size() ? a : b;
+                const sparse_set &larger = a.size() <= b.size() ? b : a;
+                sparse_set result{larger};
+
+                result._data.reserve(a.size() + b.size());
+
+                for_each_membership(smaller, larger, [&result] (const_reference_type item, const bool is_in_larger) {
+                    if(!is_in_larger) {
+                        result._data.push_back(item);
+                    }
+                });
+
+                result.index_items(larger.size());
+
+                return result;
+            }
+
+            /**
+             * Compute the intersection of two sets, visiting the items of the
+             * smaller one. If the dense storage of both sets is sorted, so is
+             * the dense storage of the result.
+             *
+             * @param a The first set.
+             * @param b The second set.
+             *
+             * @return A new set with the items present in both sets, in the
+             *  dense order of the smaller one, using the allocator of `a`.
+             */
+            friend sparse_set set_intersection(const sparse_set &a, const sparse_set &b) {
+                const sparse_set &smaller = a.size() <= b.size() ? a : b;
+                const sparse_set &larger = a.size() <= b.size() ? b : a;
+                sparse_set result{a.get_allocation_flags(), a.get_allocator()};
+
+                result._data.reserve(smaller.size());
+
+                for_each_membership(smaller, larger, [&result] (const_reference_type item, const bool is_in_larger) {
+                    if(is_in_larger) {
+                        result._data.push_back(item);
+                    }
+                });
+
+                result.index_items(0);
+
+                return result;
+            }
+
+            /**
+             * Compute the difference of two sets. If the dense storage of both
+             * sets is sorted, so is the dense storage of the result.
+             *
+             * @param a The set to take the items from.
+             * @param b The set of the items to exclude.
+             *
+             * @return A new set with the items of `a` not present in `b`, in the
+             *  dense order of `a`, using the allocator of `a`.
+             */
+            friend sparse_set set_difference(const sparse_set &a, const sparse_set &b) {
+                sparse_set result{a.get_allocation_flags(), a.get_allocator()};
+
+                result._data.reserve(a.size());
+
+                for_each_membership(a, b, [&result] (const_reference_type item, const bool is_in_b) {
+                    if(!is_in_b) {
+                        result._data.push_back(item);
+                    }
+                });
+
+                result.index_items(0);
+
+                return result;
+            }
+
+            /**
+             * Check whether all the items of a set are present in another one.
+             *
+             * @param a The candidate subset.
+             * @param b The candidate superset.
+             */
+            friend bool is_subset(const sparse_set &a, const sparse_set &b) {
+                if(a.size() > b.size()) {
+                    return false;
+                }
+
+                bool is_included = true;
+
+                for_each_membership(a, b, [&is_included] (const_reference_type, const bool is_in_b) {
+                    is_included = is_in_b;
+
+                    return is_in_b;
+                });
+
+                return is_included;
+            }
+
             constexpr decltype(auto) begin() { return _data.begin(); }
             constexpr decltype(auto) begin() const { return _data.begin(); }
             constexpr decltype(auto) end() { return _data.end(); }
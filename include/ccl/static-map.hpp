@@ -0,0 +1,268 @@
+/**
+ * @file
+ *
+ * Immutable map built at compile time.
+ */
+#ifndef CCL_STATIC_MAP_HPP
+#define CCL_STATIC_MAP_HPP
+
+#include <array>
+#include <bit>
+#include <limits>
+#include <utility>
+#include <ccl/api.hpp>
+#include <ccl/debug.hpp>
+#include <ccl/exceptions.hpp>
+#include <ccl/hash.hpp>
+#include <ccl/pair.hpp>
+#include <ccl/util.hpp>
+#include <ccl/internal/control-group.hpp>
+
+namespace ccl {
+    /**
+     * An immutable map from a fixed set of keys, indexed by a perfect hash.
+     *
+     * Keys are split into buckets by their hash. Each bucket is assigned
+     * a displacement, chosen when building the map, so that the keys of
+     * all the buckets land on distinct slots. Looking up a key takes a
+     * single probe and never allocates.
+     *
+     * Maps defined as `constexpr` are built by the compiler, and placed in
+     * read-only memory. Building fails if two keys are equal.
+     *
+     * @tparam K The key type.
+     * @tparam V The value type.
+     * @tparam N The number of keys. Must be positive.
+     * @tparam HashFunction The hash function type. Must be usable in constant expressions.
+     */
+    template<
+        typename K,
+        typename V,
+        std::size_t N,
+        typed_hash_function<K> HashFunction = hash<K>
+    > requires (N > 0)
+    class static_map {
+        public:
+            using key_type = K;
+            using value_type = V;
+            using hash_function_type = HashFunction;
+            using size_type = count_t;
+            using item_type = pair<K, V>;
+            using const_key_reference = const K&;
+            using const_value_reference = const V&;
+            using const_value_pointer = const V*;
+            using const_iterator = const item_type*;
+
+            /**
+             * Number of slots. Kept above 1.25 times the number of keys.
+             */
+            static constexpr size_type slot_count = max(
+                static_cast<size_type>(2),
+                std::bit_ceil(static_cast<size_type>(N + N / 4 + 1))
+            );
+
+            /**
+             * Number of buckets, each holding about 3 keys on average.
+             */
+            static constexpr size_type bucket_count = max(static_cast<size_type>(1), slot_count / 4);
+
+            /**
+             * Maximum number of displacements tried for each bucket.
+             */
+            static constexpr uint32_t max_displacement = 1u << 16;
+
+            static_assert(N < std::numeric_limits<size_type>::max());
+
+        private:
+            static constexpr unsigned slot_bits = bitcount(slot_count) - 1;
+
+            /**
+             * Slot index of a missing key.
+             */
+            static constexpr size_type empty_slot = static_cast<size_type>(N);
+
+            std::array<item_type, N> items;
+            std::array<size_type, slot_count> slots{};
+            std::array<uint32_t, bucket_count> displacements{};
+
+        public:
+            /**
+             * Build a map.
+             *
+             * @param init The key-value pairs. Keys must be unique.
+             */
+            constexpr explicit static_map(const item_type (&init)[N])
+                : items{copy_items(init, std::make_index_sequence<N>{})}
+            {
+                build();
+            }
+
+            /**
+             * Look up a key.
+             *
+             * @param key The key.
+             *
+             * @return A pointer to the value of the key, or nullptr if the key is not present.
+             */
+            CCLNODISCARD constexpr const_value_pointer find(const_key_reference key) const {
+                const uint64_t key_hash = mixed_hash(key);
+                const size_type index = slots[slot_index(key_hash, displacements[bucket_index(key_hash)])];
+
+                if(index != empty_slot && items[index].first == key) {
+                    return &items[index].second;
+                }
+
+                return nullptr;
+            }
+
+            CCLNODISCARD constexpr bool contains(const_key_reference key) const {
+                return find(key) != nullptr;
+            }
+
+            /**
+             * Get the value of a key.
+             *
+             * @param key The key. Must be present.
+             */
+            CCLNODISCARD constexpr const_value_reference at(const_key_reference key) const {
+                const const_value_pointer value = find(key);
+
+                CCL_THROW_IF(!value, std::out_of_range{"Key not present."});
+
+                return *value;
+            }
+
+            /**
+             * Iterators over the key-value pairs, in the order they were
+             * given when building the map.
+             */
+            constexpr const_iterator begin() const noexcept { return items.data(); }
+            constexpr const_iterator end() const noexcept { return items.data() + N; }
+
+            constexpr size_type size() const noexcept { return static_cast<size_type>(N); }
+
+        private:
+            template<std::size_t ...I>
+            static constexpr std::array<item_type, N> copy_items(const item_type (&init)[N], std::index_sequence<I...>) {
+                return { init[I]... };
+            }
+
+            static constexpr uint64_t mixed_hash(const_key_reference key) {
+                return internal::mix_hash(HashFunction{}(key));
+            }
+
+            static constexpr size_type bucket_index(const uint64_t key_hash) noexcept {
+                return static_cast<size_type>(key_hash >> 32) & (bucket_count - 1);
+            }
+
+            static constexpr size_type slot_index(const uint64_t key_hash, const uint32_t displacement) noexcept {
+                constexpr uint64_t multiplier = 0xD6E8FEB86659FD93ULL;
+
+                return static_cast<size_type>(
+                    internal::mix_hash(key_hash ^ (displacement * multiplier)) >> (64 - slot_bits)
+                );
+            }
+
+            /**
+             * Assign the displacements of all the buckets, largest buckets
+             * first, and fill the slots.
+             */
+            constexpr void build() {
+                std::array<uint64_t, N> hashes{};
+                std::array<size_type, bucket_count + 1> bucket_start{};
+                std::array<size_type, N> bucket_items{};
+                std::array<size_type, bucket_count> bucket_fill{};
+                size_type max_bucket_size = 0;
+
+                slots.fill(empty_slot);
+
+                // Sort the items by bucket.
+                for(size_type i = 0; i < N; ++i) {
+                    hashes[i] = mixed_hash(items[i].first);
+                    bucket_start[bucket_index(hashes[i]) + 1]++;
+                }
+
+                for(size_type b = 0; b < bucket_count; ++b) {
+                    max_bucket_size = max(max_bucket_size, bucket_start[b + 1]);
+                    bucket_start[b + 1] += bucket_start[b];
+                }
+
+                for(size_type i = 0; i < N; ++i) {
+                    const size_type b = bucket_index(hashes[i]);
+
+                    bucket_items[bucket_start[b] + bucket_fill[b]++] = i;
+                }
+
+                for(size_type bucket_size = max_bucket_size; bucket_size > 0; --bucket_size) {
+                    for(size_type b = 0; b < bucket_count; ++b) {
+                        if(bucket_start[b + 1] - bucket_start[b] == bucket_size) {
+                            place_bucket(hashes, bucket_items.data() + bucket_start[b], bucket_size, b);
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Find the first displacement placing all the items of a bucket
+             * in empty slots, and place them.
+             */
+            constexpr void place_bucket(
+                const std::array<uint64_t, N> &hashes,
+                const size_type * const bucket_items,
+                const size_type bucket_size,
+                const size_type bucket
+            ) {
+                for(size_type i = 0; i < bucket_size; ++i) {
+                    for(size_type j = 0; j < i; ++j) {
+                        CCL_THROW_IF(
+                            items[bucket_items[i]].first == items[bucket_items[j]].first,
+                            std::invalid_argument{"Duplicate key."}
+                        );
+                    }
+                }
+
+                for(uint32_t displacement = 0; displacement < max_displacement; ++displacement) {
+                    size_type placed = 0;
+
+                    for(; placed < bucket_size; ++placed) {
+                        const size_type slot = slot_index(hashes[bucket_items[placed]], displacement);
+
+                        if(slots[slot] != empty_slot) {
+                            break;
+                        }
+
+                        slots[slot] = bucket_items[placed];
+                    }
+
+                    if(placed == bucket_size) {
+                        displacements[bucket] = displacement;
+
+                        return;
+                    }
+
+                    // Undo the partial placement.
+                    for(size_type i = 0; i < placed; ++i) {
+                        slots[slot_index(hashes[bucket_items[i]], displacement)] = empty_slot;
+                    }
+                }
+
+                CCL_THROW(std::invalid_argument{"Unable to build a perfect hash."});
+            }
+    };
+
+    /**
+     * Build a static map, deducing its size.
+     *
+     * @param init The key-value pairs. Keys must be unique.
+     */
+    template<
+        typename K,
+        typename V,
+        typed_hash_function<K> HashFunction = hash<K>,
+        std::size_t N
+    > constexpr static_map<K, V, N, HashFunction> make_static_map(const pair<K, V> (&init)[N]) {
+        return static_map<K, V, N, HashFunction>{init};
+    }
+}
+
+#endif // CCL_STATIC_MAP_HPP
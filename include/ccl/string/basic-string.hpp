@@ -8,6 +8,7 @@
 
 #include <iterator>
 #include <span>
+#include <string_view>
 #include <ccl/api.hpp>
 #include <ccl/concepts.hpp>
 #include <ccl/hash.hpp>
@@ -146,6 +147,24 @@ namespace ccl {
                 return true;
             }
 
+            /**
+             * View the contents of this string.
+             */
+            constexpr operator std::basic_string_view<value_type>() const noexcept {
+                return std::basic_string_view<value_type>{_data, _length};
+            }
+
+            /**
+             * Compares this string with a string view.
+             */
+            constexpr bool operator==(const std::basic_string_view<value_type> rhs) const {
+                if(rhs.length() != _length) {
+                    return false;
+                }
+
+                return _length == 0 || char_traits::compare(rhs.data(), _data, _length) == 0;
+            }
+
             /**
              * Compares this string with a NUL-terminated string.
              */
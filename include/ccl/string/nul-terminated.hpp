@@ -73,6 +73,13 @@ namespace ccl {
                 return data;
             }
 
+            /**
+             * View the contents of this string, excluding the terminator.
+             */
+            constexpr operator std::basic_string_view<CharType>() const noexcept {
+                return std::basic_string_view<CharType>{data, _length};
+            }
+
             constexpr void destroy() {
                 if(and_(data != nullptr, data != local_storage)) {
                     alloc::get_allocator()->deallocate(data);
@@ -0,0 +1,179 @@
+/**
+ * @file
+ *
+ * Benchmark driver.
+ */
+#ifndef CCL_TEST_BENCHMARK_HPP
+#define CCL_TEST_BENCHMARK_HPP
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <ccl/api.hpp>
+#include <ccl/util.hpp>
+
+namespace ccl {
+    class benchmark_state;
+
+    using benchmark_function = std::function<void(benchmark_state&)>;
+
+    /**
+     * State of a single benchmark run. Only the code executed within
+     * `measure()` contributes to the reported time.
+     */
+    class benchmark_state {
+        friend class benchmark_suite;
+
+        public:
+            using clock = std::chrono::steady_clock;
+            using duration = std::chrono::nanoseconds;
+
+            struct counter {
+                std::string name;
+                double value;
+            };
+
+        private:
+            duration elapsed{0};
+            std::size_t items = 1;
+            std::vector<counter> counters;
+
+        public:
+            /**
+             * Time the execution of a piece of code.
+             *
+             * @param code The code to time.
+             */
+            template<typename Code>
+            void measure(Code&& code) {
+                const auto start = clock::now();
+
+                code();
+
+                elapsed += std::chrono::duration_cast<duration>(clock::now() - start);
+            }
+
+            /**
+             * Set the number of items processed within the measured code,
+             * used to report the time per item.
+             *
+             * @param n The number of items.
+             */
+            void set_items_processed(const std::size_t n) noexcept {
+                items = max(n, static_cast<std::size_t>(1));
+            }
+
+            /**
+             * Report an additional value alongside the measured time.
+             *
+             * @param name The name of the value.
+             * @param value The value.
+             */
+            void add_counter(const std::string_view name, const double value) {
+                counters.push_back(counter{std::string{name}, value});
+            }
+    };
+
+    class benchmark {
+        friend class benchmark_suite;
+
+        std::string name;
+        benchmark_function function;
+        unsigned repetitions;
+
+        public:
+            benchmark(
+                const std::string_view name,
+                const benchmark_function function,
+                const unsigned repetitions
+            ) : name{name}, function{function}, repetitions{repetitions}
+            {}
+
+            const std::string& get_name() const { return name; }
+    };
+
+    class benchmark_suite {
+        public:
+            using benchmark_ptr = std::shared_ptr<benchmark>;
+
+            static constexpr unsigned default_repetitions = 5;
+
+        private:
+            std::vector<benchmark_ptr> benchmarks;
+            std::ostream *ostream;
+
+            /**
+             * Run a benchmark and keep the fastest of its repetitions.
+             */
+            static benchmark_state run(const benchmark &b) {
+                benchmark_state best;
+
+                for(unsigned i = 0; i < b.repetitions; ++i) {
+                    benchmark_state state;
+
+                    b.function(state);
+
+                    if(i == 0 || state.elapsed < best.elapsed) {
+                        best = std::move(state);
+                    }
+                }
+
+                return best;
+            }
+
+        public:
+            explicit benchmark_suite(std::ostream * const ostream = &std::cout) : ostream{ostream} {
+                benchmarks.reserve(32);
+            }
+
+            /**
+             * Run all the benchmarks whose name contains `filter`.
+             *
+             * @param filter The name filter. Empty to run all benchmarks.
+             */
+            void execute(const std::string_view filter = {}) const {
+                for(const auto &b : benchmarks) {
+                    if(!filter.empty() && b->get_name().find(filter) == std::string::npos) {
+                        continue;
+                    }
+
+                    const benchmark_state state = run(*b);
+                    const double total_ns = static_cast<double>(state.elapsed.count());
+
+                    if(ostream) {
+                        *ostream << std::left << std::setw(56) << b->get_name()
+                            << std::right << std::fixed << std::setprecision(2)
+                            << std::setw(12) << (total_ns / state.items) << " ns/item"
+                            << std::setw(14) << (total_ns / 1000000.0) << " ms";
+
+                        for(const auto &c : state.counters) {
+                            *ostream << "  " << c.name << '=' << c.value;
+                        }
+
+                        *ostream << std::endl;
+                    }
+                }
+            }
+
+            benchmark_ptr add_benchmark(
+                const std::string_view name,
+                const benchmark_function function,
+                const unsigned repetitions = default_repetitions
+            ) {
+                return benchmarks.emplace_back(std::make_shared<benchmark>(name, function, repetitions));
+            }
+
+            int main(int argc, char **argv) {
+                execute(argc > 1 ? std::string_view{argv[1]} : std::string_view{});
+
+                return 0;
+            }
+    };
+}
+
+#endif // CCL_TEST_BENCHMARK_HPP
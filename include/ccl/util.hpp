@@ -431,6 +431,18 @@ namespace ccl {
     CCLINLINE void do_not_optimize(auto& value) noexcept {
         asm volatile("" : "+r,m"(value) : : "memory");
     }
+
+    /**
+     * Hint the processor to load the memory at an address into the cache,
+     * ahead of its use.
+     *
+     * @param address The address to prefetch.
+     */
+    CCLINLINE constexpr void prefetch(const void * const address) noexcept {
+        if !consteval {
+            __builtin_prefetch(address);
+        }
+    }
 }
 
 #endif // CCL_UTIL_HPP
@@ -169,6 +169,84 @@ int main(int argc, char **argv) {
         });
     });
 
+    suite.add_test("resize (partial cluster)", [] () {
+        test_bitset x;
+
+        x.resize(65);
+
+        check(x.size() == 2);
+        check(x.size_bits() == 65);
+    });
+
+    suite.add_test("find_first_set", [] () {
+        test_bitset x;
+
+        equals(x.find_first_set(), test_bitset::npos);
+
+        for(int i = 0; i < 200; ++i) {
+            x.push_back_clear();
+        }
+
+        equals(x.find_first_set(), test_bitset::npos);
+
+        x.set(130);
+        equals(x.find_first_set(), 130);
+
+        x.set(3);
+        equals(x.find_first_set(), 3);
+    });
+
+    suite.add_test("find_next_set", [] () {
+        test_bitset x;
+
+        for(int i = 0; i < 200; ++i) {
+            x.push_back_clear();
+        }
+        x.set(0);
+        x.set(63);
+        x.set(64);
+        x.set(199);
+
+        equals(x.find_next_set(0), 63);
+        equals(x.find_next_set(63), 64);
+        equals(x.find_next_set(64), 199);
+        equals(x.find_next_set(199), test_bitset::npos);
+        equals(x.find_next_set(test_bitset::npos), test_bitset::npos);
+    });
+
+    suite.add_test("find_next_set (bits past the end)", [] () {
+        test_bitset x;
+
+        for(int i = 0; i < 128; ++i) {
+            x.push_back_clear();
+        }
+        x.set(100);
+        x.resize(70);
+
+        equals(x.find_next_set(0), test_bitset::npos);
+    });
+
+    suite.add_test("find_prev_set", [] () {
+        test_bitset x;
+
+        equals(x.find_prev_set(0), test_bitset::npos);
+
+        for(int i = 0; i < 200; ++i) {
+            x.push_back_clear();
+        }
+        x.set(0);
+        x.set(63);
+        x.set(64);
+        x.set(199);
+
+        equals(x.find_prev_set(x.size_bits()), 199);
+        equals(x.find_prev_set(199), 64);
+        equals(x.find_prev_set(64), 63);
+        equals(x.find_prev_set(63), 0);
+        equals(x.find_prev_set(0), test_bitset::npos);
+        equals(x.find_prev_set(test_bitset::npos), 199);
+    });
+
     suite.add_test("operator = (move)", [] () {
         test_bitset x;
         test_bitset y;
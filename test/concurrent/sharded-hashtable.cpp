@@ -0,0 +1,218 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <ccl/test/test.hpp>
+#include <ccl/test/counting-test-allocator.hpp>
+#include <ccl/concurrent/sharded-hashtable.hpp>
+
+using namespace ccl;
+using namespace ccl::concurrent;
+
+using test_table = sharded_hashtable<int, int, hash<int>, counting_test_allocator>;
+using threaded_table = sharded_hashtable<int, int>;
+
+static constexpr int thread_count = 4;
+static constexpr int items_per_thread = 2000;
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("insert/find", [] () {
+        test_table table;
+
+        table.insert(1, 10);
+        table.insert(2, 20);
+
+        equals(table.contains(1), true);
+        equals(table.contains(2), true);
+        equals(table.contains(3), false);
+        equals(*table.find(1), 10);
+        equals(*table.find(2), 20);
+        equals(table.find(3).has_value(), false);
+    });
+
+    suite.add_test("insert (existing)", [] () {
+        test_table table;
+
+        table.insert(1, 10);
+        table.insert(1, 20);
+
+        equals(*table.find(1), 10);
+    });
+
+    suite.add_test("emplace", [] () {
+        test_table table;
+
+        table.emplace(1, 10);
+
+        equals(*table.find(1), 10);
+    });
+
+    suite.add_test("erase", [] () {
+        test_table table;
+
+        table.insert(1, 10);
+        table.insert(2, 20);
+        table.erase(1);
+        table.erase(3);
+
+        equals(table.contains(1), false);
+        equals(table.contains(2), true);
+    });
+
+    suite.add_test("clear", [] () {
+        test_table table;
+
+        for(int i = 0; i < 256; ++i) {
+            table.insert(i, i);
+        }
+
+        table.clear();
+
+        for(int i = 0; i < 256; ++i) {
+            equals(table.contains(i), false);
+        }
+    });
+
+    suite.add_test("reserve", [] () {
+        test_table table;
+
+        table.insert(1, 10);
+        table.reserve(4096);
+
+        equals(*table.find(1), 10);
+
+        for(int i = 0; i < 4096; ++i) {
+            table.insert(i, i);
+        }
+
+        equals(*table.find(1), 10);
+        equals(*table.find(4095), 4095);
+    });
+
+    suite.add_test("visit", [] () {
+        test_table table;
+
+        table.insert(1, 10);
+
+        equals(table.visit(1, [] (int &value) { value += 5; }), true);
+        equals(table.visit(2, [] (int &value) { value += 5; }), false);
+        equals(*table.find(1), 15);
+
+        const test_table &const_table = table;
+        int seen = 0;
+
+        equals(const_table.visit(1, [&seen] (const int &value) { seen = value; }), true);
+        equals(seen, 15);
+    });
+
+    suite.add_test("for_each", [] () {
+        test_table table;
+        int key_sum = 0;
+        int value_sum = 0;
+
+        for(int i = 0; i < 100; ++i) {
+            table.insert(i, i * 2);
+        }
+
+        table.for_each([&key_sum, &value_sum] (const int &key, const int &value) {
+            key_sum += key;
+            value_sum += value;
+        });
+
+        equals(key_sum, 4950);
+        equals(value_sum, 9900);
+    });
+
+    suite.add_test("shard_index", [] () {
+        bool used[test_table::shard_count]{};
+        test_table::size_type used_count = 0;
+
+        for(int i = 0; i < 4096; ++i) {
+            const auto index = test_table::shard_index(i);
+
+            check(index < test_table::shard_count);
+
+            if(!used[index]) {
+                used[index] = true;
+                used_count++;
+            }
+        }
+
+        equals(used_count, test_table::shard_count);
+    });
+
+    suite.add_test("concurrent insert", [] () {
+        threaded_table table;
+        std::vector<std::thread> threads;
+
+        for(int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&table, t] () {
+                for(int i = 0; i < items_per_thread; ++i) {
+                    const int key = t * items_per_thread + i;
+
+                    table.insert(key, key + 1);
+                }
+            });
+        }
+
+        for(auto &thread : threads) {
+            thread.join();
+        }
+
+        for(int key = 0; key < thread_count * items_per_thread; ++key) {
+            equals(*table.find(key), key + 1);
+        }
+    });
+
+    suite.add_test("concurrent insert/find", [] () {
+        threaded_table table;
+        std::vector<std::thread> threads;
+        std::atomic<int> missing = 0;
+
+        for(int i = 0; i < items_per_thread; ++i) {
+            table.insert(i, i);
+        }
+
+        for(int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&table, &missing, t] () {
+                for(int i = 0; i < items_per_thread; ++i) {
+                    table.insert((t + 1) * items_per_thread + i, i);
+
+                    if(!table.contains(i)) {
+                        missing++;
+                    }
+                }
+            });
+        }
+
+        for(auto &thread : threads) {
+            thread.join();
+        }
+
+        equals(missing.load(), 0);
+    });
+
+    suite.add_test("concurrent visit", [] () {
+        threaded_table table;
+        std::vector<std::thread> threads;
+
+        table.insert(0, 0);
+
+        for(int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&table] () {
+                for(int i = 0; i < items_per_thread; ++i) {
+                    table.visit(0, [] (int &value) { value++; });
+                }
+            });
+        }
+
+        for(auto &thread : threads) {
+            thread.join();
+        }
+
+        equals(*table.find(0), thread_count * items_per_thread);
+    });
+
+    return suite.main(argc, argv);
+}
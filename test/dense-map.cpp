@@ -1,5 +1,7 @@
+#include <vector>
 #include <ccl/test/test.hpp>
 #include <ccl/dense-map.hpp>
+#include <ccl/string/ansi-string.hpp>
 #include <ccl/test/counting-test-allocator.hpp>
 
 using namespace ccl;
@@ -30,9 +32,38 @@ constexpr bool operator !=(const S& first, const S& second) {
     return first.a != second.a || first.b != second.b;
 }
 
+struct throwing_value {
+    explicit throwing_value(bool is_throwing) {
+        if(is_throwing) {
+            throw std::runtime_error{"Test error."};
+        }
+    }
+};
+
+struct small_policy : default_hashtable_policy {
+    static constexpr count_t minimum_capacity = 16;
+    static constexpr float max_load_factor = 0.5f;
+    static constexpr count_t growth_factor = 4;
+};
+
 int main(int argc, char **argv) {
     test_suite suite;
 
+    suite.add_test("ctor (empty)", [] () {
+        counting_test_allocator allocator;
+        test_map<int, int> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+        check(!x.contains(1));
+        check(x.find(1) == x.end());
+        check(x.begin() == x.end());
+
+        x.insert(1, 2);
+
+        check(x.contains(1));
+        differs(allocator.get_bytes_allocated_count(), 0);
+    });
+
     suite.add_test("insert ref", [] () {
         test_map<int, S> map;
 
@@ -84,6 +115,62 @@ int main(int argc, char **argv) {
         equals(map.at(3), S{ 3, 3.0 });
     });
 
+    suite.add_test("erase (dense order)", [] () {
+        test_map<int, int> map;
+
+        for(int i = 0; i < 100; ++i) {
+            map.insert(i, i * 2);
+        }
+
+        // The last item takes the place of the erased one
+        map.erase(10);
+
+        equals(map.size(), 99);
+        equals(map.begin_keys()[10], 99);
+        equals(map.begin_values()[10], 198);
+
+        for(int i = 0; i < 100; i += 2) {
+            map.erase(i);
+        }
+
+        equals(map.size(), 50);
+
+        for(int i = 0; i < 100; ++i) {
+            equals(map.contains(i), i % 2 == 1);
+
+            if(i % 2) {
+                equals(map.at(i), i * 2);
+            }
+        }
+
+        for(const auto &kv : map) {
+            equals(*kv.second, *kv.first * 2);
+        }
+    });
+
+    suite.add_test("erase (iterating)", [] () {
+        test_map<int, int> map;
+
+        for(int i = 0; i < 100; ++i) {
+            map.insert(i, i);
+        }
+
+        // Erasing moves the next item under the iterator
+        for(auto it = map.begin(); it != map.end();) {
+            if(*it->first % 3 == 0) {
+                map.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        equals(map.size(), 66);
+
+        for(int i = 0; i < 100; ++i) {
+            equals(map.contains(i), i % 3 != 0);
+        }
+    });
+
     suite.add_test("contains", [] () {
         test_map<int, S> map;
 
@@ -127,6 +214,51 @@ int main(int argc, char **argv) {
         check(n == 3);
     });
 
+    suite.add_test("begin/end (dense order)", [] () {
+        test_map<int, int> map;
+        int expected_key = 0;
+
+        for(int i = 0; i < 10000; ++i) {
+            map.insert(i, -i);
+        }
+
+        for(const auto &kv : map) {
+            equals(*kv.first, expected_key);
+            equals(*kv.second, -expected_key);
+
+            expected_key++;
+        }
+
+        equals(expected_key, 10000);
+        equals(map.end_keys() - map.begin_keys(), 10000);
+    });
+
+    suite.add_test("for_each", [] () {
+        test_map<int, int> map;
+        int expected_key = 0;
+
+        for(int i = 0; i < 10000; ++i) {
+            map.insert(i, 0);
+        }
+
+        map.for_each([] (const int &key, int &value) {
+            value = key * 3;
+        });
+
+        std::as_const(map).for_each([&expected_key] (const int &key, const int &value) {
+            equals(key, expected_key);
+            equals(value, key * 3);
+
+            expected_key++;
+        });
+
+        equals(expected_key, 10000);
+
+        test_map<int, int>{}.for_each([] (const int&, int&) {
+            check(false);
+        });
+    });
+
     suite.add_test("find", [] () {
         test_map<S, S> map;
 
@@ -253,5 +385,176 @@ int main(int argc, char **argv) {
         equals(map.size(), 0U);
     });
 
+    suite.add_test("find (transparent)", [] () {
+        dense_map<ansi_string<>, int, string_hash<>, counting_test_allocator> map;
+        const char * const raw = "key 1 and more";
+
+        map.emplace("key 0", 5);
+        map.emplace("key 1", 6);
+
+        const auto it = map.find(std::string_view{raw, 5});
+
+        check(it != map.end());
+        equals(*it->second, 6);
+        check(map.find(std::string_view{"key 2"}) == map.end());
+        check(std::as_const(map).find("key 0") != std::as_const(map).end());
+        check(map.contains("key 1"));
+        check(!map.contains(std::string_view{raw}));
+    });
+
+    suite.add_test("insert (move)", [] () {
+        using string_type = ansi_string<counting_test_allocator>;
+
+        counting_test_allocator string_allocator;
+        dense_map<string_type, string_type, string_hash<>, counting_test_allocator> map;
+
+        map.insert(
+            string_type{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator},
+            string_type{"value 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator}
+        );
+
+        // Moved: no string copied
+        equals(string_allocator.get_bytes_allocated_count(), 2);
+
+        const string_type key{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        // Already present: the value is assigned, the key is not copied
+        map.insert(key, string_type{"value 1", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator});
+
+        equals(string_allocator.get_bytes_allocated_count(), 3);
+        equals(map.size(), 1);
+        check(map.at("key 0") == "value 1");
+    });
+
+    suite.add_test("try_emplace", [] () {
+        using string_type = ansi_string<counting_test_allocator>;
+
+        counting_test_allocator string_allocator;
+        dense_map<string_type, string_type, string_hash<>, counting_test_allocator> map;
+
+        const auto [it, inserted] = map.try_emplace(
+            string_type{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator},
+            "value 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator
+        );
+
+        check(inserted);
+        check(*it->first == "key 0");
+        check(*it->second == "value 0");
+        equals(string_allocator.get_bytes_allocated_count(), 2);
+
+        string_type value{"value 1", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        // Already present: the value is not consumed
+        const auto [it2, inserted2] = map.try_emplace("key 0", std::move(value));
+
+        check(!inserted2);
+        check(it2 == it);
+        check(value == "value 1");
+        check(map.at("key 0") == "value 0");
+        equals(string_allocator.get_bytes_allocated_count(), 3);
+    });
+
+    suite.add_test("try_emplace (throwing constructor)", [] () {
+        test_map<int, throwing_value> map;
+
+        map.try_emplace(1, false);
+
+        throws<std::runtime_error>([&map] () {
+            map.try_emplace(2, true);
+        });
+
+        // Neither the dense entries nor the index entry are left behind
+        equals(map.size(), 1);
+        check(map.contains(1));
+        check(!map.contains(2));
+        equals(map.end_keys() - map.begin_keys(), 1);
+
+        check(map.try_emplace(2, false).second);
+        equals(map.size(), 2);
+        check(map.contains(2));
+    });
+
+    suite.add_test("copy (independent index)", [] () {
+        test_map<int, int> map1;
+
+        {
+            test_map<int, int> map2;
+
+            for(int i = 0; i < 100; ++i) {
+                map2.insert(i, i * 2);
+            }
+
+            map1 = map2;
+        }
+
+        // The index refers to the keys of the copy
+        const test_map<int, int> map3{map1};
+
+        map1.clear();
+
+        for(int i = 0; i < 100; ++i) {
+            equals(map3.at(i), i * 2);
+        }
+    });
+
+    suite.add_test("policy", [] () {
+        using my_map = dense_map<int, float, hash<int>, counting_test_allocator, small_policy>;
+
+        static_assert(std::is_same_v<my_map::index_map_type::policy_type, small_policy>);
+
+        my_map x;
+
+        for(int i = 0; i < 100; ++i) {
+            x.insert(i, static_cast<float>(i));
+        }
+
+        x.erase(50);
+
+        equals(x.size(), 99);
+        check(!x.contains(50));
+
+        for(int i = 0; i < 100; ++i) {
+            if(i != 50) {
+                equals(x.at(i), static_cast<float>(i));
+            }
+        }
+    });
+
+    suite.add_test("ctor (range)", [] () {
+        std::vector<pair<int, float>> input;
+
+        for(int i = 0; i < 1000; ++i) {
+            input.emplace_back(i, static_cast<float>(i));
+        }
+
+        // Later values override earlier ones
+        input.emplace_back(0, 1.0f);
+
+        const test_map<int, float> x{input};
+
+        equals(x.size(), 1000);
+        equals(x.at(0), 1.0f);
+
+        for(int i = 1; i < 1000; ++i) {
+            equals(x.at(i), static_cast<float>(i));
+        }
+    });
+
+    suite.add_test("reserve", [] () {
+        counting_test_allocator allocator;
+        test_map<int, float> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        x.reserve(10000);
+
+        const auto allocation_count = allocator.get_bytes_allocated_count();
+
+        for(int i = 0; i < 10000; ++i) {
+            x.insert(i, static_cast<float>(i));
+        }
+
+        equals(allocator.get_bytes_allocated_count(), allocation_count);
+        equals(x.size(), 10000);
+    });
+
     return suite.main(argc, argv);
 }
@@ -0,0 +1,138 @@
+#include <ccl/test/test.hpp>
+#include <ccl/ecs/archetype.hpp>
+#include <ccl/test/counting-test-allocator.hpp>
+
+using namespace ccl;
+using namespace ccl::ecs;
+
+using test_archetype = archetype<counting_test_allocator>;
+
+struct position { float x, y; };
+struct velocity { float x, y; };
+struct name { int id; };
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("component_id", [] () {
+        check(component_id<position> != component_id<velocity>);
+        check(component_id<position> != component_id<name>);
+        equals(component_id<position>, component_id<position>);
+    });
+
+    suite.add_test("add_column", [] () {
+        counting_test_allocator allocator;
+
+        {
+            test_archetype a{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+            a.add_column<velocity>();
+            a.add_column<position>();
+
+            equals(a.component_count(), 2);
+            check(a.has_component<position>());
+            check(a.has_component<velocity>());
+            check(!a.has_component<name>());
+            equals(a.signature(), test_archetype::make_signature({ component_id<velocity>, component_id<position> }));
+            equals(a.find_column(component_id<name>), test_archetype::invalid_index);
+        }
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+    });
+
+    suite.add_test("get_components", [] () {
+        test_archetype a;
+
+        a.add_column<position>();
+
+#ifdef CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS
+        throws<std::invalid_argument>([&a] () {
+            (void)a.get_components<velocity>();
+        });
+#endif // CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS
+
+        equals(a.get_components<position>().size(), 0);
+    });
+
+    suite.add_test("push_entity", [] () {
+        test_archetype a;
+
+        a.add_column<position>();
+
+        for(entity_t e = 0; e < 10; ++e) {
+            equals(a.push_entity(e), e);
+            a.emplace_component<position>(static_cast<float>(e), 0.0f);
+        }
+
+        equals(a.size(), 10);
+        equals(a.entities()[3], 3);
+        equals(a.get_components<position>()[3].x, 3.0f);
+    });
+
+    suite.add_test("erase_row", [] () {
+        test_archetype a;
+
+        a.add_column<position>();
+        a.add_column<name>();
+
+        for(entity_t e = 0; e < 3; ++e) {
+            a.push_entity(e);
+            a.emplace_component<position>(static_cast<float>(e), 0.0f);
+            a.emplace_component<name>(static_cast<int>(e));
+        }
+
+        // The last row takes the place of the erased one
+        equals(a.erase_row(0), 2);
+        equals(a.size(), 2);
+        equals(a.entities()[0], 2);
+        equals(a.get_components<position>()[0].x, 2.0f);
+        equals(a.get_components<name>()[0].id, 2);
+
+        equals(a.erase_row(1), invalid_entity);
+        equals(a.size(), 1);
+        equals(a.get_components<name>().size(), 1);
+    });
+
+    suite.add_test("move_row", [] () {
+        test_archetype source;
+        test_archetype destination;
+
+        source.add_column<position>();
+        source.add_column<name>();
+        destination.add_columns_of(source, component_id<name>);
+        destination.add_column<velocity>();
+
+        check(!destination.has_component<name>());
+
+        for(entity_t e = 0; e < 3; ++e) {
+            source.push_entity(e);
+            source.emplace_component<position>(static_cast<float>(e), 0.0f);
+            source.emplace_component<name>(static_cast<int>(e));
+        }
+
+        equals(source.move_row(1, destination), 2);
+        destination.emplace_component<velocity>(1.0f, 1.0f);
+
+        equals(source.size(), 2);
+        equals(source.entities()[1], 2);
+        equals(destination.size(), 1);
+        equals(destination.entities()[0], 1);
+        equals(destination.get_components<position>()[0].x, 1.0f);
+        equals(destination.get_components<velocity>()[0].x, 1.0f);
+    });
+
+    suite.add_test("extends", [] () {
+        test_archetype a;
+        test_archetype b;
+
+        a.add_column<position>();
+        b.add_columns_of(a);
+        b.add_column<velocity>();
+
+        check(b.extends(a, component_id<velocity>));
+        check(!b.extends(a, component_id<name>));
+        check(!a.extends(b, component_id<velocity>));
+    });
+
+    return suite.main(argc, argv);
+}
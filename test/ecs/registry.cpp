@@ -0,0 +1,298 @@
+#include <ccl/test/test.hpp>
+#include <ccl/ecs/registry.hpp>
+#include <ccl/test/counting-test-allocator.hpp>
+
+using namespace ccl;
+using namespace ccl::ecs;
+
+using test_registry = registry<counting_test_allocator>;
+
+struct position { float x, y; };
+struct velocity { float x, y; };
+struct health { int value; };
+
+struct collide_a { int value; };
+struct collide_b { int value; };
+struct collide_c { int value; };
+
+namespace ccl::ecs {
+    // The signatures of {collide_a, collide_b} and {collide_c} are equal, as
+    // are the ones of {collide_a, collide_c} and {collide_b}.
+    template<> inline constexpr component_id_t component_id<collide_a> = 1;
+    template<> inline constexpr component_id_t component_id<collide_b> = 2;
+    template<> inline constexpr component_id_t component_id<collide_c> = 3;
+}
+
+struct throwing_component {
+    explicit throwing_component(int) { throw std::runtime_error{"Test error."}; }
+};
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("ctor", [] () {
+        counting_test_allocator allocator;
+
+        {
+            test_registry r{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+            equals(r.size(), 0);
+            check(r.is_empty());
+            equals(r.archetypes().size(), 1);
+        }
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+    });
+
+    suite.add_test("create", [] () {
+        test_registry r;
+
+        const entity_t e1 = r.create(position{1, 2}, velocity{3, 4});
+        const entity_t e2 = r.create(velocity{5, 6}, position{7, 8});
+        const entity_t e3 = r.create();
+
+        check(e1 != e2);
+        check(e2 != e3);
+        equals(r.size(), 3);
+        check(r.is_alive(e1));
+        check(r.is_alive(e3));
+
+        // Same components, in any order, share the same archetype
+        equals(r.archetypes().size(), 2);
+
+        equals(r.get<position>(e1).x, 1.0f);
+        equals(r.get<velocity>(e1).y, 4.0f);
+        equals(r.get<position>(e2).x, 7.0f);
+        check(r.has<position>(e2));
+        check(!r.has<position>(e3));
+    });
+
+    suite.add_test("destroy", [] () {
+        test_registry r;
+
+        const entity_t e1 = r.create(health{1});
+        const entity_t e2 = r.create(health{2});
+        const entity_t e3 = r.create(health{3});
+
+        r.destroy(e1);
+
+        check(!r.is_alive(e1));
+        equals(r.size(), 2);
+        equals(r.get<health>(e2).value, 2);
+        equals(r.get<health>(e3).value, 3);
+
+        throws<std::invalid_argument>([&r, e1] () {
+            r.destroy(e1);
+        });
+
+        // Entities are never reused
+        check(r.create(health{4}) != e1);
+    });
+
+    suite.add_test("add", [] () {
+        test_registry r;
+
+        const entity_t e1 = r.create(position{1, 2});
+        const entity_t e2 = r.create(position{3, 4});
+
+        equals(r.add<velocity>(e1, 5.0f, 6.0f).x, 5.0f);
+
+        check(r.has<velocity>(e1));
+        check(!r.has<velocity>(e2));
+        equals(r.get<position>(e1).x, 1.0f);
+        equals(r.get<velocity>(e1).y, 6.0f);
+        equals(r.get<position>(e2).x, 3.0f);
+        equals(r.archetypes().size(), 3);
+
+        // Assign an existing component
+        r.add<velocity>(e1, 7.0f, 8.0f);
+
+        equals(r.get<velocity>(e1).x, 7.0f);
+        equals(r.archetypes().size(), 3);
+
+        r.add<velocity>(e2, 0.0f, 0.0f);
+
+        equals(r.archetypes().size(), 3);
+        equals(r.get<position>(e2).x, 3.0f);
+    });
+
+    suite.add_test("add (from own components)", [] () {
+        test_registry r;
+
+        const entity_t e1 = r.create(health{10});
+        const entity_t e2 = r.create(health{20});
+
+        // The argument refers to the row e2 is moved to
+        equals(r.add<velocity>(e1, static_cast<float>(r.get<health>(e1).value), 0.0f).x, 10.0f);
+        equals(r.get<velocity>(e1).x, 10.0f);
+        equals(r.get<health>(e1).value, 10);
+        equals(r.get<health>(e2).value, 20);
+    });
+
+    suite.add_test("add (throwing constructor)", [] () {
+        test_registry r;
+
+        const entity_t e1 = r.create(health{1});
+        const entity_t e2 = r.create(health{2});
+
+        throws<std::runtime_error>([&r, e1] () {
+            r.add<throwing_component>(e1, 0);
+        });
+
+        check(!r.has<throwing_component>(e1));
+        equals(r.get<health>(e1).value, 1);
+        equals(r.get<health>(e2).value, 2);
+        equals(r.view<health>().size(), 2);
+        equals(r.view<health, throwing_component>().size(), 0);
+
+        r.add<velocity>(e1, 3.0f, 4.0f);
+
+        equals(r.get<velocity>(e1).x, 3.0f);
+        equals(r.get<health>(e1).value, 1);
+    });
+
+    suite.add_test("create (throwing constructor)", [] () {
+        test_registry r;
+
+        const entity_t e1 = r.create(health{1}, position{2, 3});
+
+        throws<std::runtime_error>([&r] () {
+            CCLUNUSED const entity_t e = r.create(health{4}, throwing_component{0}, position{5, 6});
+        });
+
+        // No row left with missing components
+        equals(r.size(), 1);
+        equals(r.view<health>().size(), 1);
+        equals(r.view<position>().size(), 1);
+
+        for(archetype<counting_test_allocator> * const a : r.archetypes()) {
+            if(a->has_component<health>()) {
+                equals(a->get_components<health>().size(), a->size());
+            }
+
+            if(a->has_component<position>()) {
+                equals(a->get_components<position>().size(), a->size());
+            }
+        }
+
+        const entity_t e2 = r.create(health{7}, position{8, 9});
+
+        check(e1 != e2);
+        equals(r.get<health>(e2).value, 7);
+        equals(r.get<position>(e1).x, 2.0f);
+    });
+
+    suite.add_test("signature collision", [] () {
+        test_registry r;
+
+        const entity_t e1 = r.create(collide_a{1}, collide_b{2});
+        const entity_t e2 = r.create(collide_c{3});
+        const entity_t e3 = r.create(collide_b{4});
+
+        equals(r.archetypes().size(), 4);
+        check(!r.has<collide_c>(e1));
+        check(!r.has<collide_a>(e2));
+        equals(r.get<collide_b>(e1).value, 2);
+        equals(r.get<collide_c>(e2).value, 3);
+
+        // Moving to {collide_a, collide_c}, with the signature of {collide_b}
+        r.add<collide_a>(e2, 5);
+
+        equals(r.archetypes().size(), 5);
+        equals(r.get<collide_a>(e2).value, 5);
+        equals(r.get<collide_c>(e2).value, 3);
+        check(!r.has<collide_b>(e2));
+        equals(r.view<collide_b>().size(), 2);
+
+        // Back to {collide_c}
+        r.remove<collide_a>(e2);
+
+        equals(r.archetypes().size(), 5);
+        check(!r.has<collide_a>(e2));
+        equals(r.get<collide_b>(e3).value, 4);
+    });
+
+    suite.add_test("remove", [] () {
+        counting_test_allocator allocator;
+
+        {
+            test_registry r{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+            const entity_t e1 = r.create(position{1, 2}, health{10});
+            const entity_t e2 = r.create(position{3, 4}, health{20});
+
+            check(r.remove<health>(e1));
+            check(!r.remove<health>(e1));
+            check(!r.has<health>(e1));
+            equals(r.get<position>(e1).x, 1.0f);
+            equals(r.get<health>(e2).value, 20);
+
+#ifdef CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS
+            throws<std::invalid_argument>([&r, e1] () {
+                (void)r.get<health>(e1);
+            });
+#endif // CCL_FEATURE_ECS_CHECK_ARCHETYPE_COMPONENTS
+
+            // Moving back and forth reuses the same archetypes
+            const auto archetype_count = r.archetypes().size();
+
+            r.add<health>(e1, 30);
+            r.remove<health>(e2);
+
+            equals(r.archetypes().size(), archetype_count);
+            equals(r.get<health>(e1).value, 30);
+            equals(r.get<position>(e2).x, 3.0f);
+        }
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+    });
+
+    suite.add_test("view", [] () {
+        test_registry r;
+
+        for(int i = 0; i < 1000; ++i) {
+            const entity_t e = r.create(position{static_cast<float>(i), 0}, velocity{1, 2});
+
+            if(i % 2) {
+                r.add<health>(e, i);
+            }
+        }
+
+        r.create(position{-1, -1});
+
+        const auto v = r.view<position, const velocity>();
+        float sum = 0;
+
+        equals(v.size(), 1000);
+
+        v.for_each([] (position &p, const velocity &vel) {
+            p.x += vel.x;
+            p.y += vel.y;
+        });
+
+        v.for_each([&sum] (const position &p, const velocity&) {
+            sum += p.x;
+        });
+
+        equals(sum, 500500.0f);
+        equals(r.view<health>().size(), 500);
+        equals(r.view<position>().size(), 1001);
+    });
+
+    suite.add_test("move", [] () {
+        test_registry r;
+
+        const entity_t e = r.create(health{1});
+        test_registry moved{std::move(r)};
+        test_registry assigned;
+
+        assigned.create(health{2});
+        assigned = std::move(moved);
+
+        equals(assigned.size(), 1);
+        equals(assigned.get<health>(e).value, 1);
+        check(assigned.create() != e);
+    });
+
+    return suite.main(argc, argv);
+}
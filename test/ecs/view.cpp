@@ -0,0 +1,103 @@
+#include <utility>
+#include <ccl/test/test.hpp>
+#include <ccl/ecs/registry.hpp>
+#include <ccl/test/counting-test-allocator.hpp>
+
+using namespace ccl;
+using namespace ccl::ecs;
+
+using test_registry = registry<counting_test_allocator>;
+
+struct position { float x, y; };
+struct velocity { float x, y; };
+
+template<int N>
+struct tag { int value; };
+
+template<int ...N>
+static void create_tagged(test_registry &r, std::integer_sequence<int, N...>) {
+    (r.create(position{0, 0}, tag<N>{N}), ...);
+}
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("ctor (empty)", [] () {
+        test_registry r;
+
+        r.create(position{0, 0});
+
+        const auto v = r.view<velocity>();
+
+        equals(v.archetypes().size(), 0);
+        equals(v.size(), 0);
+        check(v.is_empty());
+
+        v.for_each([] (velocity&) {
+            check(false);
+        });
+    });
+
+    suite.add_test("for_each (entity)", [] () {
+        test_registry r;
+        entity_t entity_sum = 0;
+        entity_t expected_sum = 0;
+
+        for(int i = 0; i < 100; ++i) {
+            expected_sum += r.create(position{0, 0});
+        }
+
+        r.view<position>().for_each([&entity_sum] (const entity_t e, position &p) {
+            entity_sum += e;
+            p.x = static_cast<float>(e);
+        });
+
+        equals(entity_sum, expected_sum);
+        equals(r.get<position>(42).x, 42.0f);
+    });
+
+    suite.add_test("for_each_chunk", [] () {
+        constexpr count_t page_size = CCL_PAGE_SIZE;
+        constexpr count_t entity_count = page_size * 2 + 3;
+
+        test_registry r;
+        count_t chunk_count = 0;
+        count_t row_count = 0;
+
+        for(count_t i = 0; i < entity_count; ++i) {
+            r.create(position{static_cast<float>(i), 0}, velocity{1, 0});
+        }
+
+        r.view<position, const velocity>().for_each_chunk(
+            [&] (const count_t count, const entity_t * const entities, position * const p, const velocity * const v) {
+                for(count_t i = 0; i < count; ++i) {
+                    equals(p[i].x, static_cast<float>(entities[i]));
+                    p[i].x += v[i].x;
+                }
+
+                ++chunk_count;
+                row_count += count;
+            }
+        );
+
+        equals(chunk_count, 3);
+        equals(row_count, entity_count);
+        equals(r.get<position>(0).x, 1.0f);
+    });
+
+    suite.add_test("archetype count", [] () {
+        test_registry r;
+
+        create_tagged(r, std::make_integer_sequence<int, CCL_ECS_VIEW_MAX_ARCHETYPE_COUNT>{});
+
+        equals(r.view<position>().archetypes().size(), CCL_ECS_VIEW_MAX_ARCHETYPE_COUNT);
+
+        r.create(position{0, 0});
+
+        throws<std::out_of_range>([&r] () {
+            (void)r.view<position>();
+        });
+    });
+
+    return suite.main(argc, argv);
+}
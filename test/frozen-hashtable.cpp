@@ -0,0 +1,256 @@
+#include <cstring>
+#include <span>
+#include <vector>
+#include <ccl/test/test.hpp>
+#include <ccl/test/counting-test-allocator.hpp>
+#include <ccl/frozen-hashtable.hpp>
+#include <ccl/hashtable.hpp>
+#include <ccl/dense-map.hpp>
+
+using namespace ccl;
+
+using test_hashtable = hashtable<int, float, hash<int>, counting_test_allocator>;
+using test_frozen = frozen_hashtable<int, float>;
+
+/**
+ * Aligned storage for an image.
+ */
+struct image_buffer {
+    std::vector<uint64_t> words;
+
+    explicit image_buffer(const std::size_t size) : words(size / sizeof(uint64_t) + 1) {}
+
+    std::span<std::byte> bytes() {
+        return std::as_writable_bytes(std::span{words});
+    }
+};
+
+template<typename Frozen, typename Map>
+static image_buffer freeze(const Map &map) {
+    image_buffer buffer{Frozen::image_size(map)};
+
+    equals(Frozen::freeze(map, buffer.bytes()), Frozen::image_size(map));
+
+    return buffer;
+}
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("find (hashtable)", [] () {
+        test_hashtable map;
+
+        for(int i = 0; i < 1000; ++i) {
+            map.insert(i, static_cast<float>(i) * 0.5f);
+        }
+
+        image_buffer buffer = freeze<test_frozen>(map);
+        const test_frozen frozen{buffer.bytes()};
+
+        equals(frozen.size(), 1000);
+        check(frozen.capacity() > frozen.size());
+
+        for(int i = 0; i < 1000; ++i) {
+            check(frozen.contains(i));
+            equals(*frozen.find(i), static_cast<float>(i) * 0.5f);
+            equals(frozen.at(i), static_cast<float>(i) * 0.5f);
+        }
+
+        for(int i = 1000; i < 2000; ++i) {
+            check(!frozen.contains(i));
+            equals(frozen.find(i), nullptr);
+        }
+
+        throws<std::out_of_range>([&frozen] () {
+            CCLUNUSED auto x = frozen.at(1000);
+        });
+    });
+
+    suite.add_test("find (dense map)", [] () {
+        dense_map<int, float, hash<int>, counting_test_allocator> map;
+
+        for(int i = 0; i < 100; ++i) {
+            map.insert(i, static_cast<float>(i));
+        }
+
+        image_buffer buffer = freeze<test_frozen>(map);
+        const test_frozen frozen{buffer.bytes()};
+
+        equals(frozen.size(), 100);
+
+        for(int i = 0; i < 100; ++i) {
+            equals(frozen.at(i), static_cast<float>(i));
+        }
+
+        check(!frozen.contains(100));
+    });
+
+    suite.add_test("find (collisions)", [] () {
+        struct same_hash {
+            constexpr hash_t operator()(const int&) const {
+                return 1;
+            }
+        };
+
+        using frozen_type = frozen_hashtable<int, float, same_hash>;
+
+        hashtable<int, float, same_hash, counting_test_allocator> map;
+
+        for(int i = 0; i < 100; ++i) {
+            map.insert(i, static_cast<float>(i));
+        }
+
+        image_buffer buffer = freeze<frozen_type>(map);
+        const frozen_type frozen{buffer.bytes()};
+
+        for(int i = 0; i < 100; ++i) {
+            equals(frozen.at(i), static_cast<float>(i));
+        }
+
+        check(!frozen.contains(100));
+    });
+
+    suite.add_test("find (empty)", [] () {
+        test_hashtable map;
+        image_buffer buffer = freeze<test_frozen>(map);
+        const test_frozen frozen{buffer.bytes()};
+        const test_frozen default_frozen;
+
+        equals(frozen.size(), 0);
+        check(frozen.is_empty());
+        check(!frozen.contains(0));
+        check(!default_frozen.contains(0));
+        equals(default_frozen.capacity(), 0);
+    });
+
+    suite.add_test("relocate", [] () {
+        test_hashtable map;
+
+        for(int i = 0; i < 100; ++i) {
+            map.insert(i, static_cast<float>(i));
+        }
+
+        image_buffer buffer = freeze<test_frozen>(map);
+        image_buffer copy{buffer.bytes().size()};
+
+        std::memcpy(copy.bytes().data(), buffer.bytes().data(), buffer.bytes().size());
+        buffer.words.assign(buffer.words.size(), 0);
+
+        const test_frozen frozen{copy.bytes()};
+
+        for(int i = 0; i < 100; ++i) {
+            equals(frozen.at(i), static_cast<float>(i));
+        }
+    });
+
+    suite.add_test("for_each", [] () {
+        test_hashtable map;
+        int key_sum = 0;
+        float value_sum = 0;
+
+        for(int i = 0; i < 100; ++i) {
+            map.insert(i, 1.0f);
+        }
+
+        image_buffer buffer = freeze<test_frozen>(map);
+        const test_frozen frozen{buffer.bytes()};
+
+        frozen.for_each([&key_sum, &value_sum] (const int &key, const float &value) {
+            key_sum += key;
+            value_sum += value;
+        });
+
+        equals(key_sum, 4950);
+        equals(value_sum, 100.0f);
+    });
+
+    suite.add_test("invalid image", [] () {
+        test_hashtable map;
+
+        map.insert(1, 1.0f);
+
+        image_buffer buffer = freeze<test_frozen>(map);
+        const auto image = buffer.bytes();
+
+        check(test_frozen::is_valid_image(image));
+
+        // Truncated
+        check(!test_frozen::is_valid_image(image.first(sizeof(frozen_hashtable_header))));
+        check(!test_frozen::is_valid_image(image.first(4)));
+
+        // Different types
+        check(!frozen_hashtable<int, double>::is_valid_image(image));
+        check(!frozen_hashtable<short, float>::is_valid_image(image));
+
+        // Misaligned
+        image_buffer shifted{image.size() + 1};
+        std::memcpy(shifted.bytes().data() + 1, image.data(), image.size());
+        check(!test_frozen::is_valid_image(shifted.bytes().subspan(1)));
+
+        throws<std::invalid_argument>([&image] () {
+            test_frozen frozen{image.first(4)};
+        });
+
+        // Bad magic
+        image[0] ^= std::byte{0xff};
+        check(!test_frozen::is_valid_image(image));
+    });
+
+    suite.add_test("invalid image (overflowing offsets)", [] () {
+        test_hashtable map;
+
+        map.insert(1, 1.0f);
+
+        image_buffer buffer = freeze<test_frozen>(map);
+        const auto image = buffer.bytes();
+        frozen_hashtable_header header;
+
+        std::memcpy(&header, image.data(), sizeof(header));
+
+        for(uint64_t frozen_hashtable_header::*offset : { &frozen_hashtable_header::control_offset, &frozen_hashtable_header::key_offset, &frozen_hashtable_header::value_offset }) {
+            frozen_hashtable_header corrupt = header;
+
+            // Wraps around to a small end offset
+            corrupt.*offset = ~static_cast<uint64_t>(0) - 7;
+            std::memcpy(image.data(), &corrupt, sizeof(corrupt));
+
+            check(!test_frozen::is_valid_image(image));
+        }
+    });
+
+    suite.add_test("find (corrupt image)", [] () {
+        test_hashtable map;
+
+        for(int i = 0; i < 10; ++i) {
+            map.insert(i, static_cast<float>(i));
+        }
+
+        image_buffer buffer = freeze<test_frozen>(map);
+        const auto image = buffer.bytes();
+        frozen_hashtable_header header;
+
+        std::memcpy(&header, image.data(), sizeof(header));
+
+        // No empty slot left to stop the probe
+        std::memset(image.data() + header.control_offset, 0xff, header.key_offset - header.control_offset);
+
+        const test_frozen frozen{image};
+
+        check(!frozen.contains(100));
+        check(frozen.find(-1) == nullptr);
+    });
+
+    suite.add_test("freeze (small image)", [] () {
+        test_hashtable map;
+
+        map.insert(1, 1.0f);
+
+        image_buffer buffer{test_frozen::image_size(map)};
+
+        throws<std::invalid_argument>([&map, &buffer] () {
+            test_frozen::freeze(map, buffer.bytes().first(test_frozen::image_size(map) - 1));
+        });
+    });
+
+    return suite.main(argc, argv);
+}
@@ -0,0 +1,257 @@
+#define CCL_ENABLE_FEATURE_HASH_STATS
+
+#include <thread>
+#include <vector>
+#include <ccl/test/test.hpp>
+#include <ccl/test/counting-test-allocator.hpp>
+#include <ccl/hashtable.hpp>
+#include <ccl/set.hpp>
+
+using namespace ccl;
+
+using test_map = hashtable<int, int, hash<int>, counting_test_allocator>;
+using test_set = set<int, hash<int>, counting_test_allocator>;
+
+struct same_hash {
+    constexpr hash_t operator()(const int&) const {
+        return 1;
+    }
+};
+
+struct incremental_policy : default_hashtable_policy {
+    static constexpr bool incremental_rehash = true;
+};
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("hashtable (empty)", [] () {
+        test_map x;
+        const hash_stats stats = x.get_stats();
+
+        equals(stats.capacity, 0);
+        equals(stats.size, 0);
+        equals(stats.rehash_count, 0);
+        equals(stats.probe_count, 0);
+        equals(stats.load_factor(), 0.0);
+        equals(stats.mean_probe_length(), 0.0);
+    });
+
+    suite.add_test("hashtable (probe)", [] () {
+        test_map x;
+
+        for(int i = 0; i < 100; ++i) {
+            x.insert(i, i);
+        }
+
+        x.reset_stats();
+
+        for(int i = 0; i < 100; ++i) {
+            check(x.contains(i));
+        }
+
+        const hash_stats stats = x.get_stats();
+
+        equals(stats.size, 100);
+        equals(stats.probe_count, 100);
+        check(stats.max_probe_length >= 1);
+        check(stats.mean_probe_length() >= 1.0);
+        check(stats.mean_probe_length() <= stats.max_probe_length);
+        equals(stats.rehash_count, 0);
+    });
+
+    suite.add_test("hashtable (concurrent lookups)", [] () {
+        constexpr int thread_count = 4;
+        constexpr int lookup_count = 10000;
+        test_map x;
+
+        for(int i = 0; i < 100; ++i) {
+            x.insert(i, i);
+        }
+
+        x.reset_stats();
+
+        {
+            std::vector<std::thread> threads;
+
+            for(int t = 0; t < thread_count; ++t) {
+                threads.emplace_back([&x] () {
+                    const test_map &y = x;
+
+                    for(int i = 0; i < lookup_count; ++i) {
+                        CCLUNUSED const bool found = y.contains(i % 100);
+                    }
+                });
+            }
+
+            for(std::thread &t : threads) {
+                t.join();
+            }
+        }
+
+        equals(x.get_stats().probe_count, thread_count * lookup_count);
+    });
+
+    suite.add_test("hashtable (rehash)", [] () {
+        test_map x;
+
+        for(int i = 0; i < static_cast<int>(test_map::minimum_capacity); ++i) {
+            x.insert(i, i);
+        }
+
+        const hash_stats stats = x.get_stats();
+
+        check(stats.rehash_count > 0);
+        check(stats.bytes_moved > 0);
+        equals(stats.capacity, x.capacity());
+        check(stats.load_factor() <= test_map::max_load_factor);
+    });
+
+    suite.add_test("hashtable (rehash, incremental)", [] () {
+        using my_map = hashtable<int, int, hash<int>, counting_test_allocator, incremental_policy>;
+
+        my_map x;
+
+        for(int i = 0; i < static_cast<int>(my_map::minimum_capacity) * 4; ++i) {
+            x.insert(i, i);
+        }
+
+        const hash_stats stats = x.get_stats();
+
+        check(stats.rehash_count > 0);
+        check(stats.bytes_moved > 0);
+        equals(stats.size, my_map::minimum_capacity * 4);
+    });
+
+    suite.add_test("hashtable (overflow)", [] () {
+        using my_map = hashtable<int, int, same_hash, counting_test_allocator>;
+
+        my_map x;
+        const int n = static_cast<int>(x.get_chunk_size() + my_map::stash_size + 1);
+
+        for(int i = 0; i < n; ++i) {
+            x.insert(i, i);
+        }
+
+        const hash_stats stats = x.get_stats();
+
+        check(stats.failed_chunk_count > 0);
+        check(stats.chunk_growth_count > 0);
+        equals(stats.chunk_size, x.get_chunk_size());
+        equals(stats.size, n);
+    });
+
+    suite.add_test("hashtable (reset)", [] () {
+        test_map x;
+
+        for(int i = 0; i < static_cast<int>(test_map::minimum_capacity); ++i) {
+            x.insert(i, i);
+        }
+
+        x.reset_stats();
+
+        const hash_stats stats = x.get_stats();
+
+        equals(stats.rehash_count, 0);
+        equals(stats.bytes_moved, 0);
+        equals(stats.probe_count, 0);
+        equals(stats.max_probe_length, 0);
+        equals(stats.size, test_map::minimum_capacity);
+    });
+
+    suite.add_test("set (merge)", [] () {
+        test_set x;
+        test_set y;
+
+        for(int i = 0; i < 1000; ++i) {
+            y.insert(i);
+        }
+
+        x.insert(-1);
+        x.merge(y);
+
+        // Reserved for all the keys up front
+        const hash_stats stats = x.get_stats();
+
+        equals(stats.rehash_count, 1);
+        equals(stats.size, 1001);
+    });
+
+    suite.add_test("set (probe)", [] () {
+        test_set x;
+
+        for(int i = 0; i < 100; ++i) {
+            x.insert(i);
+        }
+
+        x.reset_stats();
+
+        for(int i = 0; i < 200; ++i) {
+            equals(x.contains(i), i < 100);
+        }
+
+        const hash_stats stats = x.get_stats();
+
+        equals(stats.size, 100);
+        equals(stats.capacity, x.capacity());
+        equals(stats.chunk_size, CCL_SET_KEY_CHUNK_SIZE);
+        equals(stats.probe_count, 200);
+        equals(stats.max_probe_length, CCL_SET_KEY_CHUNK_SIZE);
+    });
+
+    suite.add_test("set (overflow)", [] () {
+        struct strided_hash {
+            constexpr hash_t operator()(const int &x) const {
+                return static_cast<hash_t>(x) * test_set::minimum_capacity;
+            }
+        };
+
+        using my_set = set<int, strided_hash, counting_test_allocator>;
+
+        my_set x;
+
+        // All the keys share the first chunk until the set grows.
+        for(int i = 0; i <= CCL_SET_KEY_CHUNK_SIZE; ++i) {
+            x.insert(i);
+        }
+
+        const hash_stats stats = x.get_stats();
+
+        equals(stats.failed_chunk_count, 1);
+        equals(stats.rehash_count, 1);
+        equals(stats.bytes_moved, CCL_SET_KEY_CHUNK_SIZE * sizeof(int));
+        equals(stats.size, CCL_SET_KEY_CHUNK_SIZE + 1);
+    });
+
+    suite.add_test("hashtable (range ctor)", [] () {
+        std::vector<pair<int, int>> input;
+
+        for(int i = 0; i < 10000; ++i) {
+            input.emplace_back(i, i);
+        }
+
+        const test_map x{input};
+        const hash_stats stats = x.get_stats();
+
+        // Allocated once, at the final capacity
+        equals(stats.rehash_count, 0);
+        equals(stats.size, 10000);
+    });
+
+    suite.add_test("set (range ctor)", [] () {
+        std::vector<int> input;
+
+        for(int i = 0; i < 10000; ++i) {
+            input.push_back(i);
+        }
+
+        const test_set x{input};
+        const hash_stats stats = x.get_stats();
+
+        // Allocated once, at the final capacity
+        equals(stats.rehash_count, 0);
+        equals(stats.size, 10000);
+    });
+
+    return suite.main(argc, argv);
+}
@@ -1,5 +1,6 @@
 #include <ccl/test/test.hpp>
 #include <ccl/hash.hpp>
+#include <ccl/string/ansi-string.hpp>
 
 using namespace ccl;
 
@@ -180,5 +181,17 @@ int main(int argc, char **argv) {
         differs(hash<float>{}(value), hash<float>{}(-value));
     });
 
+    suite.add_test("string_hash", [] () {
+        const ansi_string<> str{"hello world"};
+        const char * const raw = "hello world!";
+        string_hash<> h;
+
+        equals(h(str), str.hash());
+        equals(h(std::string_view{raw, 11}), str.hash());
+        equals(h("hello world"), str.hash());
+        differs(h(raw), str.hash());
+        equals(h(ansi_string<>{}), ansi_string<>{}.hash());
+    });
+
     return suite.main(argc, argv);
 }
@@ -6,6 +6,35 @@ using namespace ccl;
 using test_hashtable = hashtable<int, int>;
 using test_iterator = hashtable_iterator<test_hashtable>;
 
+struct incremental_policy : default_hashtable_policy {
+    static constexpr bool incremental_rehash = true;
+    static constexpr count_t incremental_rehash_step = 4;
+};
+
+template<typename Hashtable>
+static void check_traversal(Hashtable &t) {
+    typename Hashtable::size_type count = 0;
+
+    for(auto it = t.begin(); it != t.end(); ++it) {
+        check(t.contains(*(*it).first));
+        count++;
+    }
+
+    equals(count, t.size());
+
+    if(count > 0) {
+        auto it = t.end();
+
+        do {
+            --it;
+            check(t.contains(*(*it).first));
+            count--;
+        } while(it != t.begin());
+
+        equals(count, 0);
+    }
+}
+
 int main(int argc, char **argv) {
     test_suite suite;
 
@@ -183,6 +212,32 @@ int main(int argc, char **argv) {
         equals(it.index, 0);
     });
 
+    suite.add_test("traversal (sparse)", [] () {
+        test_hashtable t;
+
+        for(int i = 0; i < 1000; ++i) {
+            t[i] = i;
+        }
+
+        for(int i = 0; i < 1000; ++i) {
+            if(i % 100) {
+                t.erase(i);
+            }
+        }
+
+        equals(t.size(), 10);
+        check_traversal(t);
+    });
+
+    suite.add_test("traversal (incremental rehash)", [] () {
+        hashtable<int, int, hash<int>, allocator, incremental_policy> t;
+
+        for(int i = 0; i < 500; ++i) {
+            t[i] = i;
+            check_traversal(t);
+        }
+    });
+
     suite.add_test("operator == (same table, different index)", [] () {
         test_hashtable t;
 
@@ -1,7 +1,11 @@
 #include <ranges>
 #include <iterator>
+#include <string>
+#include <vector>
 #include <ccl/test/test.hpp>
+#include <ccl/vector.hpp>
 #include <ccl/hashtable.hpp>
+#include <ccl/string/nul-terminated.hpp>
 #include <ccl/test/counting-test-allocator.hpp>
 
 using namespace ccl;
@@ -51,9 +55,97 @@ struct hash<spy> {
     }
 };
 
+struct stored_hash_policy : default_hashtable_policy {
+    static constexpr bool store_hashes = true;
+};
+
+template<typename K, typename V, typename H = hash<K>>
+using stored_hash_map = hashtable<K, V, H, counting_test_allocator, stored_hash_policy>;
+
+struct interleaved_policy : default_hashtable_policy {
+    static constexpr bool interleave_items = true;
+};
+
+template<typename K, typename V, typename H = hash<K>>
+using interleaved_map = hashtable<K, V, H, counting_test_allocator, interleaved_policy>;
+
+struct incremental_policy : default_hashtable_policy {
+    static constexpr bool incremental_rehash = true;
+    static constexpr count_t incremental_rehash_step = 4;
+};
+
+template<typename K, typename V, typename H = hash<K>>
+using incremental_map = hashtable<K, V, H, counting_test_allocator, incremental_policy>;
+
+struct generational_policy : default_hashtable_policy {
+    static constexpr bool generational_clear = true;
+};
+
+template<typename K, typename V, typename H = hash<K>>
+using generational_map = hashtable<K, V, H, counting_test_allocator, generational_policy>;
+
+struct shrinking_policy : default_hashtable_policy {
+    static constexpr float shrink_load_factor = 0.125f;
+};
+
+template<typename K, typename V, typename H = hash<K>>
+using shrinking_map = hashtable<K, V, H, counting_test_allocator, shrinking_policy>;
+
+struct small_policy : default_hashtable_policy {
+    static constexpr count_t minimum_capacity = 64;
+    static constexpr count_t minimum_chunk_size = 32;
+    static constexpr float max_load_factor = 0.5f;
+    static constexpr count_t growth_factor = 4;
+};
+
+template<typename K, typename V, typename H = hash<K>>
+using small_map = hashtable<K, V, H, counting_test_allocator, small_policy>;
+
+struct small_incremental_policy : small_policy {
+    static constexpr bool incremental_rehash = true;
+};
+
+static int hash_call_count = 0;
+
+struct counting_hash {
+    hash_t operator()(const int x) const {
+        hash_call_count += 1;
+
+        return hash<int>{}(x);
+    }
+};
+
+static ansi_string<> int_key(const int i) {
+    const std::string digits = std::to_string(i);
+
+    return ansi_string<>{digits.data(), static_cast<ansi_string<>::size_type>(digits.size())};
+}
+
 int main(int argc, char **argv) {
     test_suite suite;
 
+    suite.add_test("ctor (empty)", []() {
+        counting_test_allocator allocator;
+        test_map<int, int> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+        equals(x.capacity(), 0);
+        check(!x.contains(1));
+        check(x.find(1) == x.end());
+        check(x.begin() == x.end());
+
+        x.erase(1);
+        x.clear();
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+
+        x.insert(1, 1);
+
+        equals(x.at(1), 1);
+        equals(x.capacity(), test_map<int, int>::minimum_capacity);
+        differs(allocator.get_bytes_allocated_count(), 0);
+    });
+
     suite.add_test("insert one", []() {
         using my_hashtable = test_map<int, float>;
 
@@ -171,6 +263,19 @@ int main(int argc, char **argv) {
         equals(capacity, x.capacity());
     });
 
+    suite.add_test("reserve (single block)", [] () {
+        counting_test_allocator allocator;
+        test_map<int, float> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+        stored_hash_map<int, float> y{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(i, 1);
+            y.insert(i, 1);
+        }
+
+        equals(allocator.get_bytes_allocated_count(), 2);
+    });
+
     suite.add_test("insert (same key twice)", [] () {
         using my_hashtable = test_map<int, float>;
 
@@ -195,14 +300,151 @@ int main(int argc, char **argv) {
         x.insert(x.get_chunk_size(), 1);
 
         const auto capacity = x.capacity();
+        const auto chunk_size = x.get_chunk_size();
+
+        // Items overflowing a chunk go to the stash, without
+        // growing the table.
+        for(size_t i = 0; i < chunk_size; ++i) {
+            x.insert(i, 1);
+        }
+
+        equals(x.capacity(), capacity);
+        equals(x.get_chunk_size(), chunk_size);
+        equals(x.size(), chunk_size + 1);
+
+        for(size_t i = 0; i <= chunk_size; ++i) {
+            check(x.contains(i));
+        }
+    });
+
+    suite.add_test("insert (full stash)", [] () {
+        struct same_hash {
+            constexpr hash_t operator()(const int&) const {
+                return 1;
+            }
+        };
+
+        using my_hashtable = hashtable<int, float, same_hash, ccl::counting_test_allocator>;
+
+        my_hashtable x;
+
+        const auto capacity = my_hashtable::minimum_capacity;
+        const auto chunk_size = x.get_chunk_size();
+        const int n = static_cast<int>(chunk_size + my_hashtable::stash_size + 1);
+
+        // Once the stash overflows as well, the chunks are lengthened.
+        for(int i = 0; i < n; ++i) {
+            x.insert(i, static_cast<float>(i));
+        }
+
+        equals(x.capacity(), capacity);
+        check(x.get_chunk_size() > chunk_size);
+        equals(x.size(), n);
+
+        for(int i = 0; i < n; ++i) {
+            equals(x.at(i), static_cast<float>(i));
+        }
+    });
+
+    suite.add_test("insert (load factor)", [] () {
+        using my_hashtable = test_map<int, int>;
+
+        my_hashtable x;
+
+        const auto capacity = x.capacity();
+        const int max_size = static_cast<int>(static_cast<float>(capacity) * my_hashtable::max_load_factor);
+
+        for(int i = 0; i < max_size; ++i) {
+            x.insert(i, i);
+        }
+
+        equals(x.capacity(), capacity);
+        equals(x.get_chunk_size(), my_hashtable::default_chunk_size);
+
+        x.insert(max_size, max_size);
+
+        check(x.capacity() > capacity);
+        equals(x.size(), max_size + 1);
+
+        for(int i = 0; i <= max_size; ++i) {
+            equals(x.at(i), i);
+        }
+    });
+
+    suite.add_test("insert (strided keys)", [] () {
+        using my_hashtable = test_map<int, int>;
+
+        my_hashtable x;
+
+        const auto capacity = my_hashtable::minimum_capacity;
+
+        // Identity hashes sharing their low bits must not collide.
+        for(int i = 0; i < 64; ++i) {
+            x.insert(i << 16, i);
+        }
 
-        // Adding too many items with the same key hash will trigger
-        // a resize.
-        for(size_t i = 0; i < x.get_chunk_size(); ++i) {
+        equals(x.capacity(), capacity);
+        equals(x.get_chunk_size(), my_hashtable::default_chunk_size);
+    });
+
+    suite.add_test("erase (stash)", [] () {
+        struct same_hash {
+            constexpr hash_t operator()(const int&) const {
+                return 1;
+            }
+        };
+
+        using my_hashtable = hashtable<int, float, same_hash, ccl::counting_test_allocator>;
+
+        my_hashtable x;
+        const int n = static_cast<int>(x.get_chunk_size() + 2);
+
+        for(int i = 0; i < n; ++i) {
             x.insert(i, 1);
         }
 
-        check(capacity < x.capacity());
+        x.erase(n - 1);
+        x.erase(0);
+
+        check(!x.contains(n - 1));
+        check(!x.contains(0));
+        equals(x.size(), n - 2);
+
+        x.insert(n - 1, 2);
+
+        equals(x.at(n - 1), 2);
+        equals(std::ranges::distance(x.begin(), x.end()), n - 1);
+    });
+
+    suite.add_test("erase (probe past erased slots)", [] () {
+        struct same_hash {
+            constexpr hash_t operator()(const int&) const {
+                return 1;
+            }
+        };
+
+        using my_hashtable = hashtable<int, float, same_hash, ccl::counting_test_allocator>;
+
+        my_hashtable x;
+
+        for(int i = 0; i < 4; ++i) {
+            x.insert(i, static_cast<float>(i));
+        }
+
+        // Keys following erased ones in the same chunk remain reachable.
+        x.erase(0);
+        x.erase(1);
+
+        check(!x.contains(0));
+        check(!x.contains(1));
+        equals(x.at(2), 2);
+        equals(x.at(3), 3);
+
+        // Erased slots are reused.
+        x.insert(4, 4);
+
+        equals(x.at(4), 4);
+        equals(x.size(), 3);
     });
 
     suite.add_test("erase iterator", [] () {
@@ -257,14 +499,21 @@ int main(int argc, char **argv) {
         x.emplace(x.get_chunk_size(), 1);
 
         const auto capacity = x.capacity();
+        const auto chunk_size = x.get_chunk_size();
 
-        // Adding too many items with the same key hash will trigger
-        // a resize.
-        for(size_t i = 0; i < x.get_chunk_size(); ++i) {
+        // Items overflowing a chunk go to the stash, without
+        // growing the table.
+        for(size_t i = 0; i < chunk_size; ++i) {
             x.emplace(i, 1);
         }
 
-        check(capacity < x.capacity());
+        equals(x.capacity(), capacity);
+        equals(x.get_chunk_size(), chunk_size);
+        equals(x.size(), chunk_size + 1);
+
+        for(size_t i = 0; i <= chunk_size; ++i) {
+            check(x.contains(i));
+        }
     });
 
     suite.add_test("ctor (range)", [] () {
@@ -347,6 +596,96 @@ int main(int argc, char **argv) {
         check(x.begin() == x.end());
     });
 
+    suite.add_test("clear (generational)", [] () {
+        counting_test_allocator allocator;
+        generational_map<int, int> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(i, i);
+        }
+
+        const auto capacity = x.capacity();
+        const auto allocation_count = allocator.get_bytes_allocated_count();
+
+        x.clear();
+
+        equals(x.size(), 0);
+        equals(x.capacity(), capacity);
+        check(x.begin() == x.end());
+        check(!x.contains(0));
+        check(!x.contains(999));
+
+        // Stale slots are reused
+        for(int i = 500; i < 1500; ++i) {
+            x.insert(i, -i);
+        }
+
+        equals(x.size(), 1000);
+        equals(x.capacity(), capacity);
+        equals(allocator.get_bytes_allocated_count(), allocation_count);
+        check(!x.contains(0));
+
+        for(int i = 500; i < 1500; ++i) {
+            equals(x.at(i), -i);
+        }
+
+        int sum = 0;
+
+        for(const auto item : x) {
+            sum += *item.second;
+        }
+
+        equals(sum, -999500);
+    });
+
+    suite.add_test("clear (generational, wrap around)", [] () {
+        generational_map<int, int> x;
+
+        // More clears than generations, with keys of each round probing
+        // the slots of the previous ones.
+        for(int round = 0; round < 600; ++round) {
+            for(int i = 0; i < 8; ++i) {
+                x.insert(round + i, round);
+            }
+
+            x.erase(round + 7);
+
+            equals(x.size(), 7);
+            equals(x.at(round), round);
+            check(!x.contains(round - 1));
+            check(!x.contains(round + 7));
+
+            x.clear();
+
+            check(!x.contains(round));
+        }
+    });
+
+    suite.add_test("copy (generational)", [] () {
+        generational_map<int, int> x;
+
+        for(int i = 0; i < 100; ++i) {
+            x.insert(i, i);
+        }
+
+        x.clear();
+        x.insert(1000, 1);
+
+        generational_map<int, int> y{x};
+
+        equals(y.size(), 1);
+        check(!y.contains(0));
+        equals(y.at(1000), 1);
+
+        y.insert(0, 2);
+        y.reserve(y.capacity() * 2);
+
+        equals(y.size(), 2);
+        equals(y.at(0), 2);
+        equals(y.at(1000), 1);
+        check(!y.contains(1));
+    });
+
     suite.add_test("find (not present)", []() {
         using my_hashtable = test_map<int, float>;
 
@@ -453,6 +792,906 @@ int main(int argc, char **argv) {
         equals(x.at(3), 4);
     });
 
+    suite.add_test("copy ctor", [] () {
+        using my_hashtable = test_map<int, float>;
+
+        my_hashtable y;
+
+        y.emplace(1, 1);
+        y.emplace(2, 3);
+
+        my_hashtable x{y};
+
+        y.emplace(3, 4);
+
+        equals(x.at(1), 1);
+        equals(x.at(2), 3);
+        check(!x.contains(3));
+        check(y.contains(3));
+    });
+
+    suite.add_test("insert many", [] () {
+        using my_hashtable = test_map<int, int>;
+
+        constexpr int item_count = 10000;
+        my_hashtable x;
+
+        for(int i = 0; i < item_count; ++i) {
+            x.insert(i * 7919, i);
+        }
+
+        for(int i = 0; i < item_count; ++i) {
+            equals(x.at(i * 7919), i);
+        }
+
+        for(int i = 0; i < item_count; i += 2) {
+            x.erase(i * 7919);
+        }
+
+        for(int i = 0; i < item_count; ++i) {
+            equals(x.contains(i * 7919), i % 2 == 1);
+        }
+    });
+
+    suite.add_test("reserve (non-trivial)", [] () {
+        int destruction_counter = 0;
+        const auto on_destroy = [&destruction_counter] () { destruction_counter += 1; };
+
+        {
+            test_map<int, spy> x;
+
+            for(int i = 0; i < 64; ++i) {
+                x.emplace(i, on_destroy);
+            }
+
+            x.reserve(x.capacity() << 2);
+
+            for(int i = 0; i < 64; ++i) {
+                equals(x.at(i).construction_magic, constructed_value);
+            }
+
+            equals(destruction_counter, 0);
+        }
+
+        equals(destruction_counter, 64);
+    });
+
+    suite.add_test("find (transparent)", [] () {
+        test_map<ansi_string<>, int, string_hash<>> x;
+        const char * const raw = "key 1 and more";
+
+        x.insert("key 0", 0);
+        x.insert("key 1", 1);
+
+        const auto it = x.find(std::string_view{raw, 5});
+
+        check(it != x.end());
+        equals(*it->second, 1);
+        check(x.find(std::string_view{"key 2"}) == x.end());
+        check(std::as_const(x).find("key 0") != std::as_const(x).end());
+    });
+
+    suite.add_test("contains/at (transparent)", [] () {
+        test_map<ansi_string<>, int, string_hash<>> x;
+        const nul_terminated_string<char, ansi_string<>::char_traits> key{ansi_string<>{"key 1"}, CCL_ALLOCATOR_DEFAULT_FLAGS};
+
+        x.insert("key 0", 0);
+        x.insert("key 1", 1);
+
+        check(x.contains(key));
+        check(x.contains("key 0"));
+        check(!x.contains(std::string_view{"key"}));
+        equals(x.at(key), 1);
+        equals(x.at(std::string_view{"key 0"}), 0);
+        throws<std::out_of_range>([&x] () { (void)x.at(std::string_view{"key 2"}); });
+    });
+
+    suite.add_test("insert many (stored hashes)", [] () {
+        using my_hashtable = stored_hash_map<int, int>;
+
+        constexpr int item_count = 10000;
+        my_hashtable x;
+
+        for(int i = 0; i < item_count; ++i) {
+            x.insert(i * 7919, i);
+        }
+
+        for(int i = 0; i < item_count; i += 2) {
+            x.erase(i * 7919);
+        }
+
+        const my_hashtable y{std::as_const(x)};
+
+        for(int i = 0; i < item_count; ++i) {
+            equals(x.contains(i * 7919), i % 2 == 1);
+            equals(y.contains(i * 7919), i % 2 == 1);
+        }
+
+        equals(y.at(7919), 1);
+    });
+
+    suite.add_test("reserve (stored hashes)", [] () {
+        stored_hash_map<int, int, counting_hash> x;
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(i, i);
+        }
+
+        hash_call_count = 0;
+        x.reserve(x.capacity() << 2);
+
+        equals(hash_call_count, 0);
+
+        for(int i = 0; i < 1000; ++i) {
+            equals(x.at(i), i);
+        }
+    });
+
+    suite.add_test("move (stored hashes)", [] () {
+        stored_hash_map<ansi_string<>, int, string_hash<>> x;
+
+        x.insert("key 0", 0);
+        x.insert("key 1", 1);
+
+        stored_hash_map<ansi_string<>, int, string_hash<>> y{std::move(x)};
+
+        equals(x.capacity(), 0U);
+        equals(y.at("key 1"), 1);
+
+        x = std::move(y);
+
+        equals(x.at("key 0"), 0);
+        check(!x.contains(std::string_view{"key 2"}));
+    });
+
+    suite.add_test("insert many (interleaved)", [] () {
+        using my_hashtable = interleaved_map<int, int>;
+
+        constexpr int item_count = 10000;
+        my_hashtable x;
+        int sum = 0;
+
+        for(int i = 0; i < item_count; ++i) {
+            x.insert(i * 7919, i);
+        }
+
+        for(int i = 0; i < item_count; i += 2) {
+            x.erase(i * 7919);
+        }
+
+        const my_hashtable y{std::as_const(x)};
+
+        for(int i = 0; i < item_count; ++i) {
+            equals(x.contains(i * 7919), i % 2 == 1);
+            equals(y.contains(i * 7919), i % 2 == 1);
+        }
+
+        for(const auto item : y) {
+            equals(*item.first, *item.second * 7919);
+            sum++;
+        }
+
+        equals(sum, item_count / 2);
+    });
+
+    suite.add_test("copy and move (interleaved)", [] () {
+        using my_hashtable = interleaved_map<ansi_string<>, ansi_string<>, string_hash<>>;
+
+        my_hashtable x;
+
+        for(int i = 0; i < 100; ++i) {
+            x.insert(int_key(i), int_key(i * 2));
+        }
+
+        my_hashtable y{std::as_const(x)};
+        const my_hashtable z{std::move(x)};
+
+        y.erase(int_key(0));
+
+        for(int i = 1; i < 100; ++i) {
+            check(y.at(int_key(i)) == int_key(i * 2));
+            check(z.at(int_key(i)) == int_key(i * 2));
+        }
+
+        check(!y.contains(int_key(0)));
+        check(z.contains(int_key(0)));
+    });
+
+    suite.add_test("insert many (incremental)", [] () {
+        using my_hashtable = incremental_map<int, int>;
+
+        constexpr int item_count = 10000;
+        my_hashtable x;
+        bool rehashed = false;
+
+        for(int i = 0; i < item_count; ++i) {
+            x.insert(i * 7919, i);
+            rehashed |= x.is_rehashing();
+
+            if(x.is_rehashing()) {
+                equals(x.at(0), 0);
+                equals(x.at(i * 7919), i);
+            }
+        }
+
+        check(rehashed);
+
+        for(int i = 0; i < item_count; ++i) {
+            equals(x.at(i * 7919), i);
+        }
+
+        for(int i = 0; i < item_count; i += 2) {
+            x.erase(i * 7919);
+        }
+
+        for(int i = 0; i < item_count; ++i) {
+            equals(x.contains(i * 7919), i % 2 == 1);
+        }
+    });
+
+    suite.add_test("rehashing (incremental)", [] () {
+        using my_hashtable = incremental_map<int, spy>;
+
+        int destruction_counter = 0;
+        const auto on_destroy = [&destruction_counter] () { destruction_counter += 1; };
+        int item_count = 0;
+
+        {
+            my_hashtable x;
+
+            while(!x.is_rehashing()) {
+                x.emplace(item_count++, on_destroy);
+            }
+
+            const my_hashtable copy{std::as_const(x)};
+            int visited = 0;
+
+            check(copy.is_rehashing());
+
+            for(auto it = x.begin(); it != x.end(); ++it) {
+                check(*it->first < item_count);
+                equals(it->second->construction_magic, constructed_value);
+                visited += 1;
+            }
+
+            equals(visited, item_count);
+
+            for(int i = 0; i < item_count; ++i) {
+                check(x.contains(i));
+                check(copy.contains(i));
+            }
+
+            x.erase(x.find(0));
+            x.erase(1);
+
+            check(!x.contains(0));
+            check(!x.contains(1));
+            check(copy.contains(0));
+
+            const auto old_capacity = x.capacity();
+            x.reserve(old_capacity);
+
+            check(!x.is_rehashing());
+            equals(x.capacity(), old_capacity);
+
+            for(int i = 2; i < item_count; ++i) {
+                equals(x.at(i).construction_magic, constructed_value);
+            }
+
+            equals(destruction_counter, 2);
+        }
+
+        equals(destruction_counter, item_count * 2);
+    });
+
+    suite.add_test("clear/move (incremental)", [] () {
+        using my_hashtable = incremental_map<int, int>;
+
+        my_hashtable x;
+        int item_count = 0;
+
+        while(!x.is_rehashing()) {
+            x.insert(item_count, item_count);
+            item_count += 1;
+        }
+
+        my_hashtable y{std::move(x)};
+
+        check(!x.is_rehashing());
+        check(y.is_rehashing());
+        equals(y.at(0), 0);
+
+        x = std::move(y);
+        x.clear();
+
+        check(!x.is_rehashing());
+        check(x.begin() == x.end());
+
+        for(int i = 0; i < item_count; ++i) {
+            check(!x.contains(i));
+        }
+    });
+
+    suite.add_test("insert_batch", [] () {
+        test_map<int, int> x;
+        int keys[100];
+        int values[100];
+
+        for(int i = 0; i < 100; ++i) {
+            keys[i] = i * 7919;
+            values[i] = i;
+        }
+
+        x.insert(0, -1);
+        x.insert_batch(keys, values);
+
+        equals(x.at(0), -1);
+
+        for(int i = 1; i < 100; ++i) {
+            equals(x.at(i * 7919), i);
+        }
+
+        throws<std::invalid_argument>([&x, &keys, &values] () {
+            x.insert_batch(keys, std::span<const int>{values, 99});
+        });
+    });
+
+    suite.add_test("find_batch/contains_batch", [] () {
+        using my_hashtable = test_map<int, int>;
+
+        my_hashtable x;
+        int keys[100];
+        my_hashtable::iterator found[100];
+        my_hashtable::const_iterator const_found[100];
+        bool present[100];
+
+        for(int i = 0; i < 100; ++i) {
+            keys[i] = i;
+
+            if(i % 3 == 0) {
+                x.insert(i, i * 2);
+            }
+        }
+
+        x.find_batch(keys, found);
+        std::as_const(x).find_batch(keys, const_found);
+        x.contains_batch(keys, present);
+
+        for(int i = 0; i < 100; ++i) {
+            equals(present[i], i % 3 == 0);
+
+            if(i % 3 == 0) {
+                equals(*found[i]->second, i * 2);
+                equals(*const_found[i]->second, i * 2);
+            } else {
+                check(found[i] == x.end());
+                check(const_found[i] == std::as_const(x).end());
+            }
+        }
+    });
+
+    suite.add_test("find_hashed/emplace_hashed/erase_hashed", [] () {
+        using my_hashtable = test_map<int, int>;
+
+        my_hashtable x;
+
+        for(int i = 0; i < 100; ++i) {
+            equals(x.emplace_hashed(i, hash<int>{}(i), i * 2), i * 2);
+        }
+
+        // Already present: the value is kept
+        equals(x.emplace_hashed(10, hash<int>{}(10), 0), 20);
+        equals(x.size(), 100);
+
+        for(int i = 0; i < 100; i += 2) {
+            x.erase_hashed(i, hash<int>{}(i));
+        }
+
+        for(int i = 0; i < 100; ++i) {
+            equals(x.contains_hashed(i, hash<int>{}(i)), i % 2 == 1);
+            equals(std::as_const(x).find_hashed(i, hash<int>{}(i)) != std::as_const(x).end(), i % 2 == 1);
+
+            if(i % 2) {
+                equals(*x.find_hashed(i, hash<int>{}(i))->second, i * 2);
+            }
+        }
+    });
+
+    suite.add_test("extract", [] () {
+        using my_hashtable = test_map<int, int>;
+
+        my_hashtable x;
+
+        for(int i = 0; i < 100; ++i) {
+            x.insert(i, i * 2);
+        }
+
+        my_hashtable::node_type node = x.extract(5);
+
+        check(!node.empty());
+        equals(node.key(), 5);
+        equals(node.value(), 10);
+        equals(x.size(), 99);
+        check(!x.contains(5));
+        check(x.extract(5).empty());
+
+        node = x.extract(x.find(6));
+
+        equals(node.key(), 6);
+        equals(node.value(), 12);
+        check(!x.contains(6));
+    });
+
+    suite.add_test("insert (node)", [] () {
+        using my_hashtable = test_map<ansi_string<>, int, string_hash<>>;
+
+        my_hashtable x;
+        my_hashtable y;
+
+        x.insert("key 1", 1);
+        x.insert("key 2", 2);
+        y.insert("key 2", 20);
+
+        my_hashtable::node_type node = x.extract("key 1");
+
+        check(y.insert(std::move(node)));
+        check(node.empty());
+        equals(y.at("key 1"), 1);
+
+        node = x.extract("key 2");
+
+        // Already present: the node keeps its item
+        check(!y.insert(std::move(node)));
+        check(!node.empty());
+        check(node.key() == "key 2");
+        equals(y.at("key 2"), 20);
+        equals(x.size(), 0);
+
+        check(!y.insert(my_hashtable::node_type{}));
+    });
+
+    suite.add_test("merge", [] () {
+        using my_hashtable = test_map<ansi_string<>, int, string_hash<>>;
+
+        my_hashtable x;
+        my_hashtable y;
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(int_key(i), i);
+            y.insert(int_key(i + 500), -i);
+        }
+
+        x.merge(y);
+
+        equals(x.size(), 1500);
+        equals(y.size(), 500);
+
+        for(int i = 0; i < 1000; ++i) {
+            equals(x.at(int_key(i)), i);
+        }
+
+        for(int i = 1000; i < 1500; ++i) {
+            equals(x.at(int_key(i)), 500 - i);
+        }
+
+        // Keys already present stay behind
+        for(int i = 500; i < 1000; ++i) {
+            equals(y.at(int_key(i)), 500 - i);
+        }
+
+        x.merge(x);
+        equals(x.size(), 1500);
+    });
+
+    suite.add_test("merge (stored hashes)", [] () {
+        using my_hashtable = stored_hash_map<int, int, counting_hash>;
+
+        my_hashtable x;
+        my_hashtable y;
+
+        for(int i = 0; i < 100; ++i) {
+            y.insert(i, i);
+        }
+
+        hash_call_count = 0;
+        x.merge(y);
+
+        equals(hash_call_count, 0);
+        equals(x.size(), 100);
+        equals(y.size(), 0);
+    });
+
+    suite.add_test("merge (incremental)", [] () {
+        using my_hashtable = incremental_map<int, int>;
+
+        my_hashtable x;
+        my_hashtable y;
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(i, i);
+            y.insert(i + 1000, i);
+        }
+
+        x.merge(std::move(y));
+
+        equals(x.size(), 2000);
+
+        for(int i = 0; i < 2000; ++i) {
+            equals(x.at(i), i % 1000);
+        }
+    });
+
+    suite.add_test("insert (move)", [] () {
+        using string_type = ansi_string<counting_test_allocator>;
+
+        counting_test_allocator string_allocator;
+        test_map<string_type, string_type, string_hash<>> x;
+
+        x.insert(
+            string_type{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator},
+            string_type{"value 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator}
+        );
+
+        // Moved: no string copied
+        equals(string_allocator.get_bytes_allocated_count(), 2);
+
+        const string_type key{"key 1", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+        string_type value{"value 1", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        x.insert(key, std::move(value));
+
+        // Only the key copied
+        equals(string_allocator.get_bytes_allocated_count(), 5);
+        check(value.is_empty());
+        check(x.at("key 1") == "value 1");
+
+        string_type other_value{"value 2", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        // Already present: nothing replaced
+        x.insert(key, std::move(other_value));
+
+        equals(string_allocator.get_bytes_allocated_count(), 6);
+        check(x.at("key 1") == "value 1");
+
+        x.emplace(string_type{"key 3", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator}, "value 3", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator);
+
+        equals(string_allocator.get_bytes_allocated_count(), 8);
+        check(x.at("key 3") == "value 3");
+    });
+
+    suite.add_test("try_emplace", [] () {
+        using string_type = ansi_string<counting_test_allocator>;
+
+        counting_test_allocator string_allocator;
+        test_map<string_type, string_type, string_hash<>> x;
+        string_type key{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        const auto [it, inserted] = x.try_emplace(std::move(key), "value 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator);
+
+        check(inserted);
+        check(key.is_empty());
+        check(*it->first == "key 0");
+        check(*it->second == "value 0");
+        equals(string_allocator.get_bytes_allocated_count(), 2);
+
+        string_type same_key{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+        string_type value{"value 1", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        // Already present: neither the key nor the value are consumed
+        const auto [it2, inserted2] = x.try_emplace(std::move(same_key), std::move(value));
+
+        check(!inserted2);
+        check(it2 == it);
+        check(same_key == "key 0");
+        check(value == "value 1");
+        check(x.at("key 0") == "value 0");
+        equals(x.size(), 1);
+        equals(string_allocator.get_bytes_allocated_count(), 4);
+    });
+
+    suite.add_test("try_emplace (incremental)", [] () {
+        incremental_map<int, int> x;
+
+        for(int i = 0; i < 1000; ++i) {
+            check(x.try_emplace(i, i).second);
+        }
+
+        for(int i = 0; i < 1000; ++i) {
+            const auto result = x.try_emplace(i, -1);
+
+            check(!result.second);
+            equals(*result.first->first, i);
+            equals(*result.first->second, i);
+        }
+
+        equals(x.size(), 1000);
+    });
+
+    suite.add_test("insert_or_assign", [] () {
+        using string_type = ansi_string<counting_test_allocator>;
+
+        counting_test_allocator string_allocator;
+        test_map<string_type, string_type, string_hash<>> x;
+
+        const auto [it, inserted] = x.insert_or_assign(
+            string_type{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator},
+            string_type{"value 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator}
+        );
+
+        check(inserted);
+        check(*it->second == "value 0");
+        equals(string_allocator.get_bytes_allocated_count(), 2);
+
+        const string_type key{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+        string_type value{"value 1", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        const auto [it2, inserted2] = x.insert_or_assign(key, std::move(value));
+
+        // Assigned by move, the key is not copied
+        check(!inserted2);
+        check(it2 == it);
+        check(x.at("key 0") == "value 1");
+        equals(x.size(), 1);
+        equals(string_allocator.get_bytes_allocated_count(), 4);
+    });
+
+    suite.add_test("shrink_to_fit", [] () {
+        counting_test_allocator allocator;
+        test_map<int, float> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        for(int i = 0; i < 10000; ++i) {
+            x.insert(i, static_cast<float>(i));
+        }
+
+        const auto capacity = x.capacity();
+
+        for(int i = 10; i < 10000; ++i) {
+            x.erase(i);
+        }
+
+        // Erasing never shrinks by default
+        equals(x.capacity(), capacity);
+
+        x.shrink_to_fit();
+
+        equals(x.capacity(), test_map<int, float>::minimum_capacity);
+        equals(x.size(), 10);
+        equals(allocator.get_bytes_allocated_count(), 1);
+
+        for(int i = 0; i < 10; ++i) {
+            equals(x.at(i), static_cast<float>(i));
+        }
+
+        x.shrink_to_fit();
+
+        equals(x.capacity(), test_map<int, float>::minimum_capacity);
+    });
+
+    suite.add_test("shrink_to_fit (load factor)", [] () {
+        using my_hashtable = test_map<int, float>;
+
+        my_hashtable x;
+
+        x.reserve(my_hashtable::minimum_capacity * 16);
+
+        for(my_hashtable::size_type i = 0; i < my_hashtable::minimum_capacity; ++i) {
+            x.insert(static_cast<int>(i), 1);
+        }
+
+        x.shrink_to_fit();
+
+        // The smallest capacity within the maximum load factor
+        equals(x.capacity(), my_hashtable::minimum_capacity * 2);
+        equals(x.size(), my_hashtable::minimum_capacity);
+
+        for(my_hashtable::size_type i = 0; i < my_hashtable::minimum_capacity; ++i) {
+            check(x.contains(static_cast<int>(i)));
+        }
+    });
+
+    suite.add_test("shrink_to_fit (empty)", [] () {
+        counting_test_allocator allocator;
+        test_map<int, float> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        x.shrink_to_fit();
+
+        equals(x.capacity(), 0);
+
+        x.insert(1, 1);
+        x.erase(1);
+        x.shrink_to_fit();
+
+        equals(x.capacity(), 0);
+        equals(allocator.get_bytes_allocated_count(), 0);
+        check(x.begin() == x.end());
+
+        x.insert(2, 2);
+
+        equals(x.at(2), 2);
+    });
+
+    suite.add_test("shrink_to_fit (chunk size)", [] () {
+        struct same_hash {
+            constexpr hash_t operator()(const int&) const {
+                return 1;
+            }
+        };
+
+        hashtable<int, float, same_hash, counting_test_allocator> x;
+        const auto chunk_size = x.get_chunk_size();
+
+        // Colliding keys overflow the chunk and the stash
+        for(int i = 0; i < 256; ++i) {
+            x.insert(i, 1);
+        }
+
+        check(x.get_chunk_size() > chunk_size);
+
+        for(int i = 1; i < 256; ++i) {
+            x.erase(i);
+        }
+
+        x.shrink_to_fit();
+
+        equals(x.get_chunk_size(), chunk_size);
+        check(x.contains(0));
+    });
+
+    suite.add_test("shrink_to_fit (incremental)", [] () {
+        incremental_map<int, float> x;
+        int item_count = 0;
+
+        while(!x.is_rehashing()) {
+            x.insert(item_count, static_cast<float>(item_count));
+            item_count++;
+        }
+
+        x.shrink_to_fit();
+
+        check(!x.is_rehashing());
+        equals(x.capacity(), incremental_map<int, float>::minimum_capacity * 2);
+
+        for(int i = 0; i < item_count; ++i) {
+            equals(x.at(i), static_cast<float>(i));
+        }
+    });
+
+    suite.add_test("erase (shrink policy)", [] () {
+        using my_hashtable = shrinking_map<int, spy>;
+
+        int destruction_counter = 0;
+        const auto on_destroy = [&destruction_counter] () { destruction_counter += 1; };
+
+        {
+            my_hashtable x;
+
+            for(int i = 0; i < 10000; ++i) {
+                x.emplace(i, on_destroy);
+            }
+
+            const auto capacity = x.capacity();
+
+            // Erasing by iterator never shrinks, keeping iterators valid
+            for(auto it = x.begin(); it != x.end(); ++it) {
+                if(*it->first >= 5000) {
+                    x.erase(it);
+                }
+            }
+
+            equals(x.capacity(), capacity);
+
+            for(int i = 10; i < 5000; ++i) {
+                x.erase(i);
+            }
+
+            check(x.capacity() < capacity);
+            equals(x.size(), 10);
+            equals(destruction_counter, 9990);
+
+            for(int i = 0; i < 10; ++i) {
+                equals(x.at(i).construction_magic, constructed_value);
+            }
+
+            // Never below the minimum capacity
+            for(int i = 0; i < 10; ++i) {
+                CCLUNUSED auto node = x.extract(i);
+            }
+
+            equals(x.capacity(), my_hashtable::minimum_capacity);
+        }
+
+        equals(destruction_counter, 10000);
+    });
+
+    suite.add_test("policy (capacity and growth)", [] () {
+        small_map<int, float> x;
+
+        x.insert(0, 0);
+
+        equals(x.capacity(), 64);
+        equals(x.get_chunk_size(), 32);
+
+        for(int i = 1; i < 32; ++i) {
+            x.insert(i, static_cast<float>(i));
+        }
+
+        // Growing by the growth factor past the maximum load factor
+        equals(x.capacity(), 64);
+
+        x.insert(32, 32);
+
+        equals(x.capacity(), 256);
+
+        for(int i = 0; i <= 32; ++i) {
+            equals(x.at(i), static_cast<float>(i));
+        }
+
+        for(int i = 2; i <= 32; ++i) {
+            x.erase(i);
+        }
+
+        x.shrink_to_fit();
+
+        equals(x.capacity(), 64);
+        equals(x.size(), 2);
+    });
+
+    suite.add_test("policy (incremental growth)", [] () {
+        hashtable<int, float, hash<int>, counting_test_allocator, small_incremental_policy> x;
+        int item_count = 0;
+
+        while(!x.is_rehashing()) {
+            x.insert(item_count, static_cast<float>(item_count));
+            item_count++;
+        }
+
+        equals(x.capacity(), 256);
+
+        for(int i = 0; i < item_count; ++i) {
+            equals(x.at(i), static_cast<float>(i));
+        }
+    });
+
+    suite.add_test("ctor (sized range)", [] () {
+        std::vector<pair<int, float>> input;
+
+        for(int i = 0; i < 10000; ++i) {
+            input.emplace_back(i, static_cast<float>(i));
+        }
+
+        // Duplicate keys keep the first value
+        input.emplace_back(0, 1.0f);
+
+        const test_map<int, float> x{input};
+
+        equals(x.size(), 10000);
+        equals(x.capacity(), 16384);
+        equals(x.at(0), 0.0f);
+
+        for(int i = 0; i < 10000; ++i) {
+            equals(x.at(i), static_cast<float>(i));
+        }
+    });
+
+    suite.add_test("reserve_items", [] () {
+        counting_test_allocator allocator;
+        incremental_map<int, float> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        x.reserve_items(10000);
+
+        const auto capacity = x.capacity();
+
+        check(capacity * incremental_map<int, float>::max_load_factor >= 10000);
+
+        for(int i = 0; i < 10000; ++i) {
+            x.insert(i, static_cast<float>(i));
+        }
+
+        check(!x.is_rehashing());
+        equals(x.capacity(), capacity);
+        equals(allocator.get_bytes_allocated_count(), 1);
+    });
+
     static_assert(std::ranges::range<test_map<int, float>>);
 
     return suite.main(argc, argv);
@@ -15,5 +15,20 @@ int main(int argc, char **argv) {
         equals(::strcmp(i18n::iso639_1_language_codes[i18n::LANGUAGE_ZULU], "zu"), 0);
     });
 
+    suite.add_test("language_from_iso639_1", [] () {
+        static_assert(i18n::language_from_iso639_1("en") == i18n::LANGUAGE_ENGLISH);
+
+        equals(i18n::language_from_iso639_1("uk"), i18n::LANGUAGE_UKRAINIAN);
+        equals(i18n::language_from_iso639_1("it"), i18n::LANGUAGE_ITALIAN);
+        equals(i18n::language_from_iso639_1("zu"), i18n::LANGUAGE_ZULU);
+        equals(i18n::language_from_iso639_1("<none>"), i18n::LANGUAGE_NONE);
+        equals(i18n::language_from_iso639_1("xx"), i18n::LANGUAGE_NONE);
+        equals(i18n::language_from_iso639_1(""), i18n::LANGUAGE_NONE);
+
+        for(std::size_t i = 1; i <= i18n::language_count; ++i) {
+            equals(i18n::language_from_iso639_1(i18n::iso639_1_language_codes[i]), static_cast<i18n::language>(i));
+        }
+    });
+
     return suite.main(argc, argv);
 }
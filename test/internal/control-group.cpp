@@ -0,0 +1,123 @@
+#include <ccl/test/test.hpp>
+#include <ccl/internal/control-group.hpp>
+
+using namespace ccl;
+using namespace ccl::internal;
+
+static constexpr std::size_t width = control_group::width;
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("make_control_byte", [] () {
+        for(hash_t h = 0; h < 1024; ++h) {
+            check(is_control_full(make_control_byte(h)));
+        }
+
+        check(!is_control_full(control_empty));
+    });
+
+    suite.add_test("match", [] () {
+        control_byte bytes[width] {};
+        const control_byte tag = make_control_byte(1234);
+
+        bytes[1] = tag;
+        bytes[width - 1] = tag;
+
+        auto matches = control_group{bytes}.match(tag);
+
+        check(static_cast<bool>(matches));
+        equals(matches.lowest(), 1);
+
+        matches.clear_lowest();
+
+        check(static_cast<bool>(matches));
+        equals(matches.lowest(), width - 1);
+
+        matches.clear_lowest();
+
+        check(!matches);
+    });
+
+    suite.add_test("match (none)", [] () {
+        control_byte bytes[width] {};
+
+        check(!control_group{bytes}.match(make_control_byte(1)));
+    });
+
+    suite.add_test("match_empty", [] () {
+        control_byte bytes[width];
+
+        for(auto &b : bytes) {
+            b = make_control_byte(7);
+        }
+
+        check(!control_group{bytes}.match_empty());
+
+        bytes[3] = control_empty;
+
+        const auto empties = control_group{bytes}.match_empty();
+
+        check(static_cast<bool>(empties));
+        equals(empties.lowest(), 3);
+    });
+
+    suite.add_test("match_empty (deleted)", [] () {
+        control_byte bytes[width];
+
+        for(auto &b : bytes) {
+            b = control_deleted;
+        }
+
+        check(!control_group{bytes}.match_empty());
+        check(!is_control_full(control_deleted));
+    });
+
+    suite.add_test("match_vacant", [] () {
+        control_byte bytes[width];
+
+        for(auto &b : bytes) {
+            b = make_control_byte(7);
+        }
+
+        check(!control_group{bytes}.match_vacant());
+
+        bytes[2] = control_deleted;
+        bytes[5] = control_empty;
+
+        auto vacancies = control_group{bytes}.match_vacant();
+
+        equals(vacancies.lowest(), 2);
+        vacancies.clear_lowest();
+        equals(vacancies.lowest(), 5);
+        vacancies.clear_lowest();
+        check(!vacancies);
+    });
+
+    suite.add_test("match_full", [] () {
+        control_byte bytes[width] {};
+
+        check(!control_group{bytes}.match_full());
+
+        bytes[width - 2] = make_control_byte(42);
+
+        const auto full = control_group{bytes}.match_full();
+
+        check(static_cast<bool>(full));
+        equals(full.lowest(), width - 2);
+    });
+
+    suite.add_test("limit", [] () {
+        control_byte bytes[width] {};
+
+        check(static_cast<bool>(control_group{bytes}.match_empty().limit(1)));
+        equals(control_group{bytes}.match_empty().limit(width).lowest(), 0);
+
+        bytes[0] = make_control_byte(0);
+
+        check(!control_group{bytes}.match_empty().limit(1));
+        check(static_cast<bool>(control_group{bytes}.match_empty().limit(2)));
+    });
+
+    return suite.main(argc, argv);
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <ccl/test/test.hpp>
+#include <ccl/internal/sorted-merge.hpp>
+
+using namespace ccl;
+using namespace ccl::internal;
+
+/**
+ * Distinct random items, sorted.
+ */
+template<typename T>
+static std::vector<T> make_items(std::mt19937 &rng, const std::size_t n, const T max_item) {
+    std::uniform_int_distribution<T> distribution{0, max_item};
+    std::vector<T> items;
+
+    for(std::size_t i = 0; i < n; ++i) {
+        items.push_back(distribution(rng));
+    }
+
+    std::sort(items.begin(), items.end());
+    items.erase(std::unique(items.begin(), items.end()), items.end());
+
+    return items;
+}
+
+/**
+ * Check the membership reported for random sequences against binary search.
+ */
+template<typename T>
+static void check_random_sequences() {
+    std::mt19937 rng{1};
+
+    for(std::size_t n = 0; n < 64; ++n) {
+        for(std::size_t m = 0; m < 64; m += 3) {
+            const auto items = make_items<T>(rng, n, 100);
+            const auto other = make_items<T>(rng, m, 100);
+            std::size_t visit_count = 0;
+
+            for_each_sorted_membership<T>(items, other, [&] (const T &item, const bool is_in_other) {
+                equals(item, items[visit_count++]);
+                equals(is_in_other, std::binary_search(other.begin(), other.end(), item));
+            });
+
+            equals(visit_count, items.size());
+        }
+    }
+}
+
+static constexpr std::size_t count_common(const int (&a)[5], const int (&b)[3]) {
+    std::size_t count = 0;
+
+    for_each_sorted_membership<int>(a, b, [&count] (const int, const bool is_in_other) {
+        count += is_in_other;
+    });
+
+    return count;
+}
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("for_each_sorted_membership (32 bits)", [] () {
+        check_random_sequences<uint32_t>();
+        check_random_sequences<int32_t>();
+    });
+
+    suite.add_test("for_each_sorted_membership (64 bits)", [] () {
+        check_random_sequences<uint64_t>();
+    });
+
+    suite.add_test("for_each_sorted_membership (blocks)", [] () {
+        std::vector<uint32_t> items;
+        std::vector<uint32_t> other;
+        std::size_t match_count = 0;
+
+        // Matches straddling block boundaries on both sides
+        for(uint32_t i = 0; i < 1000; ++i) {
+            items.push_back(i * 2);
+            other.push_back(i * 5);
+        }
+
+        for_each_sorted_membership<uint32_t>(items, other, [&match_count] (const uint32_t item, const bool is_in_other) {
+            equals(is_in_other, item % 10 == 0);
+            match_count += is_in_other;
+        });
+
+        equals(match_count, 200);
+    });
+
+    suite.add_test("for_each_sorted_membership (stop)", [] () {
+        std::vector<uint32_t> items;
+        std::vector<uint32_t> other;
+
+        for(uint32_t i = 0; i < 100; ++i) {
+            items.push_back(i);
+
+            if(i != 42) {
+                other.push_back(i);
+            }
+        }
+
+        // Within the blocks, then in the scalar tail
+        for(const uint32_t missing_count : { 1u, 90u }) {
+            std::vector<uint32_t> partial{other.begin(), other.end() - missing_count};
+            std::size_t visit_count = 0;
+
+            const bool is_complete = for_each_sorted_membership<uint32_t>(items, partial, [&visit_count] (const uint32_t, const bool is_in_other) {
+                visit_count++;
+
+                return is_in_other;
+            });
+
+            check(!is_complete);
+            equals(visit_count, missing_count == 1 ? 43 : 10);
+        }
+    });
+
+    suite.add_test("for_each_sorted_membership (constexpr)", [] () {
+        constexpr int a[5] { 1, 2, 3, 5, 8 };
+        constexpr int b[3] { 2, 5, 7 };
+
+        static_assert(count_common(a, b) == 2);
+    });
+
+    return suite.main(argc, argv);
+}
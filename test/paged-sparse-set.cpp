@@ -0,0 +1,256 @@
+#include <vector>
+#include <ccl/test/test.hpp>
+#include <ccl/paged-sparse-set.hpp>
+#include <ccl/test/counting-test-allocator.hpp>
+
+using namespace ccl;
+
+template<typename T>
+using test_set = paged_sparse_set<T, counting_test_allocator>;
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("ctor (empty)", [] () {
+        counting_test_allocator allocator;
+        test_set<uint32_t> set{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+        equals(set.size(), 0);
+        check(set.is_empty());
+        check(!set.contains(1));
+        check(!set.remove(1));
+        check(set.begin() == set.end());
+    });
+
+    suite.add_test("insert", [] () {
+        test_set<uint32_t> set;
+
+        check(set.insert(3));
+        check(set.insert(1));
+        check(!set.insert(3));
+
+        equals(set.size(), 2);
+        check(set.contains(1));
+        check(set.contains(3));
+        check(!set.contains(2));
+        equals(set.index_of(3), 0);
+        equals(set.index_of(1), 1);
+        equals(set.index_of(2), test_set<uint32_t>::invalid_index);
+    });
+
+    suite.add_test("insert (pages)", [] () {
+        constexpr uint32_t page_size = test_set<uint32_t>::page_size;
+
+        counting_test_allocator allocator;
+        test_set<uint32_t> set{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        set.insert(page_size * 10 + 1);
+
+        equals(set.page_count(), 11);
+
+        // Only the page of the ID is allocated, besides the page table and the dense array
+        equals(allocator.get_bytes_allocated_count(), 3);
+
+        check(!set.contains(1));
+        check(!set.contains(page_size * 10));
+        check(!set.contains(page_size * 100));
+        check(set.contains(page_size * 10 + 1));
+
+        set.insert(page_size * 10 + 2);
+
+        equals(allocator.get_bytes_allocated_count(), 3);
+    });
+
+    suite.add_test("insert (wide IDs)", [] () {
+        test_set<uint64_t> set;
+
+        check(!set.contains(uint64_t{1} << 62));
+
+        throws<std::out_of_range>([&set] () {
+            set.insert(uint64_t{1} << 62);
+        });
+
+        throws<std::out_of_range>([&set] () {
+            set.insert(test_set<uint64_t>::max_id + 1);
+        });
+
+        set.insert(1000000);
+        set.insert(test_set<uint64_t>::max_id);
+
+        check(set.contains(1000000));
+        check(set.contains(test_set<uint64_t>::max_id));
+        check(!set.contains(test_set<uint64_t>::max_id + 1));
+        equals(set.size(), 2);
+    });
+
+    suite.add_test("remove", [] () {
+        test_set<uint32_t> set;
+
+        for(uint32_t i = 0; i < 100; ++i) {
+            set.insert(i * 7);
+        }
+
+        // The last ID takes the place of the removed one
+        check(set.remove(70));
+        check(!set.remove(70));
+
+        equals(set.size(), 99);
+        equals(set.data()[10], 99 * 7);
+        equals(set.index_of(99 * 7), 10);
+
+        for(uint32_t i = 0; i < 100; i += 2) {
+            set.remove(i * 7);
+        }
+
+        for(uint32_t i = 0; i < 100; ++i) {
+            equals(set.contains(i * 7), i % 2 == 1 && i != 10);
+        }
+
+        for(uint32_t i = 0; i < set.size(); ++i) {
+            equals(set.index_of(set.data()[i]), i);
+        }
+    });
+
+    suite.add_test("remove_all", [] () {
+        test_set<uint16_t> set;
+        std::vector<uint16_t> removed;
+
+        for(uint16_t i = 0; i < 1000; ++i) {
+            set.insert(i);
+        }
+
+        for(uint16_t i = 0; i < 2000; i += 3) {
+            removed.push_back(i);
+        }
+
+        equals(set.remove_all(removed), 334);
+        equals(set.size(), 666);
+
+        for(uint16_t i = 0; i < 1000; ++i) {
+            equals(set.contains(i), i % 3 != 0);
+        }
+    });
+
+    suite.add_test("clear", [] () {
+        counting_test_allocator allocator;
+        test_set<uint32_t> set{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        for(uint32_t i = 0; i < 10000; ++i) {
+            set.insert(i);
+        }
+
+        const auto allocation_count = allocator.get_bytes_allocated_count();
+
+        set.clear();
+
+        equals(set.size(), 0);
+        check(!set.contains(0));
+        check(!set.contains(9999));
+        equals(allocator.get_bytes_allocated_count(), allocation_count);
+
+        set.insert(5);
+
+        check(set.contains(5));
+        equals(set.index_of(5), 0);
+
+        set.destroy();
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+        check(!set.contains(5));
+    });
+
+    suite.add_test("ctor (range)", [] () {
+        std::vector<uint32_t> input;
+
+        for(uint32_t i = 0; i < 1000; ++i) {
+            input.push_back(i * 3);
+            input.push_back(i * 3);
+        }
+
+        const test_set<uint32_t> set{input};
+
+        equals(set.size(), 1000);
+
+        for(uint32_t i = 0; i < 1000; ++i) {
+            check(set.contains(i * 3));
+            equals(set.data()[i], i * 3);
+        }
+    });
+
+    suite.add_test("copy", [] () {
+        test_set<uint32_t> set;
+
+        set.insert(1);
+        set.insert(100000);
+
+        test_set<uint32_t> copy{set};
+        test_set<uint32_t> assigned;
+
+        assigned.insert(2);
+        assigned = set;
+        copy.remove(1);
+
+        check(set.contains(1));
+        check(!copy.contains(1));
+        check(copy.contains(100000));
+        check(assigned.contains(1));
+        check(assigned.contains(100000));
+        check(!assigned.contains(2));
+    });
+
+    suite.add_test("move", [] () {
+        test_set<uint32_t> set;
+
+        set.insert(1);
+        set.insert(100000);
+
+        test_set<uint32_t> moved{std::move(set)};
+        test_set<uint32_t> assigned;
+
+        check(moved.contains(100000));
+
+        assigned.insert(2);
+        assigned = std::move(moved);
+
+        check(assigned.contains(1));
+        check(assigned.contains(100000));
+        check(!assigned.contains(2));
+    });
+
+    suite.add_test("move (different allocators)", [] () {
+        counting_test_allocator source_allocator;
+        counting_test_allocator target_allocator;
+
+        {
+            test_set<uint32_t> set{CCL_ALLOCATOR_DEFAULT_FLAGS, &source_allocator};
+            test_set<uint32_t> assigned{CCL_ALLOCATOR_DEFAULT_FLAGS, &target_allocator};
+
+            set.insert(1);
+            set.insert(100000);
+            assigned.insert(2);
+            assigned.insert(200000);
+
+            assigned = std::move(set);
+
+            // The previous pages went back to the allocator that made them
+            equals(target_allocator.get_bytes_allocated_count(), 0);
+            equals(assigned.get_allocator(), &source_allocator);
+            equals(set.size(), 0);
+            check(!set.contains(1));
+            check(assigned.contains(1));
+            check(assigned.contains(100000));
+            check(!assigned.contains(2));
+
+            test_set<uint32_t> &self = assigned;
+            assigned = std::move(self);
+
+            check(assigned.contains(1));
+            equals(assigned.size(), 2);
+        }
+
+        equals(source_allocator.get_bytes_allocated_count(), 0);
+    });
+
+    return suite.main(argc, argv);
+}
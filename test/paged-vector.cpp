@@ -768,6 +768,25 @@ int main(int argc, char **argv) {
         check(v.begin() == v.end());
     });
 
+    suite.add_test("erase (destroyed items)", [] () {
+        int destruction_counter = 0;
+        test_ring<spy> v;
+
+        v.resize(3);
+
+        for(auto &x : v) {
+            x.on_destroy = [&destruction_counter] () { destruction_counter++; };
+        }
+
+        // Only the item left past the end after moving is destroyed
+        v.erase(v.begin(), v.begin() + 1);
+
+        equals(destruction_counter, 1);
+        check(v.size() == 2);
+        check(v[0].construction_magic == constructed_value);
+        check(v[1].construction_magic == constructed_value);
+    });
+
     suite.add_test("erase (invalid iterators)", [] () {
         test_ring<int> v { 1, 2, 3 };
 
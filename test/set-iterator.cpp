@@ -250,6 +250,35 @@ int main(int argc, char **argv) {
         check(s.end() > it3);
     });
 
+    suite.add_test("traversal (sparse)", [] () {
+        test_set t;
+        int count = 0;
+
+        for(int i = 0; i < 1000; ++i) {
+            t.insert(i);
+        }
+
+        for(int i = 0; i < 1000; ++i) {
+            if(i % 100) {
+                t.erase(i);
+            }
+        }
+
+        for(auto it = t.begin(); it != t.end(); ++it) {
+            equals(*it % 100, 0);
+            count++;
+        }
+
+        equals(count, 10);
+
+        for(auto it = t.end(); it != t.begin(); count--) {
+            --it;
+            equals(*it % 100, 0);
+        }
+
+        equals(count, 0);
+    });
+
     suite.add_test("operator >=", [] () {
         test_set s;
 
@@ -1,16 +1,64 @@
+#include <vector>
 #include <ccl/test/test.hpp>
 #include <ccl/test/counting-test-allocator.hpp>
 #include <ccl/set.hpp>
 #include <ccl/util.hpp>
+#include <ccl/string/ansi-string.hpp>
 
 using namespace ccl;
 
 template<typename K, typename H = hash<K>>
 using test_set = set<K, H, counting_test_allocator>;
 
+struct generational_policy : default_set_policy {
+    static constexpr bool generational_clear = true;
+};
+
+template<typename K, typename H = hash<K>>
+using generational_set = set<K, H, counting_test_allocator, generational_policy>;
+
+struct shrinking_policy : default_set_policy {
+    static constexpr float shrink_load_factor = 0.125f;
+};
+
+template<typename K, typename H = hash<K>>
+using shrinking_set = set<K, H, counting_test_allocator, shrinking_policy>;
+
+struct small_policy : default_set_policy {
+    static constexpr count_t minimum_capacity = 32;
+    static constexpr count_t chunk_size = 8;
+    static constexpr float max_load_factor = 0.5f;
+    static constexpr count_t growth_factor = 4;
+};
+
+template<typename K, typename H = hash<K>>
+using small_set = set<K, H, counting_test_allocator, small_policy>;
+
 int main(int argc, char **argv) {
     test_suite suite;
 
+    suite.add_test("ctor (empty)", []() {
+        counting_test_allocator allocator;
+        test_set<int> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+        equals(x.capacity(), 0);
+        check(!x.contains(1));
+        check(x.find(1) == x.end());
+        check(x.begin() == x.end());
+
+        x.erase(1);
+        x.clear();
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+
+        x.insert(1);
+
+        check(x.contains(1));
+        equals(x.capacity(), test_set<int>::minimum_capacity);
+        differs(allocator.get_bytes_allocated_count(), 0);
+    });
+
     suite.add_test("insert one", []() {
         using my_set = test_set<int>;
 
@@ -234,6 +282,64 @@ int main(int argc, char **argv) {
         check(x.begin() == x.end());
     });
 
+    suite.add_test("clear (generational)", [] () {
+        generational_set<int> x;
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(i);
+        }
+
+        const auto capacity = x.capacity();
+
+        x.clear();
+
+        equals(x.capacity(), capacity);
+        check(x.begin() == x.end());
+        check(!x.contains(0));
+        check(!x.contains(999));
+
+        for(int i = 500; i < 1500; ++i) {
+            x.insert(i);
+        }
+
+        equals(x.capacity(), capacity);
+        check(!x.contains(0));
+
+        int count = 0;
+        int sum = 0;
+
+        for(const int key : x) {
+            count += 1;
+            sum += key;
+        }
+
+        equals(count, 1000);
+        equals(sum, 999500);
+        check(x.find(1499) != x.end());
+        check(std::prev(x.end()) != x.end());
+    });
+
+    suite.add_test("clear (generational, wrap around)", [] () {
+        generational_set<int> x;
+
+        for(int round = 0; round < 600; ++round) {
+            for(int i = 0; i < 8; ++i) {
+                x.insert(round + i);
+            }
+
+            x.erase(round + 7);
+
+            check(x.contains(round));
+            check(!x.contains(round - 1));
+            check(!x.contains(round + 7));
+            equals(std::distance(x.begin(), x.end()), 7);
+
+            x.clear();
+
+            check(!x.contains(round));
+        }
+    });
+
     suite.add_test("find (not present)", []() {
         using my_set = test_set<int>;
 
@@ -285,11 +391,482 @@ int main(int argc, char **argv) {
 
         my_set x;
 
+        x.reserve(test_set<int>::minimum_capacity);
+
         const auto old_capacity = x.capacity();
         x.reserve(test_set<int>::minimum_capacity - 1);
 
         equals(x.capacity(), old_capacity);
     });
 
+    suite.add_test("reserve (single block)", []() {
+        counting_test_allocator allocator;
+        test_set<int> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(i);
+        }
+
+        equals(allocator.get_bytes_allocated_count(), 1);
+    });
+
+    suite.add_test("reserve (crowded chunk)", []() {
+        // Keys share a chunk at the minimum capacity and at twice as much.
+        struct crowding_hash {
+            constexpr hash_t operator()(const int &x) const {
+                return static_cast<hash_t>(x & 1) * test_set<int>::minimum_capacity * 2;
+            }
+        };
+
+        test_set<int, crowding_hash> x;
+
+        for(int i = 0; i <= CCL_SET_KEY_CHUNK_SIZE; ++i) {
+            x.insert(i);
+        }
+
+        equals(x.capacity(), test_set<int>::minimum_capacity * 4);
+
+        for(int i = 0; i <= CCL_SET_KEY_CHUNK_SIZE; ++i) {
+            check(x.contains(i));
+        }
+    });
+
+    suite.add_test("find/contains (transparent)", []() {
+        test_set<ansi_string<>, string_hash<>> x;
+        const char * const raw = "key 1 and more";
+
+        x.insert(ansi_string<>{"key 0"});
+        x.insert(ansi_string<>{"key 1"});
+
+        const auto it = x.find(std::string_view{raw, 5});
+
+        check(it != x.end());
+        check(*it == "key 1");
+        check(x.find(std::string_view{"key 2"}) == x.end());
+        check(x.contains("key 0"));
+        check(!x.contains(std::string_view{raw}));
+    });
+
+    suite.add_test("insert_batch", []() {
+        test_set<int> x;
+        int keys[100];
+
+        for(int i = 0; i < 100; ++i) {
+            keys[i] = i * 7919;
+        }
+
+        x.insert(0);
+        x.insert_batch(keys);
+
+        for(int i = 0; i < 100; ++i) {
+            check(x.contains(i * 7919));
+        }
+    });
+
+    suite.add_test("find_batch/contains_batch", []() {
+        using my_set = test_set<int>;
+
+        my_set x;
+        int keys[100];
+        my_set::iterator found[100];
+        bool present[100];
+
+        for(int i = 0; i < 100; ++i) {
+            keys[i] = i;
+
+            if(i % 3 == 0) {
+                x.insert(i);
+            }
+        }
+
+        x.find_batch(keys, found);
+        x.contains_batch(keys, present);
+
+        for(int i = 0; i < 100; ++i) {
+            equals(present[i], i % 3 == 0);
+
+            if(i % 3 == 0) {
+                equals(*found[i], i);
+            } else {
+                check(found[i] == x.end());
+            }
+        }
+    });
+
+    suite.add_test("extract/insert (node)", []() {
+        using my_set = test_set<ansi_string<>, string_hash<>>;
+
+        my_set x;
+        my_set y;
+
+        x.insert(ansi_string<>{"key 0"});
+        x.insert(ansi_string<>{"key 1"});
+        y.insert(ansi_string<>{"key 1"});
+
+        my_set::node_type node = x.extract("key 0");
+
+        check(!node.empty());
+        check(node.key() == "key 0");
+        check(!x.contains("key 0"));
+        check(x.extract("key 0").empty());
+
+        check(y.insert(std::move(node)));
+        check(node.empty());
+        check(y.contains("key 0"));
+
+        // Already present: the node keeps its key
+        node = x.extract("key 1");
+
+        check(!y.insert(std::move(node)));
+        check(node.key() == "key 1");
+        check(!y.insert(my_set::node_type{}));
+    });
+
+    suite.add_test("merge", []() {
+        test_set<int> x;
+        test_set<int> y;
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(i);
+            y.insert(i + 500);
+        }
+
+        x.merge(y);
+
+        for(int i = 0; i < 1500; ++i) {
+            check(x.contains(i));
+        }
+
+        // Keys already present stay behind
+        for(int i = 500; i < 1500; ++i) {
+            equals(y.contains(i), i < 1000);
+        }
+
+        x.merge(x);
+        check(x.contains(0));
+    });
+
+    suite.add_test("insert move (allocations)", [] () {
+        using string_type = ansi_string<counting_test_allocator>;
+
+        counting_test_allocator string_allocator;
+        test_set<string_type, string_hash<>> x;
+
+        x.insert(string_type{"key 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator});
+
+        // Moved: no string copied
+        equals(string_allocator.get_bytes_allocated_count(), 1);
+
+        const string_type key{"key 1", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        x.insert(key);
+
+        equals(string_allocator.get_bytes_allocated_count(), 3);
+
+        x.insert(key);
+
+        equals(string_allocator.get_bytes_allocated_count(), 3);
+        check(x.contains(key));
+    });
+
+    suite.add_test("size", [] () {
+        test_set<int> x;
+        test_set<int> y;
+
+        equals(x.size(), 0);
+        check(x.is_empty());
+
+        for(int i = 0; i < 1000; ++i) {
+            x.insert(i);
+            x.insert(i);
+        }
+
+        equals(x.size(), 1000);
+
+        x.erase(0);
+        CCLUNUSED auto node = x.extract(1);
+        y.insert(2);
+        y.insert(-1);
+        x.merge(y);
+
+        equals(x.size(), 999);
+        equals(y.size(), 1);
+
+        y = std::move(x);
+
+        equals(y.size(), 999);
+        equals(x.size(), 0);
+
+        y.clear();
+
+        equals(y.size(), 0);
+        check(y.is_empty());
+    });
+
+    suite.add_test("shrink_to_fit", [] () {
+        counting_test_allocator allocator;
+        test_set<int> x{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        for(int i = 0; i < 10000; ++i) {
+            x.insert(i);
+        }
+
+        const auto capacity = x.capacity();
+
+        for(int i = 10; i < 10000; ++i) {
+            x.erase(i);
+        }
+
+        // Erasing never shrinks by default
+        equals(x.capacity(), capacity);
+
+        x.shrink_to_fit();
+
+        equals(x.capacity(), test_set<int>::minimum_capacity);
+        equals(x.size(), 10);
+        equals(allocator.get_bytes_allocated_count(), 1);
+
+        for(int i = 0; i < 10; ++i) {
+            check(x.contains(i));
+        }
+
+        for(int i = 0; i < 10; ++i) {
+            x.erase(i);
+        }
+
+        x.shrink_to_fit();
+
+        equals(x.capacity(), 0);
+        equals(allocator.get_bytes_allocated_count(), 0);
+
+        x.insert(1);
+
+        check(x.contains(1));
+    });
+
+    suite.add_test("erase (shrink policy)", [] () {
+        shrinking_set<int> x;
+
+        for(int i = 0; i < 10000; ++i) {
+            x.insert(i);
+        }
+
+        const auto capacity = x.capacity();
+
+        for(int i = 10; i < 10000; ++i) {
+            x.erase(i);
+        }
+
+        check(x.capacity() < capacity);
+        equals(x.size(), 10);
+
+        for(int i = 0; i < 10; ++i) {
+            check(x.contains(i));
+        }
+
+        // Never below the minimum capacity
+        for(int i = 0; i < 10; ++i) {
+            CCLUNUSED auto node = x.extract(i);
+        }
+
+        equals(x.capacity(), shrinking_set<int>::minimum_capacity);
+    });
+
+    suite.add_test("erase (shrink policy, strided keys)", [] () {
+        shrinking_set<uint32_t> x;
+
+        // Keys sharing their low bits cluster at every smaller capacity
+        for(uint32_t i = 0; i < 4096; ++i) {
+            x.insert(i * 4096);
+        }
+
+        const auto capacity = x.capacity();
+
+        for(uint32_t i = 10; i < 4096; ++i) {
+            x.erase(i * 4096);
+        }
+
+        check(x.capacity() <= capacity);
+        equals(x.size(), 10);
+
+        for(uint32_t i = 0; i < 10; ++i) {
+            check(x.contains(i * 4096));
+        }
+    });
+
+    suite.add_test("policy (capacity and growth)", [] () {
+        small_set<int> x;
+
+        x.insert(0);
+
+        equals(x.capacity(), 32);
+
+        for(int i = 1; i < 16; ++i) {
+            x.insert(i);
+        }
+
+        // Growing by the growth factor past the maximum load factor
+        equals(x.capacity(), 32);
+
+        x.insert(16);
+
+        equals(x.capacity(), 128);
+
+        for(int i = 0; i <= 16; ++i) {
+            check(x.contains(i));
+        }
+
+        for(int i = 2; i <= 16; ++i) {
+            x.erase(i);
+        }
+
+        x.shrink_to_fit();
+
+        equals(x.capacity(), 32);
+        equals(x.size(), 2);
+    });
+
+    suite.add_test("policy (chunk size)", [] () {
+        // Keys share a chunk at the minimum capacity
+        struct crowding_hash {
+            constexpr hash_t operator()(const int &x) const {
+                return static_cast<hash_t>(x) * small_policy::minimum_capacity;
+            }
+        };
+
+        set<int, crowding_hash, counting_test_allocator, small_policy> x;
+
+        for(int i = 0; i < 8; ++i) {
+            x.insert(i);
+        }
+
+        equals(x.capacity(), 32);
+
+        // Overflowing the chunk
+        x.insert(8);
+
+        equals(x.capacity(), 128);
+
+        for(int i = 0; i <= 8; ++i) {
+            check(x.contains(i));
+        }
+    });
+
+    suite.add_test("ctor (sized range)", [] () {
+        counting_test_allocator allocator;
+        std::vector<int> input;
+
+        for(int i = 0; i < 10000; ++i) {
+            input.push_back(i);
+            input.push_back(i);
+        }
+
+        const test_set<int> x{input, CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        equals(x.size(), 10000);
+        equals(allocator.get_bytes_allocated_count(), 1);
+
+        for(int i = 0; i < 10000; ++i) {
+            check(x.contains(i));
+        }
+
+        const test_set<int> empty{std::vector<int>{}, CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        equals(empty.capacity(), 0);
+    });
+
+    suite.add_test("set_union", [] () {
+        test_set<int> a;
+        test_set<int> b;
+
+        for(int i = 0; i < 1000; ++i) {
+            a.insert(i);
+            b.insert(i + 500);
+        }
+
+        const test_set<int> result = set_union(a, b);
+
+        equals(result.size(), 1500);
+
+        for(int i = 0; i < 1500; ++i) {
+            check(result.contains(i));
+        }
+
+        equals(set_union(a, test_set<int>{}).size(), 1000);
+    });
+
+    suite.add_test("set_intersection", [] () {
+        counting_test_allocator allocator;
+        test_set<int> a{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+        test_set<int> b;
+
+        for(int i = 0; i < 1000; ++i) {
+            a.insert(i * 2);
+        }
+
+        for(int i = 0; i < 100; ++i) {
+            b.insert(i * 3);
+        }
+
+        const test_set<int> result = set_intersection(a, b);
+
+        equals(result.size(), 50);
+        equals(result.get_allocator(), &allocator);
+
+        for(int i = 0; i < 300; ++i) {
+            equals(result.contains(i), i % 6 == 0);
+        }
+
+        check(set_intersection(b, a).size() == 50);
+        equals(set_intersection(a, test_set<int>{}).size(), 0);
+    });
+
+    suite.add_test("set_difference", [] () {
+        test_set<int> a;
+        test_set<int> b;
+
+        for(int i = 0; i < 1000; ++i) {
+            a.insert(i);
+        }
+
+        for(int i = 0; i < 2000; i += 2) {
+            b.insert(i);
+        }
+
+        const test_set<int> result = set_difference(a, b);
+
+        equals(result.size(), 500);
+
+        for(int i = 0; i < 1000; ++i) {
+            equals(result.contains(i), i % 2 == 1);
+        }
+
+        equals(set_difference(b, a).size(), 500);
+        equals(set_difference(a, a).size(), 0);
+    });
+
+    suite.add_test("is_subset", [] () {
+        test_set<int> a;
+        test_set<int> b;
+
+        check(is_subset(a, b));
+
+        for(int i = 0; i < 1000; ++i) {
+            b.insert(i);
+
+            if(i % 3 == 0) {
+                a.insert(i);
+            }
+        }
+
+        check(is_subset(a, b));
+        check(!is_subset(b, a));
+        check(is_subset(b, b));
+
+        a.insert(1000);
+
+        check(!is_subset(a, b));
+    });
+
     return suite.main(argc, argv);
 }
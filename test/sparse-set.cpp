@@ -1,5 +1,7 @@
+#include <vector>
 #include <ccl/test/test.hpp>
 #include <ccl/sparse-set.hpp>
+#include <ccl/string/ansi-string.hpp>
 #include <ccl/test/counting-test-allocator.hpp>
 
 using namespace ccl;
@@ -27,6 +29,20 @@ constexpr bool operator !=(const S& first, const S& second) {
 int main(int argc, char **argv) {
     test_suite suite;
 
+    suite.add_test("ctor (empty)", [] () {
+        counting_test_allocator allocator;
+        test_set<int> set{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        equals(allocator.get_bytes_allocated_count(), 0);
+        check(!set.contains(1));
+        check(set.begin() == set.end());
+
+        set.insert(1);
+
+        check(set.contains(1));
+        differs(allocator.get_bytes_allocated_count(), 0);
+    });
+
     suite.add_test("insert ref", [] () {
         test_set<S> set;
 
@@ -48,9 +64,72 @@ int main(int argc, char **argv) {
         set.insert({ 3, 3.0 });
         set.insert({ 3, 3.0 });
 
-        set.remove(s2);
+        check(set.remove(s2));
+        check(!set.remove(s2));
 
         check(set.size() == 2);
+        check(!set.contains(s2));
+        check(set.contains({ 1, 2.0 }));
+        check(set.contains({ 3, 3.0 }));
+    });
+
+    suite.add_test("remove (dense storage)", [] () {
+        test_set<int> set;
+
+        for(int i = 0; i < 100; ++i) {
+            set.insert(i);
+        }
+
+        // Removing from the middle moves the last item in the gap
+        set.remove(10);
+
+        equals(set.size(), 99);
+        equals(set.data()[10], 99);
+
+        for(int i = 0; i < 100; i += 2) {
+            set.remove(i);
+        }
+
+        equals(set.size(), 50);
+
+        for(int i = 0; i < 100; ++i) {
+            equals(set.contains(i), i % 2 == 1);
+        }
+
+        for(const int x : set) {
+            check(x % 2 == 1);
+        }
+
+        // Indices still match the dense storage
+        for(int i = 1; i < 100; i += 2) {
+            set.remove(i);
+            check(!set.contains(i));
+        }
+
+        equals(set.size(), 0);
+        check(set.begin() == set.end());
+    });
+
+    suite.add_test("remove_all", [] () {
+        test_set<int> set;
+        std::vector<int> removed;
+
+        for(int i = 0; i < 1000; ++i) {
+            set.insert(i);
+        }
+
+        for(int i = 0; i < 2000; i += 3) {
+            removed.push_back(i);
+        }
+
+        equals(set.remove_all(removed), 334);
+        equals(set.size(), 666);
+
+        for(int i = 0; i < 1000; ++i) {
+            equals(set.contains(i), i % 3 != 0);
+        }
+
+        equals(set.remove_all(removed), 0);
     });
 
     suite.add_test("contains", [] () {
@@ -82,5 +161,193 @@ int main(int argc, char **argv) {
         check(size == 3);
     });
 
+    suite.add_test("insert (move)", [] () {
+        using string_type = ansi_string<counting_test_allocator>;
+
+        counting_test_allocator string_allocator;
+        sparse_set<string_type, string_hash<>, counting_test_allocator> set;
+
+        set.insert(string_type{"item 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator});
+
+        // One copy for the index, the item itself moved
+        equals(string_allocator.get_bytes_allocated_count(), 2);
+
+        const string_type item{"item 1", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator};
+
+        set.insert(item);
+
+        equals(string_allocator.get_bytes_allocated_count(), 5);
+
+        // Already present: nothing copied
+        set.insert(item);
+        set.insert(string_type{"item 0", CCL_ALLOCATOR_DEFAULT_FLAGS, &string_allocator});
+
+        equals(string_allocator.get_bytes_allocated_count(), 5);
+        equals(set.size(), 2);
+        check(set.contains(item));
+    });
+
+    suite.add_test("ctor (range)", [] () {
+        std::vector<int> input;
+
+        for(int i = 0; i < 1000; ++i) {
+            input.push_back(i);
+            input.push_back(i);
+        }
+
+        const test_set<int> set{input};
+
+        equals(set.size(), 1000);
+
+        for(int i = 0; i < 1000; ++i) {
+            check(set.contains(i));
+            equals(set.data()[i], i);
+        }
+    });
+
+    suite.add_test("reserve", [] () {
+        counting_test_allocator allocator;
+        test_set<int> set{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+
+        set.reserve(10000);
+
+        const auto allocation_count = allocator.get_bytes_allocated_count();
+
+        for(int i = 0; i < 10000; ++i) {
+            set.insert(i);
+        }
+
+        equals(allocator.get_bytes_allocated_count(), allocation_count);
+        equals(set.size(), 10000);
+    });
+
+    suite.add_test("set_union", [] () {
+        test_set<int> a;
+        test_set<int> b;
+
+        for(int i = 0; i < 1000; ++i) {
+            a.insert(i);
+        }
+
+        for(int i = 0; i < 100; ++i) {
+            b.insert(i * 20);
+        }
+
+        const test_set<int> result = set_union(a, b);
+
+        equals(result.size(), 1050);
+
+        // The larger set comes first, in its dense order
+        for(int i = 0; i < 1000; ++i) {
+            equals(result.data()[i], i);
+        }
+
+        for(int i = 0; i < 2000; ++i) {
+            equals(result.contains(i), i < 1000 || i % 20 == 0);
+        }
+    });
+
+    suite.add_test("set_intersection", [] () {
+        counting_test_allocator allocator;
+        test_set<int> a{CCL_ALLOCATOR_DEFAULT_FLAGS, &allocator};
+        test_set<int> b;
+
+        // Unsorted dense storage
+        for(int i = 999; i >= 0; --i) {
+            a.insert(i * 2);
+        }
+
+        for(int i = 0; i < 100; ++i) {
+            b.insert(i * 3);
+        }
+
+        const test_set<int> result = set_intersection(a, b);
+
+        equals(result.size(), 50);
+        equals(result.get_allocator(), &allocator);
+
+        // In the dense order of the smaller set
+        for(int i = 0; i < 50; ++i) {
+            equals(result.data()[i], i * 6);
+        }
+
+        for(int i = 0; i < 300; ++i) {
+            equals(result.contains(i), i % 6 == 0);
+        }
+
+        equals(set_intersection(a, test_set<int>{}).size(), 0);
+    });
+
+    suite.add_test("set_intersection (sorted)", [] () {
+        test_set<uint32_t> a;
+        test_set<uint32_t> b;
+
+        for(uint32_t i = 0; i < 10000; ++i) {
+            a.insert(i * 2);
+            b.insert(i * 3 + 1);
+        }
+
+        const test_set<uint32_t> result = set_intersection(a, b);
+
+        equals(result.size(), 3333);
+
+        for(uint32_t i = 0; i < result.size(); ++i) {
+            equals(result.data()[i], i * 6 + 4);
+            check(result.contains(i * 6 + 4));
+        }
+    });
+
+    suite.add_test("set_difference", [] () {
+        test_set<int> a;
+        test_set<int> b;
+
+        for(int i = 0; i < 1000; ++i) {
+            a.insert(i);
+        }
+
+        for(int i = 1998; i >= 0; i -= 2) {
+            b.insert(i);
+        }
+
+        const test_set<int> result = set_difference(a, b);
+
+        equals(result.size(), 500);
+
+        for(int i = 0; i < 500; ++i) {
+            equals(result.data()[i], i * 2 + 1);
+        }
+
+        equals(set_difference(b, a).size(), 500);
+        equals(set_difference(a, a).size(), 0);
+    });
+
+    suite.add_test("is_subset", [] () {
+        test_set<int> a;
+        test_set<int> b;
+
+        check(is_subset(a, b));
+
+        for(int i = 0; i < 1000; ++i) {
+            b.insert(i);
+
+            if(i % 3 == 0) {
+                a.insert(i);
+            }
+        }
+
+        check(is_subset(a, b));
+        check(!is_subset(b, a));
+        check(is_subset(b, b));
+
+        a.insert(1000);
+
+        check(!is_subset(a, b));
+
+        a.remove(1000);
+        b.remove(0);
+
+        check(!is_subset(a, b));
+    });
+
     return suite.main(argc, argv);
 }
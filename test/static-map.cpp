@@ -0,0 +1,87 @@
+#include <string_view>
+#include <ccl/test/test.hpp>
+#include <ccl/static-map.hpp>
+
+using namespace ccl;
+
+using namespace std::string_view_literals;
+
+static constexpr auto opcodes = make_static_map<std::string_view, int, string_hash<>>({
+    { "nop"sv, 0 },
+    { "load"sv, 1 },
+    { "store"sv, 2 },
+    { "add"sv, 3 },
+    { "sub"sv, 4 },
+    { "jump"sv, 5 },
+    { "call"sv, 6 },
+    { "ret"sv, 7 }
+});
+
+static_assert(opcodes.at("store") == 2);
+static_assert(!opcodes.contains("halt"));
+
+template<std::size_t ...I>
+static constexpr auto make_squares(std::index_sequence<I...>) {
+    const pair<int, int> items[] = { pair<int, int>{static_cast<int>(I) * 7, static_cast<int>(I * I)}... };
+
+    return make_static_map<int, int>(items);
+}
+
+int main(int argc, char **argv) {
+    test_suite suite;
+
+    suite.add_test("find", [] () {
+        equals(opcodes.size(), 8);
+        equals(*opcodes.find("nop"), 0);
+        equals(*opcodes.find("ret"), 7);
+        equals(opcodes.at("call"), 6);
+        equals(opcodes.find("halt"), nullptr);
+        equals(opcodes.find(""), nullptr);
+        check(opcodes.contains("jump"));
+        check(!opcodes.contains("jum"));
+
+        throws<std::out_of_range>([] () {
+            CCLUNUSED auto x = opcodes.at("halt");
+        });
+    });
+
+    suite.add_test("find (one key)", [] () {
+        constexpr auto map = make_static_map<int, int>({ { 42, 1 } });
+
+        equals(map.at(42), 1);
+        check(!map.contains(0));
+    });
+
+    suite.add_test("find (many keys)", [] () {
+        static constexpr auto squares = make_squares(std::make_index_sequence<1000>{});
+
+        for(int i = 0; i < 1000; ++i) {
+            equals(squares.at(i * 7), i * i);
+            equals(squares.contains(i * 7 + 1), false);
+        }
+    });
+
+    suite.add_test("iteration", [] () {
+        int sum = 0;
+        int count = 0;
+
+        for(const auto &item : opcodes) {
+            sum += item.second;
+            count++;
+        }
+
+        equals(count, 8);
+        equals(sum, 28);
+        check(opcodes.begin()->first == "nop");
+    });
+
+    suite.add_test("duplicate keys", [] () {
+        throws<std::invalid_argument>([] () {
+            const pair<int, int> items[] = { { 1, 1 }, { 2, 2 }, { 1, 3 } };
+
+            CCLUNUSED static_map<int, int, 3> map{items};
+        });
+    });
+
+    return suite.main(argc, argv);
+}